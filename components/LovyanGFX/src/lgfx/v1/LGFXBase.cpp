@@ -31,7 +31,6 @@ Contributors:
 #include <stdarg.h>
 #include <stdint.h>
 #include <math.h>
-#include <list>
 
 #ifdef min
 #undef min
@@ -47,6 +46,7 @@ namespace lgfx
 //----------------------------------------------------------------------------
   static constexpr const float deg_to_rad = 0.017453292519943295769236907684886;
   static constexpr const uint8_t FP_SCALE = 16;
+  static constexpr const int32_t AFFINE_TILE_MAX = 64;
   static constexpr const uint8_t LGFX_ALPHABLEND_NONREADABLE_THRESH = 128;
 
   void LGFXBase::setColorDepth(color_depth_t depth)
@@ -982,6 +982,48 @@ namespace lgfx
     endWrite();
   }
 
+  // Blends per-pixel colours at per-pixel coverage; one panel read-modify-write per span.
+  struct effect_alpha_span
+  {
+    effect_alpha_span(int32_t x, const uint8_t* alpha, const rgb888_t* colors, rgb888_t color)
+      : _x { x }, _alpha { alpha }, _colors { colors }, _color { color }
+    {}
+    template <typename TDstColor>
+    void operator() (int32_t x, int32_t y, TDstColor& dst)
+    {
+      (void)y;
+      int32_t i = x - _x;
+      const rgb888_t& c = _colors ? _colors[i] : _color;
+      uint_fast16_t a8 = 1 + _alpha[i];
+      uint_fast16_t inv = 257 - a8;
+      dst.set((c.r * a8 + dst.R8() * inv) >> 8
+             ,(c.g * a8 + dst.G8() * inv) >> 8
+             ,(c.b * a8 + dst.B8() * inv) >> 8
+             );
+    }
+  private:
+    int32_t _x;
+    const uint8_t* _alpha;
+    const rgb888_t* _colors;
+    rgb888_t _color;
+  };
+
+  void LGFXBase::blend_alpha_span(int32_t x, int32_t y, int32_t w, const uint8_t* alpha, const rgb888_t* colors, rgb888_t color)
+  {
+    if (y < _clip_t || y > _clip_b) return;
+    if (x < _clip_l)
+    {
+      int32_t skip = _clip_l - x;
+      x += skip;
+      w -= skip;
+      alpha += skip;
+      if (colors) colors += skip;
+    }
+    if (w > _clip_r - x + 1) w = _clip_r - x + 1;
+    if (w <= 0) return;
+    _panel->effect(x, y, w, 1, effect_alpha_span(x, alpha, colors, color));
+  }
+
   void LGFXBase::draw_gradient_wedgeline(float ax, float ay, float bx, float by, float ar, float br, const colors_t gradient )
   {
     const bool is_circle = (ax==bx && ay==by /*&& ar==br*/ );
@@ -995,75 +1037,172 @@ namespace lgfx
     int32_t x1 = (int32_t) ceilf(fmaxf(ax+ar, bx+br));
     int32_t y0 = (int32_t)floorf(fminf(ay-ar, by-br));
     int32_t y1 = (int32_t) ceilf(fmaxf(ay+ar, by+br));
-    // clamp coords to drawable area
-    if (!clampArea(&x0, &y0, &x1, &y1)) {
-      return;
-    }
+    // clamp coords to the clip rect
+    if (x0 < _clip_l) x0 = _clip_l;
+    if (y0 < _clip_t) y0 = _clip_t;
+    if (x1 > _clip_r) x1 = _clip_r;
+    if (y1 > _clip_b) y1 = _clip_b;
+    if (x0 > x1 || y0 > y1) return;
 
     constexpr float PixelAlphaGain = 255.0f;
-
-    setClipRect( x0, y0, x1, y1 );
-    startWrite();
-
-    // Establish x start and y start
-    int32_t ys = ay;
-    if ((ax-ar)>(bx-br)) ys = by;
+    constexpr int32_t SpanChunk = 64;
+    const bool use_gradient = gradient.count > 1;
 
     float rdt = ar - br; // Radius delta
-    float alpha = 1.0f; // base alpha
     ar += 0.5f; // center pixel
     // line distance including rounded edges
     float linedist = is_circle? (ar + br)*.5f : pixelDistance(ax, ay, bx, by) + ar + br;
-    float xpax, ypay, bax = bx - ax, bay = by - ay;
-
-    int32_t xs = x0; // Set x start to left side of box
-    // 1st pass: Scan bounding box from ys down, calculate pixel intensity from distance to line
-    for (int32_t yp = ys; yp <= y1; yp++) {
-      bool endX = false; // Flag to skip pixels
-      ypay = yp - ay;
-      for (int32_t xp = xs; xp <= x1; xp++) {
-        if (endX) if (alpha <= LoAlphaTheshold) break;  // Skip right side
-        xpax = xp - ax;
-        alpha = ar - wedgeLineDistance(xpax, ypay, bax, bay, rdt);
-        if (alpha <= LoAlphaTheshold ) continue;
-        // handle gradient
-        if( gradient.count>1 ) fg_color = map_gradient( pixelDistance(ax, ay, xp, yp), 0.0f, linedist, gradient );
-        // Track edge to minimise calculations
-        if (!endX) { endX = true; xs = xp; }
-        if (alpha > HiAlphaTheshold) {
-          setColor(color888(fg_color.r, fg_color.g, fg_color.b));
-          drawPixel(xp, yp);
-          continue;
+    float bax = bx - ax, bay = by - ay;
+
+    // Each scanline is [edge][solid interior][edge]. The interior is one
+    // fill; the edges are blended with one read-modify-write each, or the
+    // whole row at once when the interior is too short to be worth a fill.
+    constexpr int32_t MinSolidFill = 8;
+    uint8_t alphas[SpanChunk];
+    rgb888_t colors[SpanChunk];
+    float ypay;
+    auto coverage = [&](int32_t xp) { return ar - wedgeLineDistance(xp - ax, ypay, bax, bay, rdt); };
+    auto color_at = [&](int32_t xp, int32_t yp) { return map_gradient( pixelDistance(ax, ay, xp, yp), 0.0f, linedist, gradient ); };
+    // Blends [xs, xe]; pixels in [sl, sr] are known to be solid.
+    auto blend_run = [&](int32_t xs, int32_t xe, int32_t sl, int32_t sr, int32_t yp)
+    {
+      for (int32_t xc = xs; xc <= xe; xc += SpanChunk)
+      {
+        int32_t n = std::min(SpanChunk, xe - xc + 1);
+        for (int32_t i = 0; i < n; i++)
+        {
+          int32_t xp = xc + i;
+          if (xp >= sl && xp <= sr) { alphas[i] = 255; }
+          else
+          {
+            float a = coverage(xp);
+            alphas[i] = a <= LoAlphaTheshold ? 0 : a > HiAlphaTheshold ? 255 : (uint8_t)(a * PixelAlphaGain);
+          }
+          if (use_gradient) colors[i] = color_at(xp, yp);
         }
-        fillRectAlpha(xp, yp, 1, 1, (uint8_t)(alpha * PixelAlphaGain), fg_color);
+        blend_alpha_span(xc, yp, n, alphas, use_gradient ? colors : nullptr, fg_color);
       }
-    }
+    };
 
-    xs = x0; // Reset x start to left side of box
-    // 2nd pass: Scan bounding box from ys-1 up, calculate pixel intensity from distance to line
-    for (int32_t yp = ys-1; yp >= y0; yp--) {
-      bool endX = false; // Flag to skip pixels
+    // Row extents (relative to ax) of the region where coverage exceeds
+    // `ar - c`: the disc at a where the axis parameter is <= 0, the disc at b
+    // where it is >= 1, and the band between, whose half-width tapers from c to
+    // c - rdt. Each piece cuts the row in one run; overlapping runs are merged.
+    const float len2 = bax * bax + bay * bay;
+    const float seg_len = sqrtf(len2);
+    // The cuts are k * u + m <= 0 with k fixed for the line and the row's v
+    // folded into m; `inv` is -1 / k.
+    struct cut_t { float k, inv; };
+    auto make_cut = [](float k) { return cut_t { k, k != 0.0f ? -1.0f / k : 0.0f }; };
+    const float taper_v = rdt * bay / len2, perp_v = bax / seg_len;
+    const float taper_u = rdt * bax / len2, perp_u = bay / seg_len;
+    const cut_t axis_cut = make_cut(bax), back_cut = make_cut(-bax);
+    const cut_t left_cut = make_cut(taper_u - perp_u), right_cut = make_cut(taper_u + perp_u);
+    struct span_t { float a, b; };
+    auto row_spans = [&](float c, span_t* spans) -> int
+    {
+      // narrows [lo, hi] to the cut; pixels on a boundary are settled against
+      // their coverage below
+      auto below = [](const cut_t& cut, float m, float& lo, float& hi)
+      {
+        if (cut.k > 0.0f) { hi = std::min(hi, m * cut.inv); }
+        else if (cut.k < 0.0f) { lo = std::max(lo, m * cut.inv); }
+        else if (m > 0.0f) { hi = -INFINITY; }
+      };
+      int n = 0;
+      float v = ypay, lo, hi;
+      if (c > 0.0f && v * v < c * c)
+      {
+        float h = sqrtf(c * c - v * v);
+        lo = -h; hi = h;
+        below(axis_cut, v * bay, lo, hi);
+        if (lo <= hi) spans[n++] = { lo, hi };
+      }
+      float rb = c - rdt, vb = v - bay;
+      if (rb > 0.0f && vb * vb < rb * rb)
+      {
+        float h = sqrtf(rb * rb - vb * vb);
+        lo = bax - h; hi = bax + h;
+        below(back_cut, len2 - v * bay, lo, hi);
+        if (lo <= hi) spans[n++] = { lo, hi };
+      }
+      // |perpendicular distance| < c - rdt * d, for 0 < d < 1
+      lo = -INFINITY; hi = INFINITY;
+      below(back_cut, -v * bay, lo, hi);
+      below(axis_cut, v * bay - len2, lo, hi);
+      float ms = taper_v * v - c, mp = perp_v * v;
+      below(left_cut, ms + mp, lo, hi);
+      below(right_cut, ms - mp, lo, hi);
+      if (lo <= hi) spans[n++] = { lo, hi };
+
+      for (int i = 1; i < n; i++)
+      {
+        for (int j = i; j && spans[j].a < spans[j - 1].a; j--) std::swap(spans[j], spans[j - 1]);
+      }
+      int m = 0;
+      for (int i = 0; i < n; i++)
+      {
+        if (m && spans[i].a <= spans[m - 1].b) { spans[m - 1].b = std::max(spans[m - 1].b, spans[i].b); }
+        else { spans[m++] = spans[i]; }
+      }
+      return m;
+    };
+
+    if (!use_gradient) setColor(color888(fg_color.r, fg_color.g, fg_color.b));
+    startWrite();
+
+    for (int32_t yp = y0; yp <= y1; yp++)
+    {
       ypay = yp - ay;
-      for (int32_t xp = xs; xp <= x1; xp++) {
-        if (endX) if (alpha <= LoAlphaTheshold) break;  // Skip right side of drawn line
-        xpax = xp - ax;
-        alpha = ar - wedgeLineDistance(xpax, ypay, bax, bay, rdt);
-        if (alpha <= LoAlphaTheshold ) continue;
-        // handle gradient
-        if( gradient.count>1 ) fg_color = map_gradient( pixelDistance(ax, ay, xp, yp), 0.0f, linedist, gradient );
-        // Track line boundary
-        if (!endX) { endX = true; xs = xp; }
-        if (alpha > HiAlphaTheshold) {
-          setColor(color888(fg_color.r, fg_color.g, fg_color.b));
-          drawPixel(xp, yp);
-          continue;
+      span_t spans[3];
+      int n = row_spans(ar - LoAlphaTheshold, spans);
+      if (!n) continue;
+      // Pixel centres strictly inside the contour, widened where float rounding
+      // left a covered pixel outside it. Pixels in gaps between runs blend at
+      // zero coverage.
+      int32_t xl = std::max(x0, (int32_t)floorf(ax + spans[0].a) + 1);
+      int32_t xr = std::min(x1, (int32_t)ceilf(ax + spans[n - 1].b) - 1);
+      while (xl > x0 && coverage(xl - 1) > LoAlphaTheshold) --xl;
+      while (xr < x1 && coverage(xr + 1) > LoAlphaTheshold) ++xr;
+      if (xl > xr) continue;
+
+      // The solid interior is the longest run of the inner contour; pixels of
+      // any other run are blended at their own coverage. Rows too short for a
+      // fill are blended whole.
+      int32_t sl = xr + 1, sr = xr;
+      n = xr - xl + 1 < MinSolidFill ? 0 : row_spans(ar - HiAlphaTheshold, spans);
+      for (int i = 0; i < n; i++)
+      {
+        int32_t l = std::max(xl, (int32_t)floorf(ax + spans[i].a) + 1);
+        int32_t r = std::min(xr, (int32_t)ceilf(ax + spans[i].b) - 1);
+        while (l <= r && coverage(l) <= HiAlphaTheshold) ++l;
+        while (r >= l && coverage(r) <= HiAlphaTheshold) --r;
+        if (r - l > sr - sl) { sl = l; sr = r; }
+      }
+
+      if (sr - sl + 1 < MinSolidFill)
+      {
+        blend_run(xl, xr, sl, sr, yp);
+        continue;
+      }
+      if (xl < sl) blend_run(xl, sl - 1, sl, sr, yp);
+      if (use_gradient)
+      {
+        for (int32_t xc = sl; xc <= sr; xc += SpanChunk)
+        {
+          int32_t n = std::min(SpanChunk, sr - xc + 1);
+          for (int32_t i = 0; i < n; i++) colors[i] = color_at(xc + i, yp);
+          pushImage(xc, yp, n, 1, colors);
         }
-        fillRectAlpha(xp, yp, 1, 1, (uint8_t)(alpha * PixelAlphaGain), fg_color);
       }
+      else
+      {
+        writeFillRectPreclipped(sl, yp, sr - sl + 1, 1);
+      }
+      if (sr < xr) blend_run(sr + 1, xr, sl, sr, yp);
     }
 
     endWrite();
-    clearClipRect();
   }
 
   void LGFXBase::draw_wedgeline(float ax, float ay, float bx, float by, float ar, float br, const uint32_t fg_color)
@@ -1171,6 +1310,24 @@ namespace lgfx
     r++;
     int32_t r2 = r * r;
 
+    // Each corner row's edge pixels are gathered and blended as one span per corner
+    constexpr int32_t SpanChunk = 64;
+    uint8_t alphas[SpanChunk];
+    uint8_t mirror[SpanChunk];
+    int32_t run_x = 0, run = 0, run_cy = 0;
+    auto flush = [&]()
+    {
+      if (!run) return;
+      for (int32_t i = 0; i < run; i++) mirror[i] = alphas[run - 1 - i];
+      int32_t lx = x + run_x - r;
+      int32_t rx = x - (run_x + run - 1) + r + w;
+      blend_alpha_span(lx, y + run_cy - r    , run, alphas, nullptr, rgb888);
+      blend_alpha_span(rx, y + run_cy - r    , run, mirror, nullptr, rgb888);
+      blend_alpha_span(rx, y - run_cy + r + h, run, mirror, nullptr, rgb888);
+      blend_alpha_span(lx, y - run_cy + r + h, run, alphas, nullptr, rgb888);
+      run = 0;
+    };
+
     for (int32_t cy = r - 1; cy > 0; cy--)
     {
       int32_t dy2 = (r - cy) * (r - cy);
@@ -1182,13 +1339,11 @@ namespace lgfx
         float alphaf = (float)r - sqrtf(hyp2);
         if (alphaf > HiAlphaTheshold) break;
         xs = cx;
-        if (alphaf < LoAlphaTheshold) continue;
-        uint8_t alpha = alphaf * 255;
-        fillRectAlpha(x + cx - r    , y + cy - r    , 1, 1, alpha, rgb888);
-        fillRectAlpha(x - cx + r + w, y + cy - r    , 1, 1, alpha, rgb888);
-        fillRectAlpha(x - cx + r + w, y - cy + r + h, 1, 1, alpha, rgb888);
-        fillRectAlpha(x + cx - r    , y - cy + r + h, 1, 1, alpha, rgb888);
+        if (run == SpanChunk) flush();
+        if (run == 0) { run_x = cx; run_cy = cy; }
+        alphas[run++] = alphaf < LoAlphaTheshold ? 0 : (uint8_t)(alphaf * 255);
       }
+      flush();
       writeFastHLine(x + cx - r, y + cy - r, 2 * (r - cx) + 1 + w);
       writeFastHLine(x + cx - r, y - cy + r + h, 2 * (r - cx) + 1 + w);
     }
@@ -1396,6 +1551,8 @@ namespace lgfx
                : (dst_depth == rgb888_3Byte) ? pixelcopy_t::copy_grayscale_affine<bgr888_t>
                : (dst_depth == rgb666_3Byte) ? pixelcopy_t::copy_grayscale_affine<bgr666_t>
                : (dst_depth == rgb565_nonswapped) ? pixelcopy_t::copy_grayscale_affine<rgb565_t>
+               : (dst_depth == rgb888_nonswapped) ? pixelcopy_t::copy_grayscale_affine<rgb888_t>
+               : (dst_depth == argb8888_nonswapped) ? pixelcopy_t::copy_grayscale_affine<argb8888_t>
                : (dst_depth == grayscale_8bit) ? pixelcopy_t::copy_grayscale_affine<grayscale_t>
                : nullptr;
 
@@ -1534,12 +1691,18 @@ namespace lgfx
     if (pc_post.dst_bits > 16) {
       if (dst_depth == rgb888_3Byte) {
         pc_post.fp_copy = pixelcopy_t::blend_rgb_fast<bgr888_t, argb8888_t>;
+      } else if (dst_depth == rgb888_nonswapped) {
+        pc_post.fp_copy = pixelcopy_t::blend_rgb_fast<rgb888_t, argb8888_t>;
+      } else if (dst_depth == argb8888_nonswapped) {
+        pc_post.fp_copy = pixelcopy_t::blend_rgb_fast<argb8888_t, argb8888_t>;
       } else {
         pc_post.fp_copy = pixelcopy_t::blend_rgb_fast<bgr666_t, argb8888_t>;
       }
     } else {
       if (dst_depth == rgb565_2Byte) {
         pc_post.fp_copy = pixelcopy_t::blend_rgb_fast<swap565_t, argb8888_t>;
+      } else if (dst_depth == rgb565_nonswapped) {
+        pc_post.fp_copy = pixelcopy_t::blend_rgb_fast<rgb565_t, argb8888_t>;
       } else { // src_depth == rgb332_1Byte:
         pc_post.fp_copy = pixelcopy_t::blend_rgb_fast<rgb332_t, argb8888_t>;
       }
@@ -1648,7 +1811,16 @@ namespace lgfx
 
     int32_t y = min_y - max_y;
 
+    // Only worth tiling when a destination row walks across source rows.
+    int32_t tile = iA[3] ? std::min<int32_t>(affineTile_impl(), AFFINE_TILE_MAX) : 0;
+
     startWrite();
+    if (tile > 0)
+    {
+      push_image_affine_tiled(iA, y, max_y, tile, xs1, xs2, ys1, ys2, pc);
+      endWrite();
+      return;
+    }
     do
     {
       iA[2] += iA[1];
@@ -1673,6 +1845,72 @@ namespace lgfx
     endWrite();
   }
 
+  /// Same spans as the row loop in push_image_affine, written in tile x tile
+  /// blocks: a band of rows is clipped first, then sent one column block at a
+  /// time, so the source lines a block reads are still cached for the next row.
+  void LGFXBase::push_image_affine_tiled(int32_t* iA, int32_t y, int32_t max_y, int32_t tile, int32_t xs1, int32_t xs2, int32_t ys1, int32_t ys2, pixelcopy_t* pc)
+  {
+    int32_t cl = _clip_l    ;
+    int32_t cr = _clip_r + 1;
+
+    int32_t lefts[AFFINE_TILE_MAX];
+    int32_t rights[AFFINE_TILE_MAX];
+    int32_t x32s[AFFINE_TILE_MAX];
+    int32_t y32s[AFFINE_TILE_MAX];
+
+    do
+    {
+      int32_t rows = std::min(tile, -y);
+      int32_t band_l = cr;
+      int32_t band_r = cl;
+      for (int32_t i = 0; i < rows; ++i)
+      {
+        iA[2] += iA[1];
+        iA[5] += iA[4];
+        int32_t left  = std::max(cl, std::max(iA[0] ? (iA[2] + xs1) / - iA[0] : cl, (iA[5] + ys1) / - iA[3]));
+        int32_t right = std::min(cr, std::min(iA[0] ? (iA[2] + xs2) / - iA[0] : cr, (iA[5] + ys2) / - iA[3]));
+        if (left < right)
+        { // the row loop drops a whole row whose first pixel rounds outside
+          pc->src_x32 = iA[2] + left * iA[0];
+          pc->src_y32 = iA[5] + left * iA[3];
+          if (static_cast<uint32_t>(pc->src_x) >= static_cast<uint32_t>(pc->src_width)
+           || static_cast<uint32_t>(pc->src_y) >= static_cast<uint32_t>(pc->src_height))
+          {
+            right = left;
+          }
+        }
+        lefts[i]  = left;
+        rights[i] = right;
+        x32s[i] = iA[2];
+        y32s[i] = iA[5];
+        if (left < right)
+        {
+          band_l = std::min(band_l, left);
+          band_r = std::max(band_r, right);
+        }
+      }
+
+      for (int32_t bx = band_l; bx < band_r; bx += tile)
+      {
+        int32_t bx_end = bx + tile;
+        for (int32_t i = 0; i < rows; ++i)
+        {
+          int32_t left  = std::max(lefts[i], bx);
+          int32_t right = std::min(rights[i], bx_end);
+          if (left < right)
+          { // a rotated panel rewrites all four for its own axes, so every span sets them
+            pc->src_x32 = x32s[i] + left * iA[0];
+            pc->src_y32 = y32s[i] + left * iA[3];
+            pc->src_x32_add = iA[0];
+            pc->src_y32_add = iA[3];
+            _panel->writeImage(left, y + i + max_y, right - left, 1, pc, true);
+          }
+        }
+      }
+      y += rows;
+    } while (y);
+  }
+
   void LGFXBase::push_image_affine_aa(const float* matrix, pixelcopy_t* pc, pixelcopy_t* pc2)
   {
     int32_t min_y = matrix[3] * (pc->src_width  << FP_SCALE);
@@ -1848,20 +2086,105 @@ namespace lgfx
     _panel->readRect(x, y, w, h, dst, param);
   }
 
-  struct paint_point_t { int32_t lx,rx,y,oy; };
+  // Span filling over a bitmap of the clip rect. A set bit is a pixel that
+  // still has the target colour; filling a span clears its bits, so the bitmap
+  // is also the visited map and each row is read only once.
+  struct paint_span_t { int16_t lx, rx, y, dy; };
 
-  static void paint_add_points(std::list<paint_point_t>& points, int32_t lx, int32_t rx, int32_t y, int32_t oy, uint8_t* linebuf)
+  class paint_span_stack_t
+  {
+  public:
+    ~paint_span_stack_t(void) { if (_spans != _local) heap_free(_spans); }
+
+    void push(int32_t lx, int32_t rx, int32_t y, int32_t dy)
+    {
+      if (_size == _capacity && !grow()) return;
+      _spans[_size++] = { (int16_t)lx, (int16_t)rx, (int16_t)y, (int16_t)dy };
+    }
+
+    bool pop(paint_span_t& span)
+    {
+      if (_size == 0) return false;
+      span = _spans[--_size];
+      return true;
+    }
+
+  private:
+    bool grow(void)
+    {
+      auto spans = (paint_span_t*)heap_alloc(_capacity * 2 * sizeof(paint_span_t));
+      if (spans == nullptr) return false;
+      memcpy(spans, _spans, _size * sizeof(paint_span_t));
+      if (_spans != _local) heap_free(_spans);
+      _spans = spans;
+      _capacity *= 2;
+      return true;
+    }
+
+    paint_span_t _local[64];
+    paint_span_t* _spans = _local;
+    size_t _size = 0;
+    size_t _capacity = 64;
+  };
+
+  static inline bool paint_test(const uint32_t* row, int32_t x)
+  {
+    return (row[x >> 5] >> (x & 31)) & 1;
+  }
+
+  // first set bit in [x, end), or x if x >= end, or end if none.
+  static int32_t paint_next_set(const uint32_t* row, int32_t x, int32_t end)
+  {
+    if (x >= end) return x;
+    do
+    {
+      uint32_t word = row[x >> 5] >> (x & 31);
+      if (word) { x += __builtin_ctz(word); return x < end ? x : end; }
+      x = (x | 31) + 1;
+    } while (x < end);
+    return end;
+  }
+
+  // first clear bit in [x, end), or end if none.
+  static int32_t paint_next_clear(const uint32_t* row, int32_t x, int32_t end)
   {
-    paint_point_t pt { 0, 0, y, oy };
     do
     {
-      while (lx < rx && !linebuf[lx]) ++lx;
-      if (!linebuf[lx]) break;
-      pt.lx = lx;
-      while (++lx <= rx && linebuf[lx]);
-      pt.rx = lx - 1;
-      points.emplace_back(pt);
-    } while (lx <= rx);
+      uint32_t word = ~row[x >> 5] >> (x & 31);
+      if (word) { x += __builtin_ctz(word); return x < end ? x : end; }
+      x = (x | 31) + 1;
+    } while (x < end);
+    return end;
+  }
+
+  // last clear bit at or left of x, or -1 if none.
+  static int32_t paint_prev_clear(const uint32_t* row, int32_t x)
+  {
+    do
+    {
+      uint32_t word = ~row[x >> 5] << (31 - (x & 31));
+      if (word) { return x - __builtin_clz(word); }
+      x = (x & ~31) - 1;
+    } while (x >= 0);
+    return -1;
+  }
+
+  // clears bits [lx, rx).
+  static void paint_clear(uint32_t* row, int32_t lx, int32_t rx)
+  {
+    uint32_t* w = &row[lx >> 5];
+    uint32_t* we = &row[(rx - 1) >> 5];
+    uint32_t lmask = ~0u << (lx & 31);
+    uint32_t rmask = ~0u >> (-rx & 31);
+    if (w == we) { *w &= ~(lmask & rmask); return; }
+    *w++ &= ~lmask;
+    while (w != we) { *w++ = 0; }
+    *w &= ~rmask;
+  }
+
+  bool LGFXBase::readMatchRow_impl(int32_t, int32_t, int32_t, uint32_t, uint32_t*)
+  {
+    return false;
   }
 
   void LGFXBase::floodFill(int32_t x, int32_t y)
@@ -1879,6 +2202,9 @@ namespace lgfx
     case color_depth_t::rgb888_3Byte: p.fp_copy = pixelcopy_t::compare_rgb_affine<bgr888_t>;  break;
     case color_depth_t::rgb666_3Byte: p.fp_copy = pixelcopy_t::compare_rgb_affine<bgr666_t>;  break;
     case color_depth_t::rgb565_2Byte: p.fp_copy = pixelcopy_t::compare_rgb_affine<swap565_t>; break;
+    case color_depth_t::rgb565_nonswapped: p.fp_copy = pixelcopy_t::compare_rgb_affine<rgb565_t>; break;
+    case color_depth_t::rgb888_nonswapped: p.fp_copy = pixelcopy_t::compare_rgb_affine<rgb888_t>; break;
+    case color_depth_t::argb8888_nonswapped: p.fp_copy = pixelcopy_t::compare_rgb_affine<argb8888_t>; break;
     case color_depth_t::rgb332_1Byte: p.fp_copy = pixelcopy_t::compare_rgb_affine<rgb332_t>;  break;
     case color_depth_t::grayscale_8bit: p.fp_copy = pixelcopy_t::compare_rgb_affine<grayscale_t>;  break;
     default: p.fp_copy = pixelcopy_t::compare_bit_affine;
@@ -1888,91 +2214,75 @@ namespace lgfx
     }
 
     const int32_t cl = _clip_l;
+    const int32_t ct = _clip_t;
     const int32_t w = _clip_r - cl + 1;
-    size_t bufIdx = 0;
-    uint8_t* linebufs[3] = { new uint8_t[w], new uint8_t[w], new uint8_t[w] };
-    int32_t bufY[3] = {y, -2, -2};  // 3 line buffer (default: out of range.)
-    _panel->readRect(cl, y, w, 1, linebufs[0], &p);
-    std::list<paint_point_t> points;
-    points.push_back({x, x, y, y});
-
-    startWrite();
-    while (!points.empty())
-    {
-      int32_t y0 = bufY[bufIdx];
-
-      auto it = points.begin();
-      int32_t counter = 0;
-      while (it->y != y0 && ++it != points.end()) ++counter;
-      if (it == points.end())
+    const int32_t h = _clip_b - ct + 1;
+    const size_t stride = (w + 31) >> 5;
+
+    // match bitmap, then one "row read" flag per row, then a line buffer for readRect.
+    auto bitmap = (uint32_t*)heap_alloc(stride * h * sizeof(uint32_t) + h + w);
+    if (bitmap == nullptr) return;
+    auto loaded = (uint8_t*)&bitmap[stride * h];
+    auto linebuf = &loaded[h];
+    memset(loaded, 0, h);
+
+    auto get_row = [&](int32_t ry) -> uint32_t*
+    {
+      auto row = &bitmap[ry * stride];
+      if (loaded[ry]) return row;
+      loaded[ry] = 1;
+      if (readMatchRow_impl(cl, ct + ry, w, p.transp, row)) return row;
+      p.src_x32_add = 1 << FP_SCALE;
+      p.src_y32_add = 0;
+      _panel->readRect(cl, ct + ry, w, 1, linebuf, &p);
+      memset(row, 0, stride * sizeof(uint32_t));
+      for (int32_t i = 0; i < w; ++i)
       {
-        if (counter < 256)
-        {
-          ++bufIdx;
-          int32_t y1 = bufY[(bufIdx  )%3];
-          int32_t y2 = bufY[(bufIdx+1)%3];
-          it = points.begin();
-
-          while ((it->y != y1) && (it->y != y2) && (++it != points.end()));
-        }
-        bufIdx = 0;
-        if (it == points.end())
-        {
-          it = points.begin();
-
-          bufY[0] = it->y;
-          p.src_x32_add = 1 << FP_SCALE;
-          p.src_y32_add = 0;
-          _panel->readRect(cl, it->y, w, 1, linebufs[0], &p);
-        }
-        else
-        {
-          for (; bufIdx < 2; ++bufIdx) if (it->y == bufY[bufIdx]) break;
-        }
+        if (linebuf[i]) { row[i >> 5] |= 1u << (i & 31); }
       }
-      auto linebuf = &linebufs[bufIdx][- cl];
-
-      int32_t lx = it->lx;
-      int32_t rx = it->rx;
-      int32_t ly = it->y;
-      int32_t oy = it->oy;
-      points.erase(it);
-      if (!linebuf[lx]) continue;
-
-      int32_t lxsav = lx - 1;
-      int32_t rxsav = rx + 1;
-
-      const int32_t cr = _clip_r;
-      while (lx > cl && linebuf[lx - 1]) --lx;
-      while (rx < cr && linebuf[rx + 1]) ++rx;
-      bool flg_noexpanded = lx >= lxsav && rxsav >= rx;
+      return row;
+    };
 
-      memset(&linebuf[lx], 0, rx - lx + 1);
-      writeFillRectPreclipped(lx, ly, rx - lx + 1, 1);
+    x -= cl;
+    y -= ct;
+    paint_span_stack_t spans;
+    spans.push(x, x, y, 1);
+    spans.push(x, x, y - 1, -1);
 
-      int32_t nexty[2] = { ly - 1, ly + 1 };
-      if (ly < y) std::swap(nexty[0], nexty[1]);
-      size_t i = 0;
-      do
+    startWrite();
+    paint_span_t span;
+    while (spans.pop(span))
+    {
+      int32_t sy = span.y;
+      if (sy < 0 || sy >= h) continue;
+      auto row = get_row(sy);
+      int32_t lx = span.lx;
+      int32_t rx = span.rx;
+      int32_t dy = span.dy;
+
+      // a run that reaches left of the span also leaks back to the row it came from.
+      int32_t runx = lx;
+      if (paint_test(row, lx))
       {
-        int32_t newy = nexty[i];
-        if (newy == oy && flg_noexpanded) continue;
-        if (newy < _clip_t || newy > _clip_b) continue;
-        size_t bidx = 0;
-        while (newy != bufY[bidx] && ++bidx != 3);
-        if (bidx == 3) {
-          for (bidx = 0; bidx < 2 && (abs(bufY[bidx] - ly) <= 1); ++bidx);
-          bufY[bidx] = newy;
-          p.src_x32_add = 1 << FP_SCALE;
-          p.src_y32_add = 0;
-          _panel->readRect(cl, newy, w, 1, linebufs[bidx], &p);
+        runx = paint_prev_clear(row, lx) + 1;
+        if (runx < lx) { spans.push(runx, lx - 1, sy - dy, -dy); }
+      }
+      while (lx <= rx)
+      {
+        if (paint_test(row, lx)) { lx = paint_next_clear(row, lx, w); }
+        if (lx > runx)
+        {
+          paint_clear(row, runx, lx);
+          writeFillRectPreclipped(cl + runx, ct + sy, lx - runx, 1);
+          spans.push(runx, lx - 1, sy + dy, dy);
+          if (lx - 1 > rx) { spans.push(rx + 1, lx - 1, sy - dy, -dy); }
         }
-        paint_add_points(points, lx ,rx, newy, ly, &linebufs[bidx][- cl]);
-      } while (++i < 2);
+        lx = paint_next_set(row, lx + 1, rx);
+        runx = lx;
+      }
     }
-    size_t i = 0;
-    do { delete[] linebufs[i]; } while (++i != 3);
     endWrite();
+    heap_free(bitmap);
   }
 
 //----------------------------------------------------------------------------
@@ -2506,13 +2816,18 @@ namespace lgfx
     else
 #endif
     {
-      this->_runtime_font.reset(new VLWfont());
+      auto vlw = new VLWfont();
+      vlw->setReadAhead(_read_ahead_size);
+      this->_runtime_font.reset(vlw);
     }
 
     if (this->_runtime_font->loadFont(data)) {
       result = true;
       this->_font = this->_runtime_font.get();
       this->_font->getDefaultMetric(&this->_font_metrics);
+      if (this->_font->getType() == IFont::ft_vlw) {
+        static_cast<VLWfont*>(this->_runtime_font.get())->setGlyphCache(_glyph_cache_size, _glyph_cache_psram);
+      }
     } else {
       this->unloadFont();
     }
@@ -2524,6 +2839,27 @@ namespace lgfx
     if (_runtime_font.get() != nullptr) { setFont(&fonts::Font0); }
   }
 
+  void LGFXBase::setGlyphCache(size_t bytes, bool psram)
+  {
+    _glyph_cache_size = bytes;
+    _glyph_cache_psram = psram;
+    if (_runtime_font.get() != nullptr && _runtime_font->getType() == IFont::ft_vlw) {
+      static_cast<VLWfont*>(_runtime_font.get())->setGlyphCache(bytes, psram);
+    }
+  }
+
+  size_t LGFXBase::prewarmGlyphs(const char* utf8)
+  {
+    if (_font != _runtime_font.get() || _font->getType() != IFont::ft_vlw) return 0;
+    return static_cast<VLWfont*>(_runtime_font.get())->prewarmGlyphs(utf8);
+  }
+
+  size_t LGFXBase::prewarmGlyphs(uint16_t first, uint16_t last)
+  {
+    if (_font != _runtime_font.get() || _font->getType() != IFont::ft_vlw) return 0;
+    return static_cast<VLWfont*>(_runtime_font.get())->prewarmGlyphs(first, last);
+  }
+
   void LGFXBase::showFont(uint32_t td)
   {
     int_fast16_t x = 0;
@@ -2754,6 +3090,8 @@ namespace lgfx
   bool LGFXBase::draw_bmp(DataWrapper* data, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, float zoom_x, float zoom_y, datum_t datum)
   {
     prepareTmpTransaction(data);
+    BufferedDataWrapper buffered;
+    data = read_ahead(data, &buffered);
     bitmap_header_t bmpdata;
     if (!bmpdata.load_bmp_header(data) || (bmpdata.biCompression > 3)) {
       return false;
@@ -2829,6 +3167,7 @@ namespace lgfx
     p.src_bitwidth = w;
     p.src_width = w;
     p.src_height = 1;
+    const uint8_t* row = nullptr;
 
     do
     {
@@ -2842,10 +3181,12 @@ namespace lgfx
         bmpdata.load_bmp_rle4(data, lineBuffer, w);
       }
       else
-      {
-        data->read(lineBuffer, buffersize);
+      { // Rows already in memory are drawn in place; +4 covers the copy's over-read.
+        row = data->peek(buffersize + 4);
+        if (row == nullptr) { data->read(lineBuffer, buffersize); }
       }
       data->postRead();
+      p.src_data = row ? (void*)row : lineBuffer;
       y32 += dst_y32_add;
       int32_t next_y = y32 >> FP_SCALE;
       while (y != next_y)
@@ -2855,6 +3196,7 @@ namespace lgfx
         this->push_image_affine(affine, &p);
         y += flow;
       }
+      if (row) { data->skip(buffersize); }
     } while (--h);
 
     info.end();
@@ -2931,6 +3273,8 @@ namespace lgfx
   bool LGFXBase::draw_jpg(DataWrapper* data, int32_t x, int32_t y, int32_t maxWidth, int32_t maxHeight, int32_t offX, int32_t offY, float zoom_x, float zoom_y, datum_t datum)
   {
     prepareTmpTransaction(data);
+    BufferedDataWrapper buffered;
+    data = read_ahead(data, &buffered);
     draw_jpg_info_t drawinfo;
     pixelcopy_t pc(nullptr, this->getColorDepth(), bgr888_t::depth, this->hasPalette());
     drawinfo.pc = &pc;
@@ -3320,6 +3664,8 @@ namespace lgfx
     if (pngle == nullptr) { return false; }
 
     prepareTmpTransaction(data);
+    BufferedDataWrapper buffered;
+    data = read_ahead(data, &buffered);
     png_file_decoder_t png;
     png.lineBuffer = nullptr;
     png.data = data;
@@ -3380,6 +3726,8 @@ namespace lgfx
     if (qoi == nullptr) { return false; }
 
     prepareTmpTransaction(data);
+    BufferedDataWrapper buffered;
+    data = read_ahead(data, &buffered);
     png_file_decoder_t png;
     png.lineBuffer = nullptr;
     png.data = data;
@@ -3473,6 +3821,40 @@ namespace lgfx
     return res;
   }
 
+  static uint8_t *qoi_encoder_get_row( uint8_t *lineBuffer, int flip, int w, int h, int y, void *target )
+  {
+    auto enc = static_cast<png_encoder_t*>(target);
+    uint32_t ypos = (flip ? (h - 1 - y) : y);
+    enc->gfx->readRectRGB( enc->x, enc->y + ypos, w, 1, lineBuffer );
+    return lineBuffer;
+  }
+
+  void* LGFXBase::createQoi(size_t* datalen, int32_t x, int32_t y, int32_t w, int32_t h)
+  {
+    if (_adjust_abs(x, w)||_adjust_abs(y, h)) return nullptr;
+    if (x < 0) { w += x; x = 0; }
+    if (w > width() - x)  w = width()  - x;
+    if (w < 1) return nullptr;
+    if (y < 0) { h += y; y = 0; }
+    if (h > height() - y) h = height() - y;
+    if (h < 1) return nullptr;
+
+    void* rgbBuffer = heap_alloc_dma(w * 3);
+    if (rgbBuffer == nullptr) return nullptr;
+    // qoi_encoder_get_row fills each line before it is read, but the encoder
+    // takes the buffer as const and GCC cannot see that
+    memset(rgbBuffer, 0, w * 3);
+
+    png_encoder_t enc = { this, x, y };
+
+    auto res = lgfx_qoi_encoder_write_fb(rgbBuffer, w, h, 3, datalen, 0, qoi_encoder_get_row, &enc);
+
+    heap_free(rgbBuffer);
+
+    // on failure the encoder has not allocated anything for this call
+    return *datalen ? res : nullptr;
+  }
+
 //----------------------------------------------------------------------------
 
   void LGFXBase::prepareTmpTransaction(DataWrapper* data)
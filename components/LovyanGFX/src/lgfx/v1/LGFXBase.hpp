@@ -52,12 +52,14 @@ namespace lgfx
 #define LGFX_PRINTF_ENABLED
 #endif
 
+  class AsyncPush;
 
   class LGFXBase
 #if defined (ARDUINO)
   : public Print
 #endif
   {
+    friend AsyncPush;
   public:
     LGFXBase(void) = default;
     virtual ~LGFXBase(void) = default;
@@ -578,12 +580,18 @@ namespace lgfx
       if (pc.dst_bits > 16) {
         if (pc.dst_depth == rgb888_3Byte) {
           pc.fp_copy = pixelcopy_t::blend_rgb_fast<bgr888_t, T>;
+        } else if (pc.dst_depth == rgb888_nonswapped) {
+          pc.fp_copy = pixelcopy_t::blend_rgb_fast<rgb888_t, T>;
+        } else if (pc.dst_depth == argb8888_nonswapped) {
+          pc.fp_copy = pixelcopy_t::blend_rgb_fast<argb8888_t, T>;
         } else {
           pc.fp_copy = pixelcopy_t::blend_rgb_fast<bgr666_t, T>;
         }
       } else {
         if (pc.dst_depth == rgb565_2Byte) {
           pc.fp_copy = pixelcopy_t::blend_rgb_fast<swap565_t, T>;
+        } else if (pc.dst_depth == rgb565_nonswapped) {
+          pc.fp_copy = pixelcopy_t::blend_rgb_fast<rgb565_t, T>;
         } else { // src_depth == rgb332_1Byte:
           pc.fp_copy = pixelcopy_t::blend_rgb_fast<rgb332_t, T>;
         }
@@ -823,6 +831,15 @@ namespace lgfx
     /// unload VLW font
     void unloadFont(void);
 
+    /// Keep up to `bytes` of decoded VLW glyphs in memory (PSRAM when `psram` and
+    /// available), for this font and the ones loaded after it. 0 disables.
+    void setGlyphCache(size_t bytes, bool psram = true);
+
+    /// Load the glyphs of a UTF-8 string, or of a code point range, of the
+    /// current VLW font into the glyph cache. Returns how many characters were cached.
+    size_t prewarmGlyphs(const char* utf8);
+    size_t prewarmGlyphs(uint16_t first, uint16_t last);
+
     /// show VLW font
     void showFont(uint32_t td = 2000);
 
@@ -842,6 +859,11 @@ namespace lgfx
 
     void clearFileStorage(void) { _data_wrapper_factory.reset(new DataWrapperTFactoryT<void>(nullptr)); }
 
+    /// Read images and VLW fonts that are not already in memory through a
+    /// `bytes` sized read-ahead window, applied to each image drawn and each
+    /// VLW font loaded after the call. 0 reads the source directly.
+    void setReadAhead(uint32_t bytes) { _read_ahead_size = bytes; }
+
 //----------------------------------------------------------------------------
 // print & text support
 //----------------------------------------------------------------------------
@@ -975,6 +997,10 @@ namespace lgfx
 
     void* createPng( size_t* datalen, int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0);
 
+    /// Same as createPng, QOI encoded: lossless like PNG, much faster to write.
+    /// Release the result with free().
+    void* createQoi( size_t* datalen, int32_t x = 0, int32_t y = 0, int32_t width = 0, int32_t height = 0);
+
     void releasePngMemory(void);
 
     template<typename T>
@@ -998,8 +1024,23 @@ namespace lgfx
 
   protected:
 
+    // Returns `buffered` reading `data` ahead, or `data` itself when that gains nothing.
+    DataWrapper* read_ahead(DataWrapper* data, BufferedDataWrapper* buffered)
+    {
+      if (_read_ahead_size == 0 || data->isBuffered()) { return data; }
+      return buffered->attach(data, _read_ahead_size) ? buffered : data;
+    }
+
     virtual RGBColor* getPalette_impl(void) const { return nullptr; }
 
+    // Sets bit i of `bits` (LSB first, 32 per word, unused bits zero) where the
+    // raw pixel at (x + i, y) equals `rawcolor`; false if not readable directly.
+    virtual bool readMatchRow_impl(int32_t x, int32_t y, int32_t w, uint32_t rawcolor, uint32_t* bits);
+
+    // Block size, in pixels, for writing rotated images in tile order; 0 writes
+    // them row by row. Pays off where the destination takes small writes cheaply.
+    virtual int32_t affineTile_impl(void) const { return 0; }
+
     IPanel* _panel = nullptr;
 
     int32_t _sx = 0, _sy = 0, _sw = 0, _sh = 0; // for scroll zone
@@ -1035,6 +1076,9 @@ namespace lgfx
     const IFont* _font = &fonts::Font0;
 
     std::shared_ptr<RunTimeFont> _runtime_font;  // run-time generated font
+    size_t _glyph_cache_size = 0;  // applied to each VLW font loaded
+    bool _glyph_cache_psram = true;
+    uint32_t _read_ahead_size = BufferedDataWrapper::default_size;
     std::shared_ptr<DataWrapper> _font_file;  // run-time font file
     PointerWrapper _font_data;
 
@@ -1086,6 +1130,7 @@ namespace lgfx
       {
         if (     dst_depth == rgb888_3Byte) { pc.fp_copy = pixelcopy_t::copy_rgb_fast<bgr888_t, T>; }
         else if (dst_depth == rgb666_3Byte) { pc.fp_copy = pixelcopy_t::copy_rgb_fast<bgr666_t, T>; }
+        else if (dst_depth == rgb888_nonswapped) { pc.fp_copy = pixelcopy_t::copy_rgb_fast<rgb888_t, T>; }
         else                                { pc.fp_copy = pixelcopy_t::copy_rgb_fast<argb8888_t, T>; }
       }
       else
@@ -1148,11 +1193,13 @@ namespace lgfx
         {
           if (     dst_depth == rgb888_3Byte) { pc.fp_copy = pixelcopy_t::copy_palette_fast<bgr888_t, T>; }
           else if (dst_depth == rgb666_3Byte) { pc.fp_copy = pixelcopy_t::copy_palette_fast<bgr666_t, T>; }
+          else if (dst_depth == rgb888_nonswapped) { pc.fp_copy = pixelcopy_t::copy_palette_fast<rgb888_t, T>; }
           else                                { pc.fp_copy = pixelcopy_t::copy_palette_fast<argb8888_t, T>; }
         }
         else
         {
           if (     dst_depth == rgb565_2Byte) { pc.fp_copy = pixelcopy_t::copy_palette_fast<swap565_t, T>; }
+          else if (dst_depth == rgb565_nonswapped) { pc.fp_copy = pixelcopy_t::copy_palette_fast<rgb565_t, T>; }
           else if (dst_depth == rgb332_1Byte) { pc.fp_copy = pixelcopy_t::copy_palette_fast<rgb332_t, T>; }
           else                                { pc.fp_copy = pixelcopy_t::copy_palette_fast<grayscale_t, T>; }
         }
@@ -1327,6 +1374,7 @@ namespace lgfx
 //----------------------------------------------------------------------------
 
     bool clampArea(int32_t *xlo, int32_t *ylo, int32_t *xhi, int32_t *yhi);
+    void blend_alpha_span(int32_t x, int32_t y, int32_t w, const uint8_t* alpha, const rgb888_t* colors, rgb888_t color);
 
     rgb888_t map_gradient( float value, float start, float end, const rgb888_t *colors, uint32_t colors_count );
     rgb888_t map_gradient( float value, float start, float end, const colors_t gradient );
@@ -1356,6 +1404,7 @@ namespace lgfx
     void push_image_rotate_zoom_aa(float dst_x, float dst_y, float src_x, float src_y, float angle, float zoom_x, float zoom_y, int32_t w, int32_t h, pixelcopy_t* pc);
     void push_image_affine(const float* matrix, int32_t w, int32_t h, pixelcopy_t *pc);
     void push_image_affine(const float* matrix, pixelcopy_t *pc);
+    void push_image_affine_tiled(int32_t* iA, int32_t y, int32_t max_y, int32_t tile, int32_t xs1, int32_t xs2, int32_t ys1, int32_t ys2, pixelcopy_t *pc);
     void push_image_affine_aa(const float* matrix, int32_t w, int32_t h, pixelcopy_t *pc);
     void push_image_affine_aa(const float* matrix, pixelcopy_t *pre_pc, pixelcopy_t *post_pc);
 
@@ -273,6 +273,184 @@ namespace lgfx
     }
   }
 
+  // Alpha fill kernels. Each one blends in the sprite's own pixel format and
+  // gives exactly what effect_fill_alpha gives through the RGB888 round trip.
+  template <typename TColor>
+  static void blend_fill_direct(TColor* img, uint32_t stride, uint32_t w, uint32_t h, effect_fill_alpha fx)
+  {
+    do
+    {
+      uint32_t i = 0;
+      do { fx(0, 0, img[i]); } while (++i < w);
+      img += stride;
+    } while (--h);
+  }
+
+  // Blend target that keeps the channels in registers; bgr888_t would be
+  // packed to memory and read back for every pixel.
+  struct rgb_channels
+  {
+    uint_fast8_t r, g, b;
+    uint8_t R8(void) const { return r; }
+    uint8_t G8(void) const { return g; }
+    uint8_t B8(void) const { return b; }
+    void set(uint8_t r8, uint8_t g8, uint8_t b8) { r = r8; g = g8; b = b8; }
+  };
+
+  // 8bpp formats go through RGB888 exactly as the effect path does; they have
+  // only 256 values, so a large fill blends each value once.
+  template <typename TColor>
+  static void blend_fill_8bit(uint8_t* img, uint32_t stride, uint32_t w, uint32_t h, effect_fill_alpha fx)
+  {
+    auto blend = [fx](uint32_t v) mutable -> uint8_t
+    {
+      TColor src;
+      src.raw = v;
+      rgb_channels c { src.R8(), src.G8(), src.B8() };
+      fx(0, 0, c);
+      return color_convert<TColor, bgr888_t>(c.r | c.g << 8 | c.b << 16);
+    };
+    if (w * h < 256)
+    {
+      do
+      {
+        uint32_t i = 0;
+        do { img[i] = blend(img[i]); } while (++i < w);
+        img += stride;
+      } while (--h);
+      return;
+    }
+    uint8_t lut[256];
+    uint32_t i = 0;
+    do { lut[i] = blend(i); } while (++i < 256);
+    do
+    {
+      i = 0;
+      do { img[i] = lut[img[i]]; } while (++i < w);
+      img += stride;
+    } while (--h);
+  }
+
+  // RGB565 channels blend independently, so 128 table entries cover every
+  // pixel value; pixels are then read and written two per 32-bit word.
+  static void blend_fill_swap565(uint16_t* img, uint32_t stride, uint32_t w, uint32_t h, effect_fill_alpha fx)
+  {
+    if (w * h < 128)
+    {
+      blend_fill_direct(reinterpret_cast<swap565_t*>(img), stride, w, h, fx);
+      return;
+    }
+    uint16_t lut_r[32], lut_g[64], lut_b[32];
+    uint32_t i = 0;
+    do
+    {
+      swap565_t c;
+      c.gh = i >> 3;
+      c.gl = i;
+      c.r5 = i;
+      c.b5 = i;
+      fx(0, 0, c);
+      lut_g[i] = c.raw & 0xE007;
+      if (i < 32)
+      {
+        lut_r[i] = c.raw & 0x00F8;
+        lut_b[i] = c.raw & 0x1F00;
+      }
+    } while (++i < 64);
+
+    auto blend = [&](uint32_t v) -> uint32_t
+    {
+      return lut_r[(v >> 3) & 0x1F] | lut_g[((v & 7) << 3) | ((v >> 13) & 7)] | lut_b[(v >> 8) & 0x1F];
+    };
+    do
+    {
+      uint16_t* p = img;
+      uint32_t len = w;
+      if (reinterpret_cast<uintptr_t>(p) & 2)
+      {
+        *p = blend(*p);
+        ++p;
+        --len;
+      }
+      auto p32 = reinterpret_cast<uint32_t*>(p);
+      for (uint32_t n = len >> 1; n; --n, ++p32)
+      {
+        uint32_t v = *p32;
+        *p32 = blend(v & 0xFFFF) | blend(v >> 16) << 16;
+      }
+      if (len & 1)
+      {
+        p = reinterpret_cast<uint16_t*>(p32);
+        *p = blend(*p);
+      }
+      img += stride;
+    } while (--h);
+  }
+
+  void Panel_Sprite::writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888)
+  {
+    auto depth = _write_depth;
+    if (depth != rgb565_2Byte && depth != rgb332_1Byte && depth != grayscale_8bit
+     && depth != rgb888_3Byte && depth != argb8888_4Byte)
+    {
+      IPanel::writeFillRectAlphaPreclipped(x, y, w, h, argb8888);
+      return;
+    }
+    if ((argb8888 >> 24) == 0) { return; }
+
+    uint_fast8_t r = _rotation;
+    if (r)
+    {
+      if ((1u << r) & 0b10010110) { y = _height - (y + h); }
+      if (r & 2)                  { x = _width  - (x + w); }
+      if (r & 1) { std::swap(x, y);  std::swap(w, h); }
+    }
+
+    effect_fill_alpha fx { argb8888_t { argb8888 } };
+    uint32_t bw = _bitwidth;
+    uint32_t index = x + y * bw;
+    switch (depth)
+    {
+    case rgb565_2Byte:   blend_fill_swap565(&_img.img16()[index], bw, w, h, fx); break;
+    case rgb332_1Byte:   blend_fill_8bit<rgb332_t>(&_img.img8()[index], bw, w, h, fx); break;
+    case grayscale_8bit: blend_fill_8bit<grayscale_t>(&_img.img8()[index], bw, w, h, fx); break;
+    case rgb888_3Byte:   blend_fill_direct(&_img.img24()[index], bw, w, h, fx); break;
+    default:             blend_fill_direct(reinterpret_cast<bgra8888_t*>(&_img.img32()[index]), bw, w, h, fx); break;
+    }
+  }
+
+  static inline uint32_t raw_value(uint8_t v) { return v; }
+  static inline uint32_t raw_value(uint16_t v) { return v; }
+  static inline uint32_t raw_value(const bgr888_t& v) { return v.get(); }
+
+  template <typename TPixel>
+  static void match_row(const TPixel* img, uint32_t w, uint32_t rawcolor, uint32_t* bits)
+  {
+    do
+    {
+      uint32_t n = std::min<uint32_t>(w, 32);
+      uint32_t word = 0;
+      uint32_t i = 0;
+      do { word |= (uint32_t)(raw_value(img[i]) == rawcolor) << i; } while (++i < n);
+      *bits++ = word;
+      img += n;
+      w -= n;
+    } while (w);
+  }
+
+  bool Panel_Sprite::readMatchRow(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint32_t rawcolor, uint32_t* bits)
+  {
+    if (_rotation) { return false; }
+    uint32_t index = x + y * _bitwidth;
+    switch (_write_bits)
+    {
+    case 8:  match_row(&_img.img8()[index], w, rawcolor, bits); return true;
+    case 16: match_row(&_img.img16()[index], w, rawcolor, bits); return true;
+    case 24: match_row(&_img.img24()[index], w, rawcolor, bits); return true;
+    default: return false;
+    }
+  }
+
   void Panel_Sprite::writeBlock(uint32_t rawcolor, uint32_t length)
   {
     do
@@ -684,6 +862,133 @@ namespace lgfx
     }
   }
 
+//----------------------------------------------------------------------------
+
+  bool AsyncPush::start(LovyanGFX* dst, int32_t x, int32_t y, int32_t w, int32_t h, const pixelcopy_t& pc)
+  {
+    uint32_t row_bytes = w * (pc.dst_bits >> 3);
+    int32_t band_rows = std::max<int32_t>(1, std::min<int32_t>(h, _band_size / row_bytes));
+    uint32_t len = band_rows * row_bytes;
+    if (_buffer_len < len || _buffer_len > len + 1024)
+    {
+      release();
+      _buffer[0] = (uint8_t*)heap_alloc_dma(len);
+      _buffer[1] = (uint8_t*)heap_alloc_dma(len);
+      if (!_buffer[0] || !_buffer[1])
+      {
+        release();
+        return false;
+      }
+      _buffer_len = len;
+    }
+
+    _dst = dst;
+    _pc = pc;
+    _src_x = pc.src_x;
+    _w = w;
+    _band_rows = band_rows;
+    _rows_left = h;
+    _ready_rows = 0;
+    _flip = 0;
+
+    dst->startWrite();
+    dst->setWindow(x, y, x + w - 1, y + h - 1);
+    convert_band();
+    send_band();
+    convert_band();
+    return true;
+  }
+
+  void AsyncPush::convert_band(void)
+  {
+    int32_t rows = std::min(_band_rows, _rows_left);
+    auto buf = _buffer[_flip];
+    uint32_t w = _w;
+    uint32_t index = 0;
+    for (int32_t i = 0; i < rows; ++i)
+    {
+      _pc.src_x = _src_x;
+      _pc.fp_copy(buf, index, index + w, &_pc);
+      _pc.src_y++;
+      index += w;
+    }
+    _rows_left -= rows;
+    _ready_rows = rows;
+  }
+
+  void AsyncPush::send_band(void)
+  {
+    pixelcopy_t raw(_buffer[_flip], _pc.dst_depth, _pc.dst_depth);
+    _dst->_panel->writePixels(&raw, _ready_rows * _w, true);
+    _ready_rows = 0;
+    _flip = !_flip;
+  }
+
+  bool AsyncPush::poll(void)
+  {
+    if (_dst == nullptr) return false;
+
+    // Convert the next band while the previous one is still being sent.
+    if (_ready_rows == 0 && _rows_left) { convert_band(); }
+    if (_dst->dmaBusy()) return true;
+
+    if (_ready_rows)
+    {
+      send_band();
+      if (_rows_left) { convert_band(); }
+      return true;
+    }
+
+    _dst->endWrite();
+    _dst = nullptr;
+    if (_callback) { _callback(_callback_arg); }
+    return false;
+  }
+
+  void AsyncPush::release(void)
+  {
+    if (_dst) return;
+    for (auto& buf : _buffer)
+    {
+      if (buf) { heap_free(buf); }
+      buf = nullptr;
+    }
+    _buffer_len = 0;
+  }
+
+  bool LGFX_Sprite::push_sprite_async(LovyanGFX* dst, int32_t x, int32_t y, AsyncPush* job)
+  {
+    job->finish();
+
+    pixelcopy_t p(_img, dst->getColorDepth(), getColorDepth(), dst->hasPalette(), _palette);
+    if (p.dst_bits < 8 || dst->hasPalette())
+    {
+      push_sprite(dst, x, y);
+      return false;
+    }
+
+    int32_t w = _panel_sprite._panel_width;
+    int32_t h = _panel_sprite._panel_height;
+    uint32_t x_mask = 7 >> (p.src_bits >> 1);
+    p.src_bitwidth = (w + x_mask) & (~x_mask);
+
+    int32_t cx, cy, cw, ch;
+    dst->getClipRect(&cx, &cy, &cw, &ch);
+    int32_t dx = std::max<int32_t>(0, cx - x);
+    int32_t dy = std::max<int32_t>(0, cy - y);
+    w = std::min(x + w, cx + cw) - (x + dx);
+    h = std::min(y + h, cy + ch) - (y + dy);
+    if (w <= 0 || h <= 0) return false;
+    p.src_x32 = p.src_x32_add * dx;
+    p.src_y = dy;
+
+    if (job->start(dst, x + dx, y + dy, w, h, p)) return true;
+
+    // No room for the band buffers
+    push_sprite(dst, x, y);
+    return false;
+  }
+
 //----------------------------------------------------------------------------
 
   bool LGFX_Sprite::create_from_bmp_file(DataWrapper* data, const char *path) {
@@ -785,6 +1090,235 @@ namespace lgfx
     return true;
   }
 
+//----------------------------------------------------------------------------
+
+  static bool same_text_style(const TextStyle& a, const TextStyle& b)
+  {
+    return a.fore_rgb888 == b.fore_rgb888
+        && a.back_rgb888 == b.back_rgb888
+        && a.size_x      == b.size_x
+        && a.size_y      == b.size_y
+        && a.datum       == b.datum
+        && a.padding_x   == b.padding_x
+        && a.utf8        == b.utf8
+        && a.cp437       == b.cp437;
+  }
+
+  void TextRunCache::setBudget(size_t bytes)
+  {
+    _budget = bytes;
+    while (_used > _budget) { drop(_tail); ++_stats.evictions; }
+  }
+
+  void TextRunCache::clear(void)
+  {
+    while (_tail) { drop(_tail); }
+  }
+
+  void TextRunCache::drop(run_t* run)
+  {
+    if (run->prev) { run->prev->next = run->next; } else { _head = run->next; }
+    if (run->next) { run->next->prev = run->prev; } else { _tail = run->prev; }
+    _used -= run->bytes;
+    heap_free(run);
+  }
+
+  TextRunCache::run_t* TextRunCache::find(uint32_t hash, const char* string, const IFont* font, const TextStyle& style, color_depth_t depth)
+  {
+    for (auto run = _head; run; run = run->next)
+    {
+      if (run->hash != hash || run->font != font || run->depth != depth
+       || !same_text_style(run->style, style) || strcmp(run->string, string)) continue;
+
+      if (run != _head)
+      {
+        run->prev->next = run->next;
+        if (run->next) { run->next->prev = run->prev; } else { _tail = run->prev; }
+        run->prev = nullptr;
+        run->next = _head;
+        _head->prev = run;
+        _head = run;
+      }
+      return run;
+    }
+    return nullptr;
+  }
+
+  /// Draws the string once into a 32-bit scratch sprite filled with a key whose top byte no converted colour has:
+  /// every pixel that lost the key is one drawString paints. Text colours are blended in RGB888 before they are
+  /// converted, so converting the scratch pixels for the destination gives the raw values drawString would write.
+  TextRunCache::run_t* TextRunCache::render(LovyanGFX* dst, uint32_t hash, const char* string, const IFont* font)
+  {
+    static constexpr uint32_t unpainted = 0x01000000u;
+    auto painted = [](uint32_t argb) { return (argb & 0xFF000000u) != unpainted; };
+
+    auto& style = dst->getTextStyle();
+    auto depth = dst->getColorDepth();
+    auto dst_conv = dst->getColorConverter();
+    _scratch.setColorDepth(color_depth_t::argb8888_nonswapped);
+    _scratch.setTextStyle(style);
+    _scratch.setFont(font);
+
+    int32_t cw = _scratch.textWidth(string);
+    int32_t ch = _scratch.fontHeight();
+    int32_t w0 = std::max(cw, style.padding_x);
+    int32_t margin = std::max<int32_t>(8, ch);  // room for glyphs reaching outside their cell
+    int32_t sw = w0 + margin * 2;
+    int32_t sh = ch + margin * 2;
+    int32_t ax = margin + ((style.datum & textdatum_t::top_center) ? (w0 >> 1)
+                         : (style.datum & textdatum_t::top_right ) ? w0 : 0);
+    int32_t ay = margin + ((style.datum & (textdatum_t::middle_left | textdatum_t::bottom_left | textdatum_t::baseline_left)) ? ch : 0);
+
+    run_t* run = nullptr;
+    auto buf = (uint32_t*)_scratch.createSprite(sw, sh);
+    do
+    {
+      if (buf == nullptr) break;
+
+      for (int32_t i = 0; i < sw * sh; ++i) { buf[i] = unpainted; }
+      size_t advance = _scratch.drawString(string, ax, ay);
+
+      int32_t l = sw, r = -1, t = sh, b = -1;
+      for (int32_t y = 0; y < sh; ++y)
+      {
+        auto p = &buf[y * sw];
+        for (int32_t x = 0; x < sw; ++x)
+        {
+          if (!painted(p[x])) continue;
+          if (l > x) l = x;
+          if (r < x) r = x;
+          if (t > y) t = y;
+          b = y;
+        }
+      }
+      if (l == 0 || t == 0 || r == sw - 1 || b == sh - 1) break;  // may have been clipped
+
+      int32_t w = (r < l) ? 0 : r - l + 1;
+      int32_t h = (r < l) ? 0 : b - t + 1;
+      size_t bpp = dst_conv->bytes;
+      size_t slen = strlen(string) + 1;
+      size_t bytes = sizeof(run_t) + slen + w * h * bpp;
+      if (bytes > _budget) break;
+
+      while (_used + bytes > _budget) { drop(_tail); ++_stats.evictions; }
+      run = (run_t*)heap_alloc_psram(bytes);
+      if (run == nullptr) { run = (run_t*)heap_alloc(bytes); }
+      if (run == nullptr) break;
+      run->pixels = (uint8_t*)&run[1];
+      run->string = (char*)&run->pixels[w * h * bpp];
+
+      // Converts the painted pixels, noting which values each of their bytes takes:
+      // a value missing from one byte position makes a transparent key no painted pixel has.
+      uint8_t used[4][32] = {};
+      bool holes = false;
+      auto px = run->pixels;
+      for (int32_t y = t; y < t + h; ++y)
+      {
+        auto p = &buf[y * sw];
+        for (int32_t x = l; x < l + w; ++x, px += bpp)
+        {
+          if (!painted(p[x])) { holes = true; continue; }
+          uint32_t raw = dst_conv->convert(p[x]);
+          memcpy(px, &raw, bpp);
+          for (size_t i = 0; i < bpp; ++i)
+          {
+            uint8_t v = raw >> (i * 8);
+            used[i][v >> 3] |= 1 << (v & 7);
+          }
+        }
+      }
+      uint32_t transp = pixelcopy_t::NON_TRANSP;
+      for (size_t i = 0; holes && i < bpp && transp == pixelcopy_t::NON_TRANSP; ++i)
+      {
+        for (uint32_t v = 0; v < 256; ++v)
+        {
+          if (!(used[i][v >> 3] & (1 << (v & 7)))) { transp = v << (i * 8); break; }
+        }
+      }
+      if (holes && transp == pixelcopy_t::NON_TRANSP)
+      { // every raw value is painted somewhere
+        heap_free(run);
+        run = nullptr;
+        break;
+      }
+      if (holes)
+      {
+        px = run->pixels;
+        for (int32_t y = t; y < t + h; ++y)
+        {
+          auto p = &buf[y * sw];
+          for (int32_t x = l; x < l + w; ++x, px += bpp)
+          {
+            if (!painted(p[x])) { memcpy(px, &transp, bpp); }
+          }
+        }
+      }
+
+      run->hash = hash;
+      run->font = font;
+      run->style = style;
+      run->depth = depth;
+      run->dx = l - ax;
+      run->dy = t - ay;
+      run->w = w;
+      run->h = h;
+      run->transp = transp;
+      run->advance = advance;
+      run->bytes = bytes;
+      memcpy(run->string, string, slen);
+
+      run->prev = nullptr;
+      run->next = _head;
+      if (_head) { _head->prev = run; } else { _tail = run; }
+      _head = run;
+      _used += bytes;
+      ++_stats.misses;
+    } while (false);
+
+    _scratch.deleteSprite();
+    _scratch.setFont(&fonts::Font0);
+    return run;
+  }
+
+  size_t TextRunCache::drawString(LovyanGFX* dst, const char* string, int32_t x, int32_t y, const IFont* font)
+  {
+    if (font == nullptr) { font = dst->getFont(); }
+    auto& style = dst->getTextStyle();
+    auto depth = dst->getColorDepth();
+    auto type = font->getType();
+    bool blends = (style.fore_rgb888 == style.back_rgb888) && (type == IFont::ft_vlw || type == IFont::ft_ttf);
+    auto bits = depth & color_depth_t::bit_mask;
+    if (string == nullptr || blends || dst->hasPalette() || bits < 8 || bits > 24)
+    {
+      ++_stats.bypasses;
+      return dst->drawString(string, x, y, font);
+    }
+
+    uint32_t hash = 2166136261u;  // FNV-1a
+    for (auto p = (const uint8_t*)string; *p; ++p) { hash = (hash ^ *p) * 16777619u; }
+
+    auto run = find(hash, string, font, style, depth);
+    if (run)
+    {
+      ++_stats.hits;
+    }
+    else
+    {
+      run = render(dst, hash, string, font);
+      if (run == nullptr)
+      {
+        ++_stats.bypasses;
+        return dst->drawString(string, x, y, font);
+      }
+    }
+    if (run->w)
+    {
+      pixelcopy_t p(run->pixels, depth, run->depth, false, nullptr, run->transp);
+      dst->pushImage(x + run->dx, y + run->dy, run->w, run->h, &p);
+    }
+    return run->advance;
+  }
+
 //----------------------------------------------------------------------------
  }
 }
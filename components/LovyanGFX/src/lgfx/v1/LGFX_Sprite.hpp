@@ -79,6 +79,7 @@ namespace lgfx
     void setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye) override;
     void drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) override;
     void writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t raw_color) override;
+    void writeFillRectAlphaPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t argb8888) override;
     void writeBlock(uint32_t rawcolor, uint32_t len) override;
     void writePixels(pixelcopy_t* param, uint32_t len, bool use_dma) override;
     void writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool) override;
@@ -88,6 +89,7 @@ namespace lgfx
     void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) override;
 
     uint32_t readPixelValue(uint_fast16_t x, uint_fast16_t y);
+    bool readMatchRow(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint32_t rawcolor, uint32_t* bits);
 
   protected:
     void _rotate_pixelcopy(uint_fast16_t& x, uint_fast16_t& y, uint_fast16_t& w, uint_fast16_t& h, pixelcopy_t* param, uint32_t& nextx, uint32_t& nexty);
@@ -101,6 +103,60 @@ namespace lgfx
     uint_fast16_t _bitwidth;
   };
 
+//----------------------------------------------------------------------------
+
+  /// Completion token for LGFX_Sprite::pushSpriteAsync.
+  /// The sprite is sent in bands of rows. Each band is converted into one of two DMA buffers while the other one is being transferred.
+  /// poll() advances the transfer without blocking; the destination must not be drawn to, and the sprite must not be deleted, while busy().
+  class AsyncPush
+  {
+    friend LGFX_Sprite;
+  public:
+    AsyncPush(void) = default;
+    AsyncPush(const AsyncPush&) = delete;
+    AsyncPush& operator=(const AsyncPush&) = delete;
+    virtual ~AsyncPush(void) { finish(); release(); }
+
+    /// Band size in bytes. Up to 32KiB keeps every band within a single SPI DMA transaction.
+    void setBandSize(uint32_t bytes) { _band_size = bytes; }
+
+    /// Called from poll() once the last band has been sent.
+    void setCallback(void (*callback)(void* arg), void* arg = nullptr) { _callback = callback; _callback_arg = arg; }
+
+    bool busy(void) const { return _dst != nullptr; }
+
+    /// Converts the next band and starts it as soon as the bus is free.
+    /// @return true while the transfer is still in progress.
+    bool poll(void);
+
+    /// Blocks until the transfer is complete.
+    void finish(void) { while (poll()) {} }
+
+    /// Frees the band buffers. Ignored while busy().
+    void release(void);
+
+  private:
+    bool start(LovyanGFX* dst, int32_t x, int32_t y, int32_t w, int32_t h, const pixelcopy_t& pc);
+    void convert_band(void);
+    void send_band(void);
+
+    LovyanGFX* _dst = nullptr;
+    pixelcopy_t _pc;
+    uint8_t* _buffer[2] = { nullptr, nullptr };
+    uint32_t _buffer_len = 0;
+    uint32_t _band_size = 16384;
+    int32_t _src_x = 0;
+    int32_t _w = 0;
+    int32_t _band_rows = 0;
+    int32_t _rows_left = 0;   // rows not yet converted
+    int32_t _ready_rows = 0;  // rows converted into _buffer[_flip] and not yet sent
+    uint8_t _flip = 0;
+    void (*_callback)(void* arg) = nullptr;
+    void* _callback_arg = nullptr;
+  };
+
+//----------------------------------------------------------------------------
+
   class LGFX_Sprite : public LovyanGFX
   {
   public:
@@ -337,6 +393,12 @@ namespace lgfx
     LGFX_INLINE void pushSprite(                int32_t x, int32_t y) { push_sprite(_parent, x, y); }
     LGFX_INLINE void pushSprite(LovyanGFX* dst, int32_t x, int32_t y) { push_sprite(    dst, x, y); }
 
+    /// Starts an opaque pushSprite and returns without waiting for the transfer; see AsyncPush.
+    /// Transparent pushes and destinations below 8bpp or with a palette fall back to a blocking pushSprite.
+    /// @return true while the transfer is in progress, false if it has already completed.
+    LGFX_INLINE bool pushSpriteAsync(                int32_t x, int32_t y, AsyncPush* job) { return push_sprite_async(_parent, x, y, job); }
+    LGFX_INLINE bool pushSpriteAsync(LovyanGFX* dst, int32_t x, int32_t y, AsyncPush* job) { return push_sprite_async(    dst, x, y, job); }
+
     template<typename T> void pushRotated(                float angle, const T& transp) { push_rotate_zoom(_parent, _parent->getPivotX(), _parent->getPivotY(), angle, 1.0f, 1.0f, _write_conv.convert(transp) & _write_conv.colormask); }
     template<typename T> void pushRotated(LovyanGFX* dst, float angle, const T& transp) { push_rotate_zoom(dst    , dst    ->getPivotX(), dst    ->getPivotY(), angle, 1.0f, 1.0f, _write_conv.convert(transp) & _write_conv.colormask); }
                          void pushRotated(                float angle                 ) { push_rotate_zoom(_parent, _parent->getPivotX(), _parent->getPivotY(), angle, 1.0f, 1.0f); }
@@ -424,6 +486,8 @@ namespace lgfx
       dst->pushImage(x, y, _panel_sprite._panel_width, _panel_sprite._panel_height, &p, _panel_sprite.getSpriteBuffer()->use_dma()); // DMA disable with use SPIRAM
     }
 
+    bool push_sprite_async(LovyanGFX* dst, int32_t x, int32_t y, AsyncPush* job);
+
     void push_rotate_zoom(LovyanGFX* dst, float x, float y, float angle, float zoom_x, float zoom_y, uint32_t transp = pixelcopy_t::NON_TRANSP)
     {
       dst->pushImageRotateZoom(x, y, _xpivot, _ypivot, angle, zoom_x, zoom_y, _panel_sprite._panel_width, _panel_sprite._panel_height, _img, transp, getColorDepth(), _palette.img24());
@@ -445,6 +509,81 @@ namespace lgfx
     }
 
     RGBColor* getPalette_impl(void) const override { return _palette.img24(); }
+
+    bool readMatchRow_impl(int32_t x, int32_t y, int32_t w, uint32_t rawcolor, uint32_t* bits) override
+    {
+      return _panel_sprite.readMatchRow(x, y, w, rawcolor, bits);
+    }
+
+    // Writes into a buffer cost nothing per call, so rotations read the source in blocks.
+    int32_t affineTile_impl(void) const override { return 64; }
+  };
+
+//----------------------------------------------------------------------------
+
+  /// Draws strings from pre-rendered runs.
+  /// The first draw of a string in a given font, text style and colour depth renders it once into a scratch sprite;
+  /// later draws push the pixels that rendering painted with a single pushImage.
+  /// Runs least recently drawn are dropped to stay within the byte budget.
+  /// Strings in anti-aliased fonts over a transparent background blend with what is underneath, and are drawn directly,
+  /// as is everything on palette, sub-byte or 32-bit destinations (which have no transparent pixel copy).
+  class TextRunCache
+  {
+  public:
+    struct stats_t
+    {
+      uint32_t hits;
+      uint32_t misses;     // rendered and cached
+      uint32_t bypasses;   // drawn directly
+      uint32_t evictions;
+    };
+
+    TextRunCache(size_t budget = 16384) : _budget(budget) {}
+    TextRunCache(const TextRunCache&) = delete;
+    TextRunCache& operator=(const TextRunCache&) = delete;
+    virtual ~TextRunCache(void) { clear(); }
+
+    void setBudget(size_t bytes);
+    size_t getBudget(void) const { return _budget; }
+    size_t getUsed(void) const { return _used; }
+
+    /// Same as dst->drawString(string, x, y, font), using the text style of dst.
+    size_t drawString(LovyanGFX* dst, const char* string, int32_t x, int32_t y, const IFont* font = nullptr);
+
+    /// Drops every run; needed after unloading a font that runs were drawn with.
+    void clear(void);
+
+    const stats_t& getStats(void) const { return _stats; }
+    void resetStats(void) { _stats = {}; }
+
+  private:
+    struct run_t
+    {
+      run_t* prev;
+      run_t* next;
+      uint32_t hash;
+      const IFont* font;
+      TextStyle style;
+      color_depth_t depth;
+      int32_t dx, dy;       // from the draw position to the top left of the pixels
+      int32_t w, h;
+      uint32_t transp;      // raw value of the pixels the string does not paint
+      size_t advance;       // what drawString returns
+      size_t bytes;
+      char* string;
+      uint8_t* pixels;
+    };
+
+    run_t* find(uint32_t hash, const char* string, const IFont* font, const TextStyle& style, color_depth_t depth);
+    run_t* render(LovyanGFX* dst, uint32_t hash, const char* string, const IFont* font);
+    void drop(run_t* run);
+
+    LGFX_Sprite _scratch;
+    run_t* _head = nullptr;   // most recently drawn
+    run_t* _tail = nullptr;
+    size_t _budget;
+    size_t _used = 0;
+    stats_t _stats = {};
   };
 
 //----------------------------------------------------------------------------
@@ -12,6 +12,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 #include <math.h>
 #include "../internal/algorithm.h"
 
@@ -737,6 +738,7 @@ label_nextbyte: /// 次のデータを取得する;
   bool VLWfont::unloadFont(void)
   {
     _fontLoaded = false;
+    clearGlyphCache();
     if (gUnicode)  { heap_free(gUnicode);  gUnicode  = nullptr; }
     if (gWidth)    { heap_free(gWidth);    gWidth    = nullptr; }
     if (gxAdvance) { heap_free(gxAdvance); gxAdvance = nullptr; }
@@ -766,6 +768,10 @@ label_nextbyte: /// 次のデータを取得する;
         metrics->width     = gWidth[gNum];
         metrics->x_advance = gxAdvance[gNum];
         metrics->x_offset  = gdX[gNum];
+      } else if (auto glyph = getCachedGlyph(gNum)) {
+        metrics->width     = getSwap32(glyph->header[1]);
+        metrics->x_advance = getSwap32(glyph->header[2]);
+        metrics->x_offset  = (int32_t)((int8_t)getSwap32(glyph->header[4]));
       } else {
         auto file = _fontData;
 
@@ -790,6 +796,12 @@ label_nextbyte: /// 次のデータを取得する;
 
   bool VLWfont::loadFont(DataWrapper* data) {
     _fontData = data;
+    // The metrics are one sequential pass over the file; glyphs drawn later
+    // are read from it directly, as they jump between table and bitmap.
+    BufferedDataWrapper buffered;
+    if (_read_ahead && !data->isBuffered() && buffered.attach(data, _read_ahead)) {
+      data = &buffered;
+    }
     {
       uint32_t buf[6];
       data->read((uint8_t*)buf, 6 * 4); // 24 Byte read
@@ -840,10 +852,10 @@ label_nextbyte: /// 次のデータを取得する;
     _fontLoaded = true;
 
     size_t gNum = 0;
-    _fontData->seek(24);  // headerPtr
+    data->seek(24);  // headerPtr
     uint32_t buffer[7];
     do {
-      _fontData->read((uint8_t*)buffer, 7 * 4); // 28 Byte read
+      data->read((uint8_t*)buffer, 7 * 4); // 28 Byte read
       uint16_t unicode = getSwap32(buffer[0]); // Unicode code point value
       uint32_t w = (uint8_t)getSwap32(buffer[2]); // Width of glyph
       if (gUnicode)   gUnicode[gNum]  = unicode;
@@ -874,6 +886,127 @@ label_nextbyte: /// 次のデータを取得する;
     return true;
   }
 
+  void VLWfont::setGlyphCache(size_t bytes, bool psram)
+  {
+    _glyph_cache_size = bytes;
+    _glyph_cache_psram = psram;
+    if (bytes == 0)
+    {
+      clearGlyphCache();
+      return;
+    }
+    while (_glyph_cache_used > bytes) { dropGlyph(_glyph_tail); }
+  }
+
+  void VLWfont::clearGlyphCache(void)
+  {
+    while (_glyph_tail) { dropGlyph(_glyph_tail); }
+    if (_glyph_index) { heap_free(_glyph_index); _glyph_index = nullptr; }
+  }
+
+  void VLWfont::dropGlyph(glyph_cache_t* glyph) const
+  {
+    if (glyph->prev) { glyph->prev->next = glyph->next; } else { _glyph_head = glyph->next; }
+    if (glyph->next) { glyph->next->prev = glyph->prev; } else { _glyph_tail = glyph->prev; }
+    _glyph_index[glyph->gNum] = nullptr;
+    _glyph_cache_used -= sizeof(glyph_cache_t) + getSwap32(glyph->header[0]) * getSwap32(glyph->header[1]);
+    heap_free(glyph);
+  }
+
+  const VLWfont::glyph_cache_t* VLWfont::getCachedGlyph(uint16_t gNum) const
+  {
+    if (!_glyph_cache_size || !_fontLoaded) return nullptr;
+    if (_glyph_index == nullptr)
+    {
+      _glyph_index = (glyph_cache_t**)heap_alloc(gCount * sizeof(glyph_cache_t*));
+      if (_glyph_index == nullptr) return nullptr;
+      memset(_glyph_index, 0, gCount * sizeof(glyph_cache_t*));
+    }
+
+    auto glyph = _glyph_index[gNum];
+    if (glyph == nullptr)
+    {
+      auto file = _fontData;
+      uint32_t header[6];
+      file->preRead();
+      file->seek(28 + gNum * 28);
+      file->read((uint8_t*)header, 24);
+      size_t len = getSwap32(header[0]) * getSwap32(header[1]);
+      size_t bytes = sizeof(glyph_cache_t) + len;
+      if (bytes > _glyph_cache_size)
+      {
+        file->postRead();
+        return nullptr;
+      }
+      while (_glyph_cache_used + bytes > _glyph_cache_size) { dropGlyph(_glyph_tail); }
+
+      glyph = (glyph_cache_t*)(_glyph_cache_psram ? heap_alloc_psram(bytes) : nullptr);
+      if (glyph == nullptr) { glyph = (glyph_cache_t*)heap_alloc(bytes); }
+      if (glyph == nullptr)
+      {
+        file->postRead();
+        return nullptr;
+      }
+      file->seek(gBitmap[gNum]);
+      file->read(glyph->bitmap, len);
+      file->postRead();
+
+      memcpy(glyph->header, header, sizeof(header));
+      glyph->gNum = gNum;
+      glyph->prev = nullptr;
+      glyph->next = nullptr;
+      _glyph_index[gNum] = glyph;
+      _glyph_cache_used += bytes;
+    }
+    else if (glyph != _glyph_head)
+    { // unlink, to be put back in front
+      glyph->prev->next = glyph->next;
+      if (glyph->next) { glyph->next->prev = glyph->prev; } else { _glyph_tail = glyph->prev; }
+    }
+    else
+    {
+      return glyph;
+    }
+
+    glyph->prev = nullptr;
+    glyph->next = _glyph_head;
+    if (_glyph_head) { _glyph_head->prev = glyph; } else { _glyph_tail = glyph; }
+    _glyph_head = glyph;
+    return glyph;
+  }
+
+  size_t VLWfont::prewarmGlyphs(const char* utf8)
+  {
+    size_t count = 0;
+    auto s = (const uint8_t*)utf8;
+    while (*s)
+    {
+      uint16_t code = *s++;
+      if (code >= 0x80)
+      { // 2 and 3 byte sequences, as LGFXBase::decodeUTF8 takes them
+        if (code < 0xC0 || code >= 0xF0) continue;
+        size_t more = (code >= 0xE0) ? 2 : 1;
+        code &= (more == 2) ? 0x0F : 0x1F;
+        for (; more && (*s & 0xC0) == 0x80; --more) { code = (code << 6) | (*s++ & 0x3F); }
+        if (more) continue;
+      }
+      uint16_t gNum;
+      if (code != 0x20 && getUnicodeIndex(code, &gNum) && getCachedGlyph(gNum)) { ++count; }
+    }
+    return count;
+  }
+
+  size_t VLWfont::prewarmGlyphs(uint16_t first, uint16_t last)
+  {
+    size_t count = 0;
+    for (uint32_t code = first; code <= last; ++code)
+    {
+      uint16_t gNum;
+      if (code != 0x20 && getUnicodeIndex(code, &gNum) && getCachedGlyph(gNum)) { ++count; }
+    }
+    return count;
+  }
+
 //----------------------------------------------------------------------------
 
   size_t VLWfont::drawChar(LGFXBase* gfx, int32_t x, int32_t y, uint16_t code, const TextStyle* style, FontMetrics* metrics, int32_t& filled_x) const
@@ -882,6 +1015,7 @@ label_nextbyte: /// 次のデータを取得する;
 
     uint32_t buffer[6] = {0};
     uint16_t gNum = 0;
+    const uint8_t* pixel = nullptr;
 
     int32_t sy = 65536 * style->size_y;
     y += (metrics->y_offset * sy) >> 16;
@@ -891,6 +1025,9 @@ label_nextbyte: /// 次のデータを取得する;
       buffer[2] = getSwap32(this->spaceWidth);
     } else if (!this->getUnicodeIndex(code, &gNum)) {
       return drawCharDummy(gfx, x, y, this->spaceWidth, metrics->height, style, filled_x);
+    } else if (auto glyph = this->getCachedGlyph(gNum)) {
+      memcpy(buffer, glyph->header, sizeof(buffer));
+      pixel = glyph->bitmap;
     } else {
       file->preRead();
       file->seek(28 + gNum * 28);
@@ -908,10 +1045,17 @@ label_nextbyte: /// 次のデータを取得する;
     int32_t yoffset  = (this->maxAscent - dY);
 //      int32_t yoffset = (gfx->_font_metrics.y_offset) - dY;
 
-    auto pixel = (uint8_t*)alloca(w * h);
-    if (gNum != 0xFFFF) {
-      file->read(pixel, w * h);
-      file->postRead();
+    if (pixel == nullptr) {
+      if (gNum != 0xFFFF && (pixel = file->peek(w * h))) {
+        file->postRead();  // font in memory: draw the bitmap in place
+      } else {
+        auto bitmap = (uint8_t*)alloca(w * h);
+        if (gNum != 0xFFFF) {
+          file->read(bitmap, w * h);
+          file->postRead();
+        }
+        pixel = bitmap;
+      }
     }
 
     gfx->startWrite();
@@ -256,6 +256,43 @@ namespace lgfx
     bool updateFontMetric(FontMetrics *metrics, uint16_t uniCode) const override;
 
     bool getUnicodeIndex(uint16_t unicode, uint16_t *index) const;
+
+    /// Keep up to `bytes` of decoded glyphs (header and alpha bitmap) in memory,
+    /// least recently drawn dropped first, so redrawn text does not read the file.
+    /// 0 disables the cache.
+    void setGlyphCache(size_t bytes, bool psram = true);
+
+    /// Load the glyphs of a UTF-8 string, or of a code point range, into the cache.
+    /// Returns how many of its characters were found in the font and cached.
+    size_t prewarmGlyphs(const char* utf8);
+    size_t prewarmGlyphs(uint16_t first, uint16_t last);
+
+    void clearGlyphCache(void);
+
+    /// Read the glyph metrics through a `bytes` read-ahead window when the
+    /// next font loaded is not already in memory. 0 reads the file directly.
+    void setReadAhead(uint32_t bytes) { _read_ahead = bytes; }
+
+  private:
+    struct glyph_cache_t
+    {
+      glyph_cache_t* prev;
+      glyph_cache_t* next;
+      uint16_t gNum;
+      uint32_t header[6];  // as stored in the file: height, width, xAdvance, dY, dX, padding
+      uint8_t  bitmap[1];
+    };
+
+    const glyph_cache_t* getCachedGlyph(uint16_t gNum) const;
+    void dropGlyph(glyph_cache_t* glyph) const;
+
+    mutable glyph_cache_t** _glyph_index = nullptr;  // gCount entries
+    mutable glyph_cache_t* _glyph_head = nullptr;    // most recently used
+    mutable glyph_cache_t* _glyph_tail = nullptr;
+    mutable size_t _glyph_cache_used = 0;
+    size_t _glyph_cache_size = 0;
+    bool _glyph_cache_psram = true;
+    uint32_t _read_ahead = 0;
   };
 
 //----------------------------------------------------------------------------
@@ -0,0 +1,188 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [BSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#include "DataWrapper.hpp"
+#include "../platforms/common.hpp"
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  bool BufferedDataWrapper::attach(DataWrapper* src, uint32_t size)
+  {
+    detach();
+    if (src == nullptr || size == 0) { return false; }
+    _buf = (uint8_t*)heap_alloc(size);
+    if (_buf == nullptr) { return false; }
+    _src = src;
+    _size = size;
+    _base = src->tell();
+    _pos = _len = 0;
+    parent = src->parent;
+    return true;
+  }
+
+  void BufferedDataWrapper::detach(void)
+  {
+    if (_src && _pos < _len)
+    {
+      _src->preRead();
+      _src->seek(_base + _pos);
+      _src->postRead();
+    }
+    if (_buf) { heap_free(_buf); }
+    _buf = nullptr;
+    _src = nullptr;
+    _size = _base = _pos = _len = 0;
+    parent = nullptr;
+  }
+
+  // Moves what is left to the front and reads at least `required` more bytes
+  // if the source has them, as many as fit if it has them at hand.
+  uint32_t BufferedDataWrapper::fill(uint32_t required)
+  {
+    if (_pos)
+    {
+      memmove(_buf, &_buf[_pos], _len - _pos);
+      _base += _pos;
+      _len -= _pos;
+      _pos = 0;
+    }
+    uint32_t room = _size - _len;
+    if (room == 0) { return 0; }
+    if (required > room) { required = room; }
+    if (required == 0) { required = 1; }
+    _src->preRead();
+    int res = _src->read(&_buf[_len], room, required);
+    _src->postRead();
+    if (res <= 0) { return 0; }
+    _len += res;
+    return res;
+  }
+
+  bool BufferedDataWrapper::open(const char* path)
+  {
+    if (_src == nullptr) { return false; }
+    _src->preRead();
+    bool res = _src->open(path);
+    _src->postRead();
+    _base = res ? _src->tell() : 0;
+    _pos = _len = 0;
+    return res;
+  }
+
+  // Fills the request as a file read would, stopping short only where the
+  // source does, once `required_len` bytes are in.
+  int BufferedDataWrapper::read(uint8_t *buf, uint32_t maximum_len, uint32_t required_len)
+  {
+    if (_src == nullptr) { return 0; }
+    uint32_t done = 0;
+    bool short_fill = false;
+    for (;;)
+    {
+      uint32_t len = _len - _pos;
+      if (len > maximum_len - done) { len = maximum_len - done; }
+      memcpy(&buf[done], &_buf[_pos], len);
+      _pos += len;
+      done += len;
+      if (done == maximum_len || (short_fill && done >= required_len)) { break; }
+
+      uint32_t rest = maximum_len - done;
+      uint32_t need = required_len > done ? required_len - done : 1;
+      if (rest >= _size)
+      { // The window is empty and would not hold the rest; skip the copy.
+        drop();
+        _src->preRead();
+        int res = _src->read(&buf[done], rest, need);
+        _src->postRead();
+        if (res > 0)
+        {
+          _base += res;
+          done += res;
+        }
+        break;
+      }
+      if (!fill(need)) { break; }
+      short_fill = _len < _size;
+    }
+    return done;
+  }
+
+  void BufferedDataWrapper::skip(int32_t offset)
+  {
+    if (offset >= 0 ? (uint32_t)offset <= _len - _pos : (uint32_t)-offset <= _pos)
+    {
+      _pos += offset;
+      return;
+    }
+    if (offset < 0)
+    {
+      seek(tell() + offset);
+      return;
+    }
+    uint32_t ahead = offset - (_len - _pos);
+    drop();
+    _src->preRead();
+    _src->skip(ahead);
+    _src->postRead();
+    _base += ahead;
+  }
+
+  bool BufferedDataWrapper::seek(uint32_t offset)
+  {
+    if (offset >= _base && offset <= _base + _len)
+    {
+      _pos = offset - _base;
+      return true;
+    }
+    if (_src == nullptr) { return false; }
+    // Not every source reports seek() the same way; tell() says where it went.
+    _src->preRead();
+    _src->seek(offset);
+    _src->postRead();
+    _base = _src->tell();
+    _pos = _len = 0;
+    return _base == offset;
+  }
+
+  void BufferedDataWrapper::close(void)
+  {
+    if (_src)
+    {
+      _src->preRead();
+      _src->close();
+      _src->postRead();
+    }
+    _pos = _len = 0;
+    detach();
+  }
+
+  const uint8_t* BufferedDataWrapper::peek(uint32_t len)
+  {
+    if (_src == nullptr || len > _size) { return nullptr; }
+    while (_len - _pos < len)
+    {
+      if (!fill(len - (_len - _pos))) { return nullptr; }
+    }
+    return &_buf[_pos];
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
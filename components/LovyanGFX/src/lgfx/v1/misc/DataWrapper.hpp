@@ -26,6 +26,11 @@ Contributors:
 #include <string.h>
 #include "../../utility/pgmspace.h"
 
+#if defined (__linux__)
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+#endif
+
 namespace lgfx
 {
  inline namespace v1
@@ -76,6 +81,14 @@ namespace lgfx
     virtual void close(void) = 0;
     virtual int32_t tell(void) = 0;
 
+    /// Returns the next `len` bytes in place without consuming them, or nullptr
+    /// when they cannot be reached without a copy. The pointer stays valid
+    /// until the next read, peek, seek or skip.
+    virtual const uint8_t* peek(uint32_t len) { (void)len; return nullptr; }
+
+    /// True when reads are served from memory, so buffering them gains nothing.
+    virtual bool isBuffered(void) const { return false; }
+
     LGFX_INLINE void preRead(void) { if (fp_pre_read) fp_pre_read(parent); }
     LGFX_INLINE void postRead(void) { if (fp_post_read) fp_post_read(parent); }
     LGFX_INLINE bool hasParent(void) const { return parent; }
@@ -131,11 +144,76 @@ namespace lgfx
     FILE* _fp;
   };
 
+#if defined (__linux__)
+  /// Maps the whole file into memory, so reads are a memcpy and peek() reaches
+  /// any byte. Falls back to stdio reads when the file cannot be mapped.
+  struct MappedFileWrapper : public DataWrapperT<FILE>
+  {
+    MappedFileWrapper(FILE* fp = nullptr) : DataWrapperT<FILE>(fp) { map(); }
+    virtual ~MappedFileWrapper(void) { unmap(); }
+
+    bool open(const char* path) override
+    {
+      unmap();
+      if (!DataWrapperT<FILE>::open(path)) { return false; }
+      map();
+      return true;
+    }
+    int read(uint8_t *buf, uint32_t len) override
+    {
+      if (!_map) { return DataWrapperT<FILE>::read(buf, len); }
+      if (len > _length - _index) { len = _length - _index; }
+      memcpy(buf, &_map[_index], len);
+      _index += len;
+      return len;
+    }
+    void skip(int32_t offset) override { if (_map) { seek(_index + offset); } else { DataWrapperT<FILE>::skip(offset); } }
+    bool seek(uint32_t offset) override
+    {
+      if (!_map) { return DataWrapperT<FILE>::seek(offset); }
+      _index = offset < _length ? offset : _length;
+      return true;
+    }
+    using DataWrapperT<FILE>::seek;
+    void close(void) override { unmap(); DataWrapperT<FILE>::close(); }
+    int32_t tell(void) override { return _map ? _index : DataWrapperT<FILE>::tell(); }
+    const uint8_t* peek(uint32_t len) override { return (_map && len <= _length - _index) ? &_map[_index] : nullptr; }
+    bool isBuffered(void) const override { return _map; }
+
+  protected:
+    void map(void)
+    {
+      struct stat st;
+      if (!_fp || fstat(fileno(_fp), &st) || st.st_size <= 0) { return; }
+      void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fileno(_fp), 0);
+      if (addr == MAP_FAILED) { return; }
+      _map = (const uint8_t*)addr;
+      _length = st.st_size;
+      _index = ftell(_fp);
+    }
+    void unmap(void)
+    {
+      if (_map) { munmap((void*)_map, _length); }
+      _map = nullptr;
+    }
+
+    const uint8_t* _map = nullptr;
+    uint32_t _length = 0;
+    uint32_t _index = 0;
+  };
+
+  template <>
+  struct DataWrapperT<void> : public MappedFileWrapper
+  {
+    DataWrapperT(void) : MappedFileWrapper() {}
+  };
+#else
   template <>
   struct DataWrapperT<void> : public DataWrapperT<FILE>
   {
     DataWrapperT(void) : DataWrapperT<FILE>() {}
   };
+#endif
 #else
   template <>
   struct DataWrapperT<void> : public DataWrapper
@@ -167,6 +245,12 @@ namespace lgfx
     bool seek(uint32_t offset) override { _index = offset; return true; }
     void close(void) override { }
     int32_t tell(void) override { return _index; }
+#if defined (ESP8266) || defined (__AVR__)
+    // PROGMEM here is not byte addressable; reads go through memcpy_P
+#else
+    const uint8_t* peek(uint32_t len) override { return (len <= _length - _index) ? &_ptr[_index] : nullptr; }
+    bool isBuffered(void) const override { return true; }
+#endif
 
   protected:
     const uint8_t* _ptr;
@@ -174,6 +258,55 @@ namespace lgfx
     uint32_t _length;
   };
 
+//----------------------------------------------------------------------------
+
+  /// Reads another DataWrapper through a read-ahead window, so small reads
+  /// such as read8() or a decoder's input requests are served from memory.
+  /// The source is only touched when the window runs dry, and its bus
+  /// transaction is released around that read alone; preRead() and postRead()
+  /// on this wrapper do nothing.
+  struct BufferedDataWrapper : public DataWrapper
+  {
+    static constexpr uint32_t default_size = 2048;
+
+    BufferedDataWrapper(void) = default;
+    BufferedDataWrapper(DataWrapper* src, uint32_t size = default_size) { attach(src, size); }
+    virtual ~BufferedDataWrapper(void) { detach(); }
+
+    /// Reads `src` from its current position through a `size` byte window.
+    /// Returns false, leaving nothing attached, if the window cannot be allocated.
+    bool attach(DataWrapper* src, uint32_t size = default_size);
+
+    /// Frees the window and moves the source back to the position read up to,
+    /// where it can seek back.
+    void detach(void);
+
+    DataWrapper* source(void) const { return _src; }
+
+    bool open(const char* path) override;
+    int read(uint8_t *buf, uint32_t len) override { return read(buf, len, len); }
+    int read(uint8_t *buf, uint32_t maximum_len, uint32_t required_len) override;
+    void skip(int32_t offset) override;
+    bool seek(uint32_t offset) override;
+    void close(void) override;
+    int32_t tell(void) override { return _base + _pos; }
+
+    /// Up to the window size; refills the window as needed.
+    const uint8_t* peek(uint32_t len) override;
+    bool isBuffered(void) const override { return true; }
+
+  protected:
+    uint32_t fill(uint32_t required);
+    void drop(void) { _base += _len; _pos = _len = 0; }
+
+    DataWrapper* _src = nullptr;
+    uint8_t* _buf = nullptr;
+    uint32_t _size = 0;
+    uint32_t _base = 0;  // source position of _buf[0]
+    uint32_t _pos = 0;   // next byte handed out
+    uint32_t _len = 0;   // bytes held in _buf
+  };
+
 //----------------------------------------------------------------------------
 
 #if defined (SdFat_h) || defined (SD_FAT_VERSION)
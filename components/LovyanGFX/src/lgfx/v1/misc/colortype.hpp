@@ -718,6 +718,8 @@ namespace lgfx
       case rgb332_1Byte  : return no_convert;
       case grayscale_8bit: return color_convert<grayscale_t, rgb332_t>;
       case rgb565_nonswapped: return color_convert<rgb565_t , rgb332_t>;
+      case rgb888_nonswapped: return color_convert<rgb888_t , rgb332_t>;
+      case argb8888_nonswapped: return color_convert<argb8888_t, rgb332_t>;
       default: break;
       }
     } else if (std::is_same<TSrc, rgb888_t>::value || std::is_same<TSrc, uint32_t>::value) {
@@ -729,6 +731,8 @@ namespace lgfx
       case rgb332_1Byte  : return color_convert<rgb332_t  , rgb888_t>;
       case grayscale_8bit: return color_convert<grayscale_t,rgb888_t>;
       case rgb565_nonswapped: return color_convert<rgb565_t , rgb888_t>;
+      case rgb888_nonswapped: return no_convert;
+      case argb8888_nonswapped: return color_convert<argb8888_t, rgb888_t>;
       default: break;
       }
     } else if (std::is_same<TSrc, argb8888_t>::value) {
@@ -740,6 +744,8 @@ namespace lgfx
       case rgb332_1Byte  : return color_convert<rgb332_t , rgb888_t>;
       case grayscale_8bit: return color_convert<grayscale_t,rgb888_t>;
       case rgb565_nonswapped: return color_convert<rgb565_t , rgb888_t>;
+      case rgb888_nonswapped: return color_convert<rgb888_t , argb8888_t>;
+      case argb8888_nonswapped: return no_convert;
       default: break;
       }
     } else if (std::is_same<TSrc, bgr888_t>::value) {
@@ -751,6 +757,8 @@ namespace lgfx
       case rgb332_1Byte  : return color_convert<rgb332_t  , bgr888_t>;
       case grayscale_8bit: return color_convert<grayscale_t,bgr888_t>;
       case rgb565_nonswapped: return color_convert<rgb565_t , bgr888_t>;
+      case rgb888_nonswapped: return color_convert<rgb888_t , bgr888_t>;
+      case argb8888_nonswapped: return color_convert<argb8888_t, bgr888_t>;
       default: break;
       }
     } else { // if (std::is_same<TSrc, rgb565_t>::value || std::is_same<TSrc, uint16_t>::value || std::is_same<TSrc, int>::value)
@@ -762,6 +770,8 @@ namespace lgfx
       case rgb332_1Byte  : return color_convert<rgb332_t  , rgb565_t>;
       case grayscale_8bit: return color_convert<grayscale_t,rgb565_t>;
       case rgb565_nonswapped: return no_convert;
+      case rgb888_nonswapped: return color_convert<rgb888_t , rgb565_t>;
+      case argb8888_nonswapped: return color_convert<argb8888_t, rgb565_t>;
       default: break;
       }
     }
@@ -847,6 +857,7 @@ namespace lgfx
       case rgb332_1Byte:      revert_rgb888 = color_convert<rgb888_t, rgb332_t   >; break;
       case grayscale_8bit:    revert_rgb888 = color_convert<rgb888_t, grayscale_t>; break;
       case rgb565_nonswapped: revert_rgb888 = color_convert<rgb888_t, rgb565_t   >; break;
+      case argb8888_nonswapped: revert_rgb888 = color_convert<rgb888_t, argb8888_t>; break;
       default:                revert_rgb888 = no_convert;
       }
     }
@@ -18,6 +18,14 @@ Contributors:
 
 #include "pixelcopy.hpp"
 
+#if LGFX_PIXELCOPY_RUN_KERNELS
+ #if defined ( __SSE2__ )
+  #include <emmintrin.h>
+ #elif defined ( __ARM_NEON )
+  #include <arm_neon.h>
+ #endif
+#endif
+
 namespace lgfx
 {
   inline namespace v1
@@ -56,19 +64,28 @@ namespace lgfx
         if (src_bits > 16) {
           if (src_bits > 24) {
             fp_skip = pixelcopy_t::skip_rgb_affine<bgra8888_t>;
-            fp_copy = pixelcopy_t::get_fp_copy_rgb_affine<bgra8888_t>(dst_depth);
+            if (src_depth == argb8888_nonswapped) {
+              fp_copy = pixelcopy_t::get_fp_copy_rgb_affine<argb8888_t>(dst_depth);
+            } else {
+              fp_copy = pixelcopy_t::get_fp_copy_rgb_affine<bgra8888_t>(dst_depth);
+            }
           } else {
             fp_skip = pixelcopy_t::skip_rgb_affine<bgr888_t>;
             if (src_depth == rgb888_3Byte) {
               fp_copy = pixelcopy_t::get_fp_copy_rgb_affine<bgr888_t>(dst_depth);
             } else if (src_depth == rgb666_3Byte) {
               fp_copy = pixelcopy_t::get_fp_copy_rgb_affine<bgr666_t>(dst_depth);
+            } else if (src_depth == rgb888_nonswapped) {
+              fp_copy = pixelcopy_t::get_fp_copy_rgb_affine<rgb888_t>(dst_depth);
             }
           }
         } else {
           if (src_depth == rgb565_2Byte) {
             fp_copy = pixelcopy_t::get_fp_copy_rgb_affine<swap565_t>(dst_depth);
             fp_skip = pixelcopy_t::skip_rgb_affine<swap565_t>;
+          } else if (src_depth == rgb565_nonswapped) {
+            fp_copy = pixelcopy_t::get_fp_copy_rgb_affine<rgb565_t>(dst_depth);
+            fp_skip = pixelcopy_t::skip_rgb_affine<rgb565_t>;
           } else if (src_depth == rgb332_1Byte) {
             fp_copy = pixelcopy_t::get_fp_copy_rgb_affine<rgb332_t >(dst_depth);
             fp_skip = pixelcopy_t::skip_rgb_affine<rgb332_t>;
@@ -262,6 +279,223 @@ namespace lgfx
       return index;
     }
 
+//----------------------------------------------------------------------------
+
+#if LGFX_PIXELCOPY_RUN_KERNELS
+
+// Run kernels for the conversions into and out of the panels' native swap565.
+// SIMD where the host has it; otherwise two pixels per aligned 32-bit store,
+// which is also all that Xtensa allows without unaligned access faults.
+// Each gives exactly what color_convert gives for the same pair.
+
+    static inline uint32_t swap565_from_gray(uint32_t l)
+    {
+      uint32_t rb = l >> 3;
+      return ((((l & 0x1C) << 3) | rb) << 8) | (rb << 3) | (l >> 5);
+    }
+
+    static inline uint32_t swap565_from_rgb332(uint32_t c)
+    {
+      uint32_t r = (c >> 5) & 7;
+      uint32_t g = (c >> 2) & 7;
+      uint32_t b = c & 3;
+      r = (r << 2) | (r >> 1);
+      b = (b << 3) | (b << 1) | (b >> 1);
+      return (((g << 5) | b) << 8) | (r << 3) | g;
+    }
+
+    static inline uint32_t swap565_from_rgb(uint32_t r, uint32_t g, uint32_t b)
+    {
+      return ((((g << 3) & 0xE0) | (b >> 3)) << 8) | (r & 0xF8) | (g >> 5);
+    }
+
+    // Stores the single pixels needed to reach 4-byte alignment and any odd
+    // tail; the caller's loop does the aligned pairs in between.
+    template <typename TFunc>
+    static void store_swap565_pairs(uint16_t* d, uint32_t len, TFunc&& pixel)
+    {
+      uint32_t i = 0;
+      if ((uintptr_t)d & 2)
+      {
+        d[0] = pixel(0);
+        i = 1;
+      }
+      auto d32 = reinterpret_cast<uint32_t*>(&d[i]);
+      for (; i + 1 < len; i += 2)
+      {
+        *d32++ = pixel(i) | pixel(i + 1) << 16;
+      }
+      if (i < len) { d[i] = pixel(i); }
+    }
+
+    static void swap16_run(uint16_t* __restrict d, const uint16_t* __restrict s, uint32_t len)
+    {
+#if defined ( __SSE2__ )
+      for (; len >= 8; len -= 8, d += 8, s += 8)
+      {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8)));
+      }
+#elif defined ( __ARM_NEON )
+      for (; len >= 8; len -= 8, d += 8, s += 8)
+      {
+        vst1q_u8(reinterpret_cast<uint8_t*>(d), vrev16q_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(s))));
+      }
+#else
+      if (len > 1 && (((uintptr_t)d ^ (uintptr_t)s) & 2) == 0)
+      {
+        if ((uintptr_t)d & 2)
+        {
+          *d++ = getSwap16(*s++);
+          --len;
+        }
+        auto d32 = reinterpret_cast<uint32_t*>(d);
+        auto s32 = reinterpret_cast<const uint32_t*>(s);
+        for (; len >= 2; len -= 2)
+        {
+          uint32_t v = *s32++;
+          *d32++ = ((v << 8) & 0xFF00FF00u) | ((v >> 8) & 0x00FF00FFu);
+        }
+        d = reinterpret_cast<uint16_t*>(d32);
+        s = reinterpret_cast<const uint16_t*>(s32);
+      }
+#endif
+      while (len--) { *d++ = getSwap16(*s++); }
+    }
+
+    template <> void pixelcopy_t::convert_run<swap565_t, rgb565_t>(swap565_t* __restrict d, const rgb565_t* __restrict s, uint32_t len)
+    {
+      swap16_run(reinterpret_cast<uint16_t*>(d), reinterpret_cast<const uint16_t*>(s), len);
+    }
+
+    template <> void pixelcopy_t::convert_run<rgb565_t, swap565_t>(rgb565_t* __restrict d, const swap565_t* __restrict s, uint32_t len)
+    {
+      swap16_run(reinterpret_cast<uint16_t*>(d), reinterpret_cast<const uint16_t*>(s), len);
+    }
+
+    // `RIdx`/`BIdx` are the byte offsets of red and blue within a source pixel.
+    template <int RIdx, int BIdx>
+    static void swap565_from_24bit_run(uint16_t* __restrict d, const uint8_t* __restrict s, uint32_t len)
+    {
+#if defined ( __ARM_NEON )
+      for (; len >= 16; len -= 16, d += 16, s += 48)
+      {
+        uint8x16x3_t px = vld3q_u8(s);
+        uint8x16_t r = px.val[RIdx];
+        uint8x16_t g = px.val[1];
+        uint8x16_t b = px.val[BIdx];
+        uint8x16x2_t out;
+        out.val[0] = vorrq_u8(vandq_u8(r, vdupq_n_u8(0xF8)), vshrq_n_u8(g, 5));
+        out.val[1] = vorrq_u8(vandq_u8(vshlq_n_u8(g, 3), vdupq_n_u8(0xE0)), vshrq_n_u8(b, 3));
+        vst2q_u8(reinterpret_cast<uint8_t*>(d), out);
+      }
+      if (len == 0) return;
+#elif defined ( __SSE2__ )
+      // left plain so the compiler vectorises it
+      uint32_t i = 0;
+      do { d[i] = swap565_from_rgb(s[i * 3 + RIdx], s[i * 3 + 1], s[i * 3 + BIdx]); } while (++i < len);
+      return;
+#endif
+      store_swap565_pairs(d, len, [s](uint32_t i)
+      {
+        auto p = &s[i * 3];
+        return swap565_from_rgb(p[RIdx], p[1], p[BIdx]);
+      });
+    }
+
+    template <> void pixelcopy_t::convert_run<swap565_t, bgr888_t>(swap565_t* __restrict d, const bgr888_t* __restrict s, uint32_t len)
+    {
+      swap565_from_24bit_run<0, 2>(reinterpret_cast<uint16_t*>(d), reinterpret_cast<const uint8_t*>(s), len);
+    }
+
+    template <> void pixelcopy_t::convert_run<swap565_t, rgb888_t>(swap565_t* __restrict d, const rgb888_t* __restrict s, uint32_t len)
+    {
+      swap565_from_24bit_run<2, 0>(reinterpret_cast<uint16_t*>(d), reinterpret_cast<const uint8_t*>(s), len);
+    }
+
+    template <> void pixelcopy_t::convert_run<swap565_t, rgb332_t>(swap565_t* __restrict dst, const rgb332_t* __restrict src, uint32_t len)
+    {
+      auto d = reinterpret_cast<uint16_t*>(dst);
+      auto s = reinterpret_cast<const uint8_t*>(src);
+#if defined ( __SSE2__ )
+      auto zero = _mm_setzero_si128();
+      auto m7 = _mm_set1_epi16(7);
+      auto m3 = _mm_set1_epi16(3);
+      auto conv = [&](__m128i c)
+      {
+        __m128i r = _mm_and_si128(_mm_srli_epi16(c, 5), m7);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(c, 2), m7);
+        __m128i b = _mm_and_si128(c, m3);
+        r = _mm_or_si128(_mm_slli_epi16(r, 2), _mm_srli_epi16(r, 1));
+        b = _mm_or_si128(_mm_or_si128(_mm_slli_epi16(b, 3), _mm_slli_epi16(b, 1)), _mm_srli_epi16(b, 1));
+        __m128i hi = _mm_or_si128(_mm_slli_epi16(g, 5), b);
+        __m128i lo = _mm_or_si128(_mm_slli_epi16(r, 3), g);
+        return _mm_or_si128(_mm_slli_epi16(hi, 8), lo);
+      };
+      for (; len >= 16; len -= 16, d += 16, s += 16)
+      {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d    ), conv(_mm_unpacklo_epi8(v, zero)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 8), conv(_mm_unpackhi_epi8(v, zero)));
+      }
+      if (len == 0) return;
+#elif defined ( __ARM_NEON )
+      for (; len >= 16; len -= 16, d += 16, s += 16)
+      {
+        uint8x16_t c = vld1q_u8(s);
+        uint8x16_t r = vandq_u8(vshrq_n_u8(c, 5), vdupq_n_u8(7));
+        uint8x16_t g = vandq_u8(vshrq_n_u8(c, 2), vdupq_n_u8(7));
+        uint8x16_t b = vandq_u8(c, vdupq_n_u8(3));
+        r = vorrq_u8(vshlq_n_u8(r, 2), vshrq_n_u8(r, 1));
+        b = vorrq_u8(vorrq_u8(vshlq_n_u8(b, 3), vshlq_n_u8(b, 1)), vshrq_n_u8(b, 1));
+        uint8x16x2_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(r, 3), g);
+        out.val[1] = vorrq_u8(vshlq_n_u8(g, 5), b);
+        vst2q_u8(reinterpret_cast<uint8_t*>(d), out);
+      }
+      if (len == 0) return;
+#endif
+      store_swap565_pairs(d, len, [s](uint32_t i) { return swap565_from_rgb332(s[i]); });
+    }
+
+    template <> void pixelcopy_t::convert_run<swap565_t, grayscale_t>(swap565_t* __restrict dst, const grayscale_t* __restrict src, uint32_t len)
+    {
+      auto d = reinterpret_cast<uint16_t*>(dst);
+      auto s = reinterpret_cast<const uint8_t*>(src);
+#if defined ( __SSE2__ )
+      auto zero = _mm_setzero_si128();
+      auto m1c = _mm_set1_epi16(0x1C);
+      auto conv = [&](__m128i l)
+      {
+        __m128i rb = _mm_srli_epi16(l, 3);
+        __m128i hi = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(l, m1c), 3), rb);
+        __m128i lo = _mm_or_si128(_mm_slli_epi16(rb, 3), _mm_srli_epi16(l, 5));
+        return _mm_or_si128(_mm_slli_epi16(hi, 8), lo);
+      };
+      for (; len >= 16; len -= 16, d += 16, s += 16)
+      {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d    ), conv(_mm_unpacklo_epi8(v, zero)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + 8), conv(_mm_unpackhi_epi8(v, zero)));
+      }
+      if (len == 0) return;
+#elif defined ( __ARM_NEON )
+      for (; len >= 16; len -= 16, d += 16, s += 16)
+      {
+        uint8x16_t l = vld1q_u8(s);
+        uint8x16_t rb = vshrq_n_u8(l, 3);
+        uint8x16x2_t out;
+        out.val[0] = vorrq_u8(vshlq_n_u8(rb, 3), vshrq_n_u8(l, 5));
+        out.val[1] = vorrq_u8(vshlq_n_u8(vandq_u8(l, vdupq_n_u8(0x1C)), 3), rb);
+        vst2q_u8(reinterpret_cast<uint8_t*>(d), out);
+      }
+      if (len == 0) return;
+#endif
+      store_swap565_pairs(d, len, [s](uint32_t i) { return swap565_from_gray(s[i]); });
+    }
+
+#endif
+
 //----------------------------------------------------------------------------
   }
 }
@@ -21,6 +21,16 @@ Contributors:
 
 #include "colortype.hpp"
 
+// Word-wide / SIMD run kernels for the hot 16bpp conversions (see pixelcopy.cpp).
+// Off where image data may sit in flash that only allows pgm_read access.
+#if !defined ( LGFX_PIXELCOPY_RUN_KERNELS )
+ #if defined ( ESP8266 ) || defined ( __AVR__ )
+  #define LGFX_PIXELCOPY_RUN_KERNELS 0
+ #else
+  #define LGFX_PIXELCOPY_RUN_KERNELS 1
+ #endif
+#endif
+
 namespace lgfx
 {
  inline namespace v1
@@ -113,6 +123,8 @@ namespace lgfx
                                            : copy_rgb_affine<bgr666_t, TSrc>)
            : (dst_depth == grayscale_8bit) ? copy_rgb_affine<grayscale_t, TSrc>
            : (dst_depth == rgb565_nonswapped) ? copy_rgb_affine<rgb565_t, TSrc>
+           : (dst_depth == rgb888_nonswapped) ? copy_rgb_affine<rgb888_t, TSrc>
+           : (dst_depth == argb8888_nonswapped) ? copy_rgb_affine<argb8888_t, TSrc>
            : nullptr;
     }
 
@@ -123,6 +135,8 @@ namespace lgfx
            : (src_depth == rgb332_1Byte) ? copy_rgb_affine<TDst, rgb332_t >
            : (src_depth == grayscale_8bit) ? copy_rgb_affine<TDst, grayscale_t>
            : (src_depth == rgb565_nonswapped) ? copy_rgb_affine<TDst, rgb565_t >
+           : (src_depth == rgb888_nonswapped) ? copy_rgb_affine<TDst, rgb888_t >
+           : (src_depth == argb8888_nonswapped) ? copy_rgb_affine<TDst, argb8888_t>
            : (src_depth == rgb888_3Byte) ? copy_rgb_affine<TDst, bgr888_t >
                                          : (std::is_same<bgr666_t, TDst>::value)
                                            ? copy_rgb_affine<bgr888_t, bgr888_t>
@@ -138,6 +152,8 @@ namespace lgfx
            : (dst_depth == rgb666_3Byte) ? copy_palette_affine<bgr666_t , TPalette>
            : (dst_depth == grayscale_8bit) ? copy_palette_affine<grayscale_t, TPalette>
            : (dst_depth == rgb565_nonswapped) ? copy_palette_affine<rgb565_t, TPalette>
+           : (dst_depth == rgb888_nonswapped) ? copy_palette_affine<rgb888_t, TPalette>
+           : (dst_depth == argb8888_nonswapped) ? copy_palette_affine<argb8888_t, TPalette>
            : nullptr;
     }
 
@@ -158,22 +174,32 @@ namespace lgfx
       return index;
     }
 
+    /// Converts `len` (>0) contiguous pixels. The pairs that dominate sprite
+    /// pushes and decoder output are specialised in pixelcopy.cpp.
     template <typename TDst, typename TSrc>
-    static uint32_t copy_rgb_fast(void* dst, uint32_t index, uint32_t last, pixelcopy_t* param)
+    static void convert_run(TDst* __restrict d, const TSrc* __restrict s, uint32_t len)
     {
-      auto s = &static_cast<const TSrc*>(param->src_data)[(uintptr_t)param->positions[0] - (uintptr_t)index];
-      auto d = static_cast<TDst*>(dst);
-      param->positions[0] += last - index;
       if (std::is_same<TDst, TSrc>::value)
       {
-        memcpy(reinterpret_cast<void*>(&d[index]), reinterpret_cast<const void*>(&s[index]), (last - index) * sizeof(TSrc));
+        memcpy(reinterpret_cast<void*>(d), reinterpret_cast<const void*>(s), len * sizeof(TSrc));
       }
       else
       {
         do {
-          d[index].set(color_convert<TDst, TSrc>(s[index].get()));
-        } while (++index != last);
+          d->set(color_convert<TDst, TSrc>(s->get()));
+          ++d;
+          ++s;
+        } while (--len);
       }
+    }
+
+    template <typename TDst, typename TSrc>
+    static uint32_t copy_rgb_fast(void* dst, uint32_t index, uint32_t last, pixelcopy_t* param)
+    {
+      auto s = &static_cast<const TSrc*>(param->src_data)[(uintptr_t)param->positions[0] - (uintptr_t)index];
+      auto d = static_cast<TDst*>(dst);
+      param->positions[0] += last - index;
+      convert_run(&d[index], &s[index], last - index);
       return last;
     }
 #if 0
@@ -250,6 +276,16 @@ namespace lgfx
       auto src_y32_add = param->src_y32_add;
       auto src_x32 = param->src_x32;
       auto src_y32 = param->src_y32;
+#if LGFX_PIXELCOPY_RUN_KERNELS
+      // an unscaled row with no transparent colour is a plain run.
+      if (TSrc::bits <= 24 && src_x32_add == (1u << FP_SCALE) && src_y32_add == 0 && param->transp == NON_TRANSP)
+      {
+        uint32_t len = last - index;
+        convert_run(&d[index], &s[(src_x32 >> FP_SCALE) + (src_y32 >> FP_SCALE) * src_bitwidth], len);
+        param->src_x32 = src_x32 + (len << FP_SCALE);
+        return last;
+      }
+#endif
       do {
         uint32_t i = (src_x32 >> FP_SCALE) + (src_y32 >> FP_SCALE) * src_bitwidth;
         uint32_t raw = s[i].get();
@@ -575,6 +611,15 @@ namespace lgfx
     }
   };
 
+#if LGFX_PIXELCOPY_RUN_KERNELS
+  template <> void pixelcopy_t::convert_run<swap565_t, rgb565_t   >(swap565_t* __restrict d, const rgb565_t*    __restrict s, uint32_t len);
+  template <> void pixelcopy_t::convert_run<rgb565_t , swap565_t  >(rgb565_t*  __restrict d, const swap565_t*   __restrict s, uint32_t len);
+  template <> void pixelcopy_t::convert_run<swap565_t, bgr888_t   >(swap565_t* __restrict d, const bgr888_t*    __restrict s, uint32_t len);
+  template <> void pixelcopy_t::convert_run<swap565_t, rgb888_t   >(swap565_t* __restrict d, const rgb888_t*    __restrict s, uint32_t len);
+  template <> void pixelcopy_t::convert_run<swap565_t, rgb332_t   >(swap565_t* __restrict d, const rgb332_t*    __restrict s, uint32_t len);
+  template <> void pixelcopy_t::convert_run<swap565_t, grayscale_t>(swap565_t* __restrict d, const grayscale_t* __restrict s, uint32_t len);
+#endif
+
 //----------------------------------------------------------------------------
  }
 }
@@ -78,6 +78,7 @@ namespace lgfx
     _auto_display = true;
 #endif
 
+    clearModifiedRange();
     setInvert(_invert);
     setRotation(_rotation);
 
@@ -152,10 +153,7 @@ namespace lgfx
       cacheWriteBack(ptr_start, (int)ptr_end - (int)ptr_start);
     }
 #endif
-    _range_mod.top = INT16_MAX;
-    _range_mod.left = INT16_MAX;
-    _range_mod.right = 0;
-    _range_mod.bottom = 0;
+    clearModifiedRange();
   }
 
   void Panel_FrameBufferBase::setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye)
@@ -417,6 +415,11 @@ namespace lgfx
     {
       _rotate_pixelcopy(x, y, w, h, param, nextx, nexty);
     }
+    _range_mod.left   = std::min<int32_t>(x, _range_mod.left);
+    _range_mod.right  = std::max<int32_t>(x+w-1, _range_mod.right);
+    _range_mod.top    = std::min<int32_t>(y, _range_mod.top);
+    _range_mod.bottom = std::max<int32_t>(y+h-1, _range_mod.bottom);
+
     uint32_t sx32 = param->src_x32;
     uint32_t sy32 = param->src_y32;
 
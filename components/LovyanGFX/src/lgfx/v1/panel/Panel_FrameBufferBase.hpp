@@ -62,12 +62,24 @@ namespace lgfx
     void readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param) override;
     void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) override;
 
+    /// Area written since the last call, in memory coordinates (unrotated
+    /// lines of _lines_buffer); empty if nothing was. Starts a new area.
+    range_rect_t takeModifiedRange(void) { auto r = _range_mod; clearModifiedRange(); return r; }
+
   protected:
     uint8_t** _lines_buffer = nullptr;
     uint16_t _xpos, _ypos;
 
     range_rect_t _range_mod;
 
+    void clearModifiedRange(void)
+    {
+      _range_mod.top = INT16_MAX;
+      _range_mod.left = INT16_MAX;
+      _range_mod.right = 0;
+      _range_mod.bottom = 0;
+    }
+
     void _rotate_pixelcopy(uint_fast16_t& x, uint_fast16_t& y, uint_fast16_t& w, uint_fast16_t& h, pixelcopy_t* param, uint32_t& nextx, uint32_t& nexty);
   };
 
@@ -0,0 +1,129 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+
+#include "Panel_Headless.hpp"
+#include "../platforms/common.hpp"
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  Panel_Headless::~Panel_Headless(void)
+  {
+    free_frame();
+  }
+
+  void Panel_Headless::free_frame(void)
+  {
+    if (_frame) { heap_free(_frame); }
+    if (_lines_buffer) { heap_free(_lines_buffer); }
+    _frame = nullptr;
+    _lines_buffer = nullptr;
+    _frame_len = 0;
+  }
+
+  bool Panel_Headless::alloc_frame(void)
+  {
+    free_frame();
+    size_t width = _cfg.panel_width;
+    size_t height = _cfg.panel_height;
+    size_t line_len = width * (_write_bits >> 3);
+    _frame_len = line_len * height;
+    _frame = (uint8_t*)heap_alloc_psram(_frame_len);
+    _lines_buffer = (uint8_t**)heap_alloc(height * sizeof(uint8_t*));
+    if (_frame == nullptr || _lines_buffer == nullptr)
+    {
+      free_frame();
+      return false;
+    }
+    memset(_frame, 0, _frame_len);
+    for (size_t y = 0; y < height; ++y)
+    {
+      _lines_buffer[y] = &_frame[y * line_len];
+    }
+    return true;
+  }
+
+  bool Panel_Headless::init(bool use_reset)
+  {
+    setColorDepth(_write_depth);
+    if (!alloc_frame()) { return false; }
+    resetStats();
+    return Panel_FrameBufferBase::init(use_reset);
+  }
+
+  color_depth_t Panel_Headless::setColorDepth(color_depth_t depth)
+  {
+    if ((depth & color_depth_t::has_palette) || (depth & color_depth_t::bit_mask) < 8)
+    {
+      depth = rgb332_1Byte;
+    }
+    bool changed = (depth != _write_depth);
+    _write_depth = depth;
+    _read_depth = depth;
+    if (changed && _frame) { alloc_frame(); }
+    return depth;
+  }
+
+  void Panel_Headless::drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
+  {
+    count(op_pixel, 1);
+    Panel_FrameBufferBase::drawPixelPreclipped(x, y, rawcolor);
+  }
+
+  void Panel_Headless::writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
+  {
+    count(op_fill, w * h);
+    Panel_FrameBufferBase::writeFillRectPreclipped(x, y, w, h, rawcolor);
+  }
+
+  void Panel_Headless::writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool use_dma)
+  {
+    count(op_image, w * h);
+    Panel_FrameBufferBase::writeImage(x, y, w, h, param, use_dma);
+  }
+
+  void Panel_Headless::writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param)
+  {
+    count(op_image_argb, w * h);
+    Panel_FrameBufferBase::writeImageARGB(x, y, w, h, param);
+  }
+
+  void Panel_Headless::writePixels(pixelcopy_t* param, uint32_t len, bool use_dma)
+  {
+    count(op_pixels, len);
+    Panel_FrameBufferBase::writePixels(param, len, use_dma);
+  }
+
+  void Panel_Headless::readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param)
+  {
+    count(op_read, w * h);
+    Panel_FrameBufferBase::readRect(x, y, w, h, dst, param);
+  }
+
+  void Panel_Headless::copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y)
+  {
+    count(op_copy, w * h);
+    Panel_FrameBufferBase::copyRect(dst_x, dst_y, w, h, src_x, src_y);
+  }
+
+//----------------------------------------------------------------------------
+ }
+}
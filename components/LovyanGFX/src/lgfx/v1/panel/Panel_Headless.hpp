@@ -0,0 +1,97 @@
+/*----------------------------------------------------------------------------/
+  Lovyan GFX - Graphics library for embedded devices.
+
+Original Source:
+ https://github.com/lovyan03/LovyanGFX/
+
+Licence:
+ [FreeBSD](https://github.com/lovyan03/LovyanGFX/blob/master/license.txt)
+
+Author:
+ [lovyan03](https://twitter.com/lovyan03)
+
+Contributors:
+ [ciniml](https://github.com/ciniml)
+ [mongonta0716](https://github.com/mongonta0716)
+ [tobozo](https://github.com/tobozo)
+/----------------------------------------------------------------------------*/
+#pragma once
+
+#include "Panel_FrameBufferBase.hpp"
+
+#include <string.h>
+
+namespace lgfx
+{
+ inline namespace v1
+ {
+//----------------------------------------------------------------------------
+
+  /// A panel that only draws into memory, for tests and benchmarks without a
+  /// display. The frame is one contiguous buffer, lines packed with no padding,
+  /// so two frames compare with memcmp; every primitive reaching the panel is
+  /// counted by kind along with the pixels it covered.
+  struct Panel_Headless : public Panel_FrameBufferBase
+  {
+  public:
+    enum op_t
+    {
+      op_pixel,       // drawPixelPreclipped
+      op_fill,        // writeFillRectPreclipped, writeBlock
+      op_pixels,      // writePixels
+      op_image,       // writeImage
+      op_image_argb,  // writeImageARGB
+      op_copy,        // copyRect
+      op_read,        // readRect
+      op_max
+    };
+
+    struct op_stats_t
+    {
+      uint32_t calls;
+      uint64_t pixels;
+    };
+
+    Panel_Headless(void) = default;
+    virtual ~Panel_Headless(void);
+
+    /// Allocates the frame at panel_width x panel_height, cleared to zero.
+    bool init(bool use_reset) override;
+
+    /// Any depth of 8 bits or more; palettes and smaller depths become rgb332.
+    /// After init the frame is reallocated and cleared.
+    color_depth_t setColorDepth(color_depth_t depth) override;
+
+    void drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) override;
+    void writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor) override;
+    void writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool use_dma) override;
+    void writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param) override;
+    void writePixels(pixelcopy_t* param, uint32_t len, bool use_dma) override;
+    void readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param) override;
+    void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) override;
+
+    /// The frame in memory order (unrotated), in the panel's raw colour format.
+    const void* getBuffer(void) const { return _frame; }
+    size_t getBufferLength(void) const { return _frame_len; }
+
+    /// Copies the frame out; `dst` must hold getBufferLength() bytes.
+    void snapshot(void* dst) const { memcpy(dst, _frame, _frame_len); }
+    /// True if the frame equals a snapshot taken at the same size and depth.
+    bool matches(const void* snapshot) const { return memcmp(_frame, snapshot, _frame_len) == 0; }
+
+    const op_stats_t& getStats(op_t op) const { return _stats[op]; }
+    void resetStats(void) { memset(_stats, 0, sizeof(_stats)); }
+
+  protected:
+    uint8_t* _frame = nullptr;
+    size_t _frame_len = 0;
+    op_stats_t _stats[op_max] = {};
+
+    bool alloc_frame(void);
+    void free_frame(void);
+    void count(op_t op, uint32_t pixels) { ++_stats[op].calls; _stats[op].pixels += pixels; }
+  };
+
+//----------------------------------------------------------------------------
+ }
+}
@@ -30,86 +30,69 @@ Porting for Linux FrameBuffer:
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <sys/stat.h>
 
 namespace lgfx
 {
  inline namespace v1
  {
 //----------------------------------------------------------------------------
-  void Panel_fb::fb_draw_rgb_pixel(int x, int y, uint32_t rawcolor)
-  {
-    unsigned int pix_offset = 0;
-    uint8_t r = 0, g = 0, b = 0;
-
-    // GGGBBBBB RRRRRGGG
-    if (_write_depth = color_depth_t::rgb565_2Byte)
-    {
-      b = (uint8_t)((rawcolor >> 8) & 0b11111);
-      g = (uint8_t)((((rawcolor >> 10) & 0b111000)) | (rawcolor & 0b111));
-      r = (uint8_t)((rawcolor >> 3) & 0b11111);
-
-      pix_offset = x * 2 + y * _fix_info.line_length;
-      unsigned short c = (r << 11) | (g << 5) | b;
-      // write 'two bytes at once'
-      *((unsigned short*)(_fbp + pix_offset)) = c;
-    }
-    // BBBBBBBB GGGGGGGG RRRRRRRR
-    else if (_write_depth = color_depth_t::rgb888_3Byte)
-    {
-      b = (uint8_t)((rawcolor >> 16) & 0xff);
-      g = (uint8_t)((rawcolor >> 8) & 0xff);
-      r = (uint8_t)((rawcolor >> 0) & 0xff);
-
-      pix_offset = x * 3 + y * _fix_info.line_length;
-      *((char*)(_fbp + pix_offset)) = b;
-      *((char*)(_fbp + pix_offset + 1)) = g;
-      *((char*)(_fbp + pix_offset + 2)) = r;
-    }
-  }
 
-  void Panel_fb::fb_draw_argb_pixel(int x, int y, uint32_t rawcolor)
+  Panel_fb::~Panel_fb(void)
   {
-    unsigned int pix_offset = x * 4 + y * _fix_info.line_length;
-
-    uint8_t r = 0, g = 0, b = 0, a = 0;
-
-    // BBBBBBBB GGGGGGGG RRRRRRRR AAAAAAAA
-    b = (uint8_t)((rawcolor >> 24) & 0xff);
-    g = (uint8_t)((rawcolor >> 16) & 0xff);
-    r = (uint8_t)((rawcolor >> 8) & 0xff);
-    a = (uint8_t)((rawcolor >> 0) & 0xff);
-    
-    *((char*)(_fbp + pix_offset)) = b;
-    *((char*)(_fbp + pix_offset + 1)) = g;
-    *((char*)(_fbp + pix_offset + 2)) = r;
-    *((char*)(_fbp + pix_offset + 3)) = a;
+    release();
   }
 
-  Panel_fb::~Panel_fb(void)
+  Panel_fb::Panel_fb(void) : Panel_FrameBufferBase()
   {
-    // unmap fb file from memory
-    munmap(_fbp, _screensize);
-    // close fb file    
-    close(_fbfd);
-
     memset(&_fix_info, 0, sizeof(_fix_info));
     memset(&_var_info, 0, sizeof(_var_info));
   }
 
-  Panel_fb::Panel_fb(void) : Panel_Device(), _fbp(nullptr)
+  void Panel_fb::release(void)
   {
-    _fbp = 0;
+    if (_fbp)
+    {
+      // leave the console on the first page
+      if (_visible_page)
+      {
+        memcpy(_fbp, _fbp + _page_bytes, _page_bytes);
+        pan_to(0);
+      }
+      munmap(_fbp, _screensize);
+      _fbp = nullptr;
+    }
+    if (_fbfd >= 0)
+    {
+      close(_fbfd);
+      _fbfd = -1;
+    }
+    if (_back_buffer)
+    {
+      heap_free(_back_buffer);
+      _back_buffer = nullptr;
+    }
+    if (_lines)
+    {
+      heap_free(_lines);
+      _lines = nullptr;
+    }
+    _lines_buffer = nullptr;
+    _visible_page = 0;
   }
 
-  bool Panel_fb::init(bool use_reset)
+  bool Panel_fb::open_device(void)
   {
     _fbfd = open(_config_detail.device_name, O_RDWR);
-    if (_fbfd == -1) {
-      // detect target framebuffer.
-      DIR* sysfs_graphics = opendir("/sys/class/graphics");
+    if (_fbfd != -1) { return true; }
+
+    // detect target framebuffer.
+    DIR* sysfs_graphics = opendir("/sys/class/graphics");
+    std::string target = "/dev/fb0";
+    if (sysfs_graphics)
+    {
       struct dirent* entry;
       std::string path;
-      std::string target = "/dev/fb0";
       while((entry = readdir(sysfs_graphics)) != NULL) {
         if( entry->d_type == DT_LNK ) {
           path = "/sys/class/graphics/";
@@ -119,7 +102,7 @@ namespace lgfx
           if( !fs.is_open() ) continue;
           std::stringstream buffer;
           buffer << fs.rdbuf();
-          if( buffer.str().find_first_of(_config_detail.device_name) != std::string::npos ) {
+          if( buffer.str().find(_config_detail.device_name) != std::string::npos ) {
             target = "/dev/";
             target.append(entry->d_name);
             break;
@@ -127,411 +110,200 @@ namespace lgfx
         }
       }
       closedir(sysfs_graphics);
+    }
 
-      _fbfd = open(target.c_str(), O_RDWR);
-      if (_fbfd == -1) {
-        printf("Error: cannot open framebuffer device.\n");
-        return false;
-      }
+    _fbfd = open(target.c_str(), O_RDWR);
+    if (_fbfd == -1) {
+      printf("Error: cannot open framebuffer device.\n");
+      return false;
     }
-    // printf("The framebuffer device was opened successfully.\n");
+    return true;
+  }
 
-    // Get variable screen information
-    if (ioctl(_fbfd, FBIOGET_VSCREENINFO, &_var_info)) {
+  /// Reads the screen geometry from the driver, or makes it up from the
+  /// panel config when the target is a regular file.
+  bool Panel_fb::get_screen_info(void)
+  {
+    struct stat st;
+    _is_file = (fstat(_fbfd, &st) == 0) && S_ISREG(st.st_mode);
+    if (!_is_file)
+    {
+      if (ioctl(_fbfd, FBIOGET_VSCREENINFO, &_var_info)) {
         printf("Error reading variable information.\n");
         return false;
-    }
-    // printf("%dx%d, %dbpp\n", _var_info.xres, _var_info.yres, _var_info.bits_per_pixel);
-
-    // 16/24/32
-    setColorDepth((color_depth_t)_var_info.bits_per_pixel);
-
-    // Get fixed screen information
-    if (ioctl(_fbfd, FBIOGET_FSCREENINFO, &_fix_info)) {
+      }
+      if (ioctl(_fbfd, FBIOGET_FSCREENINFO, &_fix_info)) {
         printf("Error reading fixed information.\n");
         return false;
+      }
+      return true;
     }
 
-    // Figure out the size of the screen in bytes
-    _screensize = _fix_info.smem_len;  //finfo.line_length * vinfo.yres;    
-
-    // Map the device to memory
-    _fbp = (char *)mmap(0, _screensize, PROT_READ | PROT_WRITE, MAP_SHARED, _fbfd, 0);
-    if((intptr_t)_fbp == -1) {
-        perror("Error: failed to map framebuffer device to memory");
-        return false;
-    }
-    memset(_fbp, 0, _screensize);
-
-    return Panel_Device::init(use_reset);
+    memset(&_var_info, 0, sizeof(_var_info));
+    memset(&_fix_info, 0, sizeof(_fix_info));
+    _var_info.xres = _var_info.xres_virtual = _cfg.panel_width;
+    _var_info.yres = _var_info.yres_virtual = _cfg.panel_height;
+    _var_info.bits_per_pixel = _config_detail.file_bits;
+    _fix_info.line_length = _cfg.panel_width * _config_detail.file_bits >> 3;
+    _fix_info.smem_len = _fix_info.line_length * _cfg.panel_height;
+    return true;
   }
 
-  void Panel_fb::display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
+  /// Asks for a virtual screen `pages` screens high. A file is simply grown.
+  bool Panel_fb::set_pages(uint_fast8_t pages)
   {
-    // Nothings to do
+    uint32_t yres_virtual = _var_info.yres * pages;
+    if (_is_file)
+    {
+      _var_info.yres_virtual = yres_virtual;
+      _fix_info.smem_len = _fix_info.line_length * yres_virtual;
+      return true;
+    }
+    if (_var_info.yres_virtual < yres_virtual)
+    {
+      auto var_info = _var_info;
+      var_info.yres_virtual = yres_virtual;
+      if (ioctl(_fbfd, FBIOPUT_VSCREENINFO, &var_info)
+       || ioctl(_fbfd, FBIOGET_VSCREENINFO, &_var_info)
+       || ioctl(_fbfd, FBIOGET_FSCREENINFO, &_fix_info))
+      {
+        return false;
+      }
+    }
+    return _var_info.yres_virtual >= yres_virtual
+        && _fix_info.smem_len >= _fix_info.line_length * yres_virtual;
   }
 
-  color_depth_t Panel_fb::setColorDepth(color_depth_t depth)
+  bool Panel_fb::pan_to(uint_fast8_t page)
   {
-    // TODO
-    _write_bits = depth;
-    _read_bits = depth;
-    _write_depth = depth;
-    _read_depth = depth;
-    return depth;
+    auto var_info = _var_info;
+    var_info.xoffset = 0;
+    var_info.yoffset = page * _var_info.yres;
+    var_info.activate = FB_ACTIVATE_VBL;
+    if (!_is_file && ioctl(_fbfd, FBIOPAN_DISPLAY, &var_info)) { return false; }
+    _var_info.yoffset = var_info.yoffset;
+    _visible_page = page;
+    return true;
   }
 
-  void Panel_fb::beginTransaction(void) {}
-
-  void Panel_fb::endTransaction(void) {}
-
-  void Panel_fb::setRotation(uint_fast8_t r)
+  bool Panel_fb::init(bool use_reset)
   {
-    r &= 7;
-    _rotation = r;
-    _internal_rotation = ((r + _cfg.offset_rotation) & 3) | ((r & 4) ^ (_cfg.offset_rotation & 4));
+    release();
+    if (!open_device() || !get_screen_info()) { return false; }
 
-    _width  = _cfg.panel_width;
-    _height = _cfg.panel_height;
-    if (_internal_rotation & 1) std::swap(_width, _height);
-  }
+    // Lines are written as they are laid out in memory, so the format is the
+    // framebuffer's: little endian with red highest.
+    switch (_var_info.bits_per_pixel)
+    {
+    case 16: _write_depth = rgb565_nonswapped;   break;
+    case 24: _write_depth = rgb888_nonswapped;   break;
+    case 32: _write_depth = argb8888_nonswapped; break;
+    default:
+      printf("Error: %dbpp framebuffer is not supported.\n", _var_info.bits_per_pixel);
+      return false;
+    }
+    _read_depth = _write_depth;
 
-  void Panel_fb::setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye)
-  {
-    xs = std::max<unsigned long>(0u, std::min<uint_fast16_t>(_width  - 1, xs));
-    xe = std::max<unsigned long>(0u, std::min<uint_fast16_t>(_width  - 1, xe));
-    ys = std::max<unsigned long>(0u, std::min<uint_fast16_t>(_height - 1, ys));
-    ye = std::max<unsigned long>(0u, std::min<uint_fast16_t>(_height - 1, ye));
-    _xpos = xs;
-    _xs = xs;
-    _xe = xe;
-    _ypos = ys;
-    _ys = ys;
-    _ye = ye;
-  }
+    if (_cfg.panel_width  > _var_info.xres) { _cfg.panel_width  = _var_info.xres; }
+    if (_cfg.panel_height > _var_info.yres) { _cfg.panel_height = _var_info.yres; }
+    if (_cfg.memory_width  > _cfg.panel_width ) { _cfg.memory_width  = _cfg.panel_width; }
+    if (_cfg.memory_height > _cfg.panel_height) { _cfg.memory_height = _cfg.panel_height; }
 
-  void Panel_fb::drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
-  {
-    uint_fast8_t rotation = _internal_rotation;
-    if (rotation)
+    _buffer_mode = _config_detail.buffer_mode;
+    if (_buffer_mode == buffer_flip && !set_pages(2))
     {
-      if ((1u << rotation) & 0b10010110) { y = _height - (y + 1); }
-      if (rotation & 2)                  { x = _width  - (x + 1); }
-      if (rotation & 1) { std::swap(x, y); }
+      _buffer_mode = buffer_copy;
+    }
+    uint_fast8_t pages = (_buffer_mode == buffer_flip) ? 2 : 1;
+    _page_bytes = _fix_info.line_length * _var_info.yres;
+    _screensize = _page_bytes * pages;
+    if (_is_file && ftruncate(_fbfd, _screensize)) {
+      perror("Error: failed to size framebuffer file");
+      return false;
     }
 
-    switch (_write_depth)
-    {
-      case color_depth_t::rgb565_2Byte:
-      case color_depth_t::rgb888_3Byte:
-        fb_draw_rgb_pixel(x, y, rawcolor);
-        break;
-      case color_depth_t::argb8888_4Byte:
-        fb_draw_argb_pixel(x, y, rawcolor);
-        break;
-      default:
-        break;
+    // Map the device to memory
+    _fbp = (uint8_t*)mmap(0, _screensize, PROT_READ | PROT_WRITE, MAP_SHARED, _fbfd, 0);
+    if (_fbp == MAP_FAILED) {
+      _fbp = nullptr;
+      perror("Error: failed to map framebuffer device to memory");
+      return false;
     }
+    memset(_fbp, 0, _screensize);
 
-    if (!getStartCount())
+    // Lines of the shown page first, then of the back buffer if there is one
+    size_t height = _var_info.yres;
+    size_t lines = (_buffer_mode == buffer_direct) ? height : height * 2;
+    _lines = (uint8_t**)heap_alloc(lines * sizeof(uint8_t*));
+    if (!_lines) { return false; }
+    if (_buffer_mode == buffer_copy && pages == 1)
     {
-      display(x, y, 1, 1);
+      _back_buffer = (uint8_t*)heap_alloc(_page_bytes);
+      if (!_back_buffer) { return false; }
+      memset(_back_buffer, 0, _page_bytes);
     }
-  }
-
-  void Panel_fb::writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
-  {
-    uint_fast8_t rotation = _internal_rotation;
-    if (rotation)
+    for (size_t y = 0; y < lines; ++y)
     {
-      if ((1u << rotation) & 0b10010110) { y = _height - (y + h); }
-      if (rotation & 2)                  { x = _width  - (x + w); }
-      if (rotation & 1) { std::swap(x, y);  std::swap(w, h); }
+      _lines[y] = (_back_buffer && y >= height)
+                ? _back_buffer + (y - height) * _fix_info.line_length
+                : _fbp + y * _fix_info.line_length;
     }
+    _lines_buffer = &_lines[lines - height];
 
-    for (size_t width = 0; width < w; width++)
+    // Without panning the second page still serves as the back buffer
+    if (_buffer_mode == buffer_flip && !pan_to(0))
     {
-      for (size_t height = 0; height < h; height++)
-      {
-        uint_fast16_t x_pos = x + width;
-        uint_fast16_t y_pos = y + height;
-
-        switch (_write_depth)
-        {
-          case color_depth_t::rgb565_2Byte:
-          case color_depth_t::rgb888_3Byte:
-            fb_draw_rgb_pixel(x_pos, y_pos, rawcolor);
-            break;
-          case color_depth_t::argb8888_4Byte:
-            fb_draw_argb_pixel(x_pos, y_pos, rawcolor);
-            break;
-          default:
-            break;
-        }
-      }
+      _buffer_mode = buffer_copy;
     }
-  }
 
-  void Panel_fb::writeBlock(uint32_t rawcolor, uint32_t length)
-  {
-    do
-    {
-      uint32_t h = 1;
-      auto w = std::min<uint32_t>(length, _xe + 1 - _xpos);
-      if (length >= (w << 1) && _xpos == _xs)
-      {
-        h = std::min<uint32_t>(length / w, _ye + 1 - _ypos);
-      }
-      writeFillRectPreclipped(_xpos, _ypos, w, h, rawcolor);
-      if ((_xpos += w) <= _xe) return;
-      _xpos = _xs;
-      if (_ye < (_ypos += h)) { _ypos = _ys; }
-      length -= w * h;
-    } while (length);
+    return Panel_FrameBufferBase::init(use_reset);
   }
 
-  void Panel_fb::_rotate_pixelcopy(uint_fast16_t& x, uint_fast16_t& y, uint_fast16_t& w, uint_fast16_t& h, pixelcopy_t* param, uint32_t& nextx, uint32_t& nexty)
+  /// Copies the area r between two pages, row by row.
+  void Panel_fb::copy_modified(uint8_t** dst, uint8_t** src, const range_rect_t& r)
   {
-    // NOT TEST
-    uint32_t addx = param->src_x32_add;
-    uint32_t addy = param->src_y32_add;
-    uint_fast8_t r = _internal_rotation;
-    uint_fast8_t bitr = 1u << r;
-    if (bitr & 0b10010110) // case 1:2:4:7:
-    {
-      param->src_y32 += nexty * (h - 1);
-      nexty = -(int32_t)nexty;
-      y = _height - (y + h);
-    }
-    if (r & 2)
-    {
-      param->src_x32 += addx * (w - 1);
-      param->src_y32 += addy * (w - 1);
-      addx = -(int32_t)addx;
-      addy = -(int32_t)addy;
-      x = _width  - (x + w);
-    }
-    if (r & 1)
+    size_t bytes = _write_bits >> 3;
+    size_t x = r.left * bytes;
+    size_t len = (r.right + 1 - r.left) * bytes;
+    for (int_fast16_t y = r.top; y <= r.bottom; ++y)
     {
-      std::swap(x, y);
-      std::swap(w, h);
-      std::swap(nextx, addx);
-      std::swap(nexty, addy);
+      memcpy(&dst[y][x], &src[y][x], len);
     }
-    param->src_x32_add = addx;
-    param->src_y32_add = addy;
   }
 
-  void Panel_fb::writePixels(pixelcopy_t* param, uint32_t length, bool use_dma)
+  void Panel_fb::display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
   {
-    // NOT TEST
-    uint_fast16_t xs = _xs;
-    uint_fast16_t xe = _xe;
-    uint_fast16_t ys = _ys;
-    uint_fast16_t ye = _ye;
-    uint_fast16_t x = _xpos;
-    uint_fast16_t y = _ypos;
-    const size_t bits = _write_bits;
-    auto k = _cfg.panel_width * bits >> 3;
-
-    uint_fast8_t r = _internal_rotation;
-    if (!r)
+    if (0 < w && 0 < h)
     {
-      uint_fast16_t linelength;
-      do {
-        linelength = std::min<uint_fast16_t>(xe - x + 1, length);
-        param->fp_copy(&_fbp[y * k], x, x + linelength, param);
-        if ((x += linelength) > xe)
-        {
-          x = xs;
-          y = (y != ye) ? (y + 1) : ys;
-        }
-      } while (length -= linelength);
-      _xpos = x;
-      _ypos = y;
-      return;
+      _range_mod.left   = std::min<int_fast16_t>(_range_mod.left  , x        );
+      _range_mod.right  = std::max<int_fast16_t>(_range_mod.right , x + w - 1);
+      _range_mod.top    = std::min<int_fast16_t>(_range_mod.top   , y        );
+      _range_mod.bottom = std::max<int_fast16_t>(_range_mod.bottom, y + h - 1);
     }
+    if (_range_mod.empty() || !_fbp) { return; }
+    auto r = takeModifiedRange();
 
-    int_fast16_t ax = 1;
-    int_fast16_t ay = 1;
-    if ((1u << r) & 0b10010110) { y = _height - (y + 1); ys = _height - (ys + 1); ye = _height - (ye + 1); ay = -1; }
-    if (r & 2)                  { x = _width  - (x + 1); xs = _width  - (xs + 1); xe = _width  - (xe + 1); ax = -1; }
-    if (param->no_convert)
+    size_t height = _var_info.yres;
+    uint8_t** front = &_lines[_visible_page * height];
+    if (_buffer_mode == buffer_copy)
     {
-      size_t bytes = bits >> 3;
-      size_t xw = 1;
-      size_t yw = _cfg.panel_width;
-      if (r & 1) std::swap(xw, yw);
-      size_t idx = y * yw + x * xw;
-      auto data = (uint8_t*)param->src_data;
-      do
-      {
-        auto dst = &_fbp[idx * bytes];
-        size_t b = 0;
-        do
-        {
-          dst[b] = *data++;
-        } while (++b < bytes);
-        if (x != xe)
-        {
-          idx += xw * ax;
-          x += ax;
-        }
-        else
-        {
-          x = xs;
-          y = (y != ye) ? (y + ay) : ys;
-          idx = y * yw + x * xw;
-        }
-      } while (--length);
+      copy_modified(front, _lines_buffer, r);
     }
-    else
+    else if (_buffer_mode == buffer_flip)
     {
-      if (r & 1)
+      // The shown page now differs from the drawn one only in the modified
+      // area; after the flip that area is copied back to the new hidden page.
+      uint_fast8_t page = 1 - _visible_page;
+      if (pan_to(page))
       {
-        do
-        {
-          param->fp_copy(&_fbp[x * k], y, y + 1, param);
-          if (x != xe)
-          {
-            x += ax;
-          }
-          else
-          {
-            x = xs;
-            y = (y != ye) ? (y + ay) : ys;
-          }
-        } while (--length);
+        _lines_buffer = front;
+        copy_modified(_lines_buffer, &_lines[page * height], r);
       }
       else
       {
-        do
-        {
-          param->fp_copy(&_fbp[y * k], x, x + 1, param);
-          if (x != xe)
-          {
-            x += ax;
-          }
-          else
-          {
-            x = xs;
-            y = (y != ye) ? (y + ay) : ys;
-          }
-        } while (--length);
+        copy_modified(front, _lines_buffer, r);
       }
     }
-    if ((1u << r) & 0b10010110) { y = _height - (y + 1); }
-    if (r & 2)                  { x = _width  - (x + 1); }
-    _xpos = x;
-    _ypos = y;
-  }
-
-  void Panel_fb::writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool)
-  {
-    // NOT TEST
-    uint_fast8_t r = _internal_rotation;
-    if (r == 0 && param->transp == pixelcopy_t::NON_TRANSP && param->no_convert)
-    {
-      auto sx = param->src_x;
-      auto bits = param->src_bits;
-
-      auto bw = _cfg.panel_width * bits >> 3;
-      auto dst = &_fbp[bw * y];
-      auto sw = param->src_bitwidth * bits >> 3;
-      auto src = &((uint8_t*)param->src_data)[param->src_y * sw];
-      if (sw == bw && this->_cfg.panel_width == w && sx == 0 && x == 0)
-      {
-        memcpy(dst, src, bw * h);
-        return;
-      }
-      y = 0;
-      dst +=  x * bits >> 3;
-      src += sx * bits >> 3;
-      w    =  w * bits >> 3;
-      do
-      {
-        memcpy(&dst[y * bw], &src[y * sw], w);
-      } while (++y != h);
-      return;
-    }
-
-    uint32_t nextx = 0;
-    uint32_t nexty = 1 << pixelcopy_t::FP_SCALE;
-    if (r)
-    {
-      _rotate_pixelcopy(x, y, w, h, param, nextx, nexty);
-    }
-    uint32_t sx32 = param->src_x32;
-    uint32_t sy32 = param->src_y32;
-
-    y *= _cfg.panel_width;
-    do
-    {
-      int32_t pos = x + y;
-      int32_t end = pos + w;
-      while (end != (pos = param->fp_copy(_fbp, pos, end, param))
-         &&  end != (pos = param->fp_skip(      pos, end, param)));
-      param->src_x32 = (sx32 += nextx);
-      param->src_y32 = (sy32 += nexty);
-      y += _cfg.panel_width;
-    } while (--h);
-  }
-
-  void Panel_fb::writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param)
-  {
-    // NOT TEST
-    uint32_t nextx = 0;
-    uint32_t nexty = 1 << pixelcopy_t::FP_SCALE;
-    if (_internal_rotation)
-    {
-      _rotate_pixelcopy(x, y, w, h, param, nextx, nexty);
-    }
-    uint32_t sx32 = param->src_x32;
-    uint32_t sy32 = param->src_y32;
-
-    uint32_t pos = x + y * _cfg.panel_width;
-    uint32_t end = pos + w;
-    param->fp_copy(_fbp, pos, end, param);
-    while (--h)
-    {
-      pos += _cfg.panel_width;
-      end = pos + w;
-      param->src_x32 = (sx32 += nextx);
-      param->src_y32 = (sy32 += nexty);
-      param->fp_copy(_fbp, pos, end, param);
-    }
-  }
-
-  void Panel_fb::readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param)
-  {
-    // TODO
-  }
-
-  void Panel_fb::copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y)
-  {
-
-    uint_fast8_t r = _internal_rotation;
-    if (r)
-    {
-      if ((1u << r) & 0b10010110) { src_y = _height - (src_y + h); dst_y = _height - (dst_y + h); }
-      if (r & 2)                  { src_x = _width  - (src_x + w); dst_x = _width  - (dst_x + w); }
-      if (r & 1) { std::swap(src_x, src_y);  std::swap(dst_x, dst_y);  std::swap(w, h); }
-    }
-
-    if ((dst_x + w) > _var_info.xres) w = _var_info.xres - dst_x;
-    if ((dst_y + h) > _var_info.yres) h = _var_info.yres - dst_y;
-    size_t bytes = _write_bits >> 3;
-    size_t len = w * bytes;
-    int32_t add = _var_info.xres * bytes;  // _cfg.panel_width may not was the screen width, use _var_info.xres instead.
-    char *src = (_fbp + (src_x * bytes + src_y * _fix_info.line_length));
-    char *dst = (_fbp + (dst_x * bytes + dst_y * _fix_info.line_length));
-
-    do
-    {
-      memmove(dst, src, len);
-      src += add;
-      dst += add;
-    } while (--h);
   }
 
   uint_fast8_t Panel_fb::getTouchRaw(touch_point_t* tp, uint_fast8_t count)
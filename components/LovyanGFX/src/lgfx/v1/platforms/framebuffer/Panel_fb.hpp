@@ -20,7 +20,7 @@ Porting for Linux FrameBuffer:
 /----------------------------------------------------------------------------*/
 #pragma once
 
-#include "../../panel/Panel_Device.hpp"
+#include "../../panel/Panel_FrameBufferBase.hpp"
 #include "../../misc/range.hpp"
 #include "../../Touch.hpp"
 
@@ -36,45 +36,45 @@ namespace lgfx
  {
 //----------------------------------------------------------------------------
 
-  struct Panel_fb : public Panel_Device
+  struct Panel_fb : public Panel_FrameBufferBase
   {
 
   public:
     Panel_fb(void);
     virtual ~Panel_fb(void);
 
+    /// Where drawing goes before it is shown.
+    enum buffer_mode_t
+    {
+      /// Straight into the mapped framebuffer.
+      buffer_direct,
+      /// Into a heap back buffer; display() copies the modified rows out.
+      buffer_copy,
+      /// Into the hidden half of a double-height virtual screen; display()
+      /// pans to it with FBIOPAN_DISPLAY. Becomes buffer_copy if the driver
+      /// cannot pan.
+      buffer_flip,
+    };
+
     struct config_detail_t
     {
       // 操作対象とするフレームバッファのパス名、または、デバイス名称 ("st7789") 等の文字列へのポインタを指定する。
       const char* device_name = "/dev/fb0";
+
+      buffer_mode_t buffer_mode = buffer_direct;
+
+      // If device_name is a regular file, it is mapped in place of a framebuffer
+      // as a panel_width x panel_height screen of this many bits per pixel.
+      uint8_t file_bits = 16;
     };
 
     bool init(bool use_reset) override;
-    void beginTransaction(void) override;
-    void endTransaction(void) override;
-
-    color_depth_t setColorDepth(color_depth_t depth);
-    void setRotation(uint_fast8_t r) override;
-    void setInvert(bool invert) override {}
-    void setSleep(bool flg) override {}
-    void setPowerSave(bool) override {}
 
-    void waitDisplay(void) override {}
-    bool displayBusy(void) override { return false; }
+    /// The framebuffer's own format; it cannot be changed from here.
+    color_depth_t setColorDepth(color_depth_t depth) override { (void)depth; return _write_depth; }
 
-    void writePixels(pixelcopy_t* param, uint32_t len, bool use_dma) override;
-    void writeBlock(uint32_t rawcolor, uint32_t length) override;
+    /// Shows what was drawn since the last call, in buffer_copy and buffer_flip.
     void display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h) override;
-    void setWindow(uint_fast16_t xs, uint_fast16_t ys, uint_fast16_t xe, uint_fast16_t ye) override;
-    void drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor) override;
-    void writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor) override;
-    void writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool use_dma) override;
-    void writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param) override;
-
-    uint32_t readCommand(uint_fast16_t cmd, uint_fast8_t index, uint_fast8_t len) override { return 0; }
-    uint32_t readData(uint_fast8_t index, uint_fast8_t len) override { return 0; }
-    void readRect(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, void* dst, pixelcopy_t* param) override;
-    void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) override;
 
     uint_fast8_t getTouchRaw(touch_point_t* tp, uint_fast8_t count) override;
 
@@ -82,7 +82,14 @@ namespace lgfx
     void setDeviceName(const char* device_name) { _config_detail.device_name = device_name; };
 
     const config_detail_t& config_detail(void) const { return _config_detail; }
-    void config_detail(const config_detail_t& config_detail);
+    void config_detail(const config_detail_t& config_detail) { _config_detail = config_detail; }
+
+    /// The mode in use after init.
+    buffer_mode_t getBufferMode(void) const { return _buffer_mode; }
+
+    /// First byte and line stride of the page being shown.
+    const uint8_t* getVisibleBuffer(void) const { return _fbp + _visible_page * _page_bytes; }
+    size_t getLineLength(void) const { return _fix_info.line_length; }
 
   protected:
 
@@ -90,20 +97,25 @@ namespace lgfx
 
     touch_point_t _touch_point;
     // framebuffer
-    int _fbfd = 0;
-    char* _fbp = 0;
-    long int _screensize = 0;
+    int _fbfd = -1;
+    uint8_t* _fbp = nullptr;
+    size_t _screensize = 0;
+    size_t _page_bytes = 0;
     struct fb_var_screeninfo _var_info;
     struct fb_fix_screeninfo _fix_info;
-
-    int32_t _xpos = 0;
-    int32_t _ypos = 0;
-
-    void _rotate_pixelcopy(uint_fast16_t& x, uint_fast16_t& y, uint_fast16_t& w, uint_fast16_t& h, pixelcopy_t* param, uint32_t& nextx, uint32_t& nexty);
-
-  private:
-    void fb_draw_rgb_pixel(int x, int y, uint32_t rawcolor);
-    void fb_draw_argb_pixel(int x, int y, uint32_t rawcolor);
+    bool _is_file = false;
+
+    buffer_mode_t _buffer_mode = buffer_direct;
+    uint8_t* _back_buffer = nullptr;
+    uint8_t** _lines = nullptr;   // every drawable line; both pages in buffer_flip
+    uint_fast8_t _visible_page = 0;
+
+    bool open_device(void);
+    bool get_screen_info(void);
+    bool set_pages(uint_fast8_t pages);
+    bool pan_to(uint_fast8_t page);
+    void copy_modified(uint8_t** dst, uint8_t** src, const range_rect_t& r);
+    void release(void);
   };
 
 //----------------------------------------------------------------------------
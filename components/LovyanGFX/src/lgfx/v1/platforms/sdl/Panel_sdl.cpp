@@ -341,12 +341,10 @@ namespace lgfx
   Panel_sdl::~Panel_sdl(void)
   {
     _list_monitor.remove(&monitor);
-    SDL_DestroyMutex(_sdl_mutex);
   }
 
   Panel_sdl::Panel_sdl(void) : Panel_FrameBufferBase()
   {
-    _sdl_mutex = SDL_CreateMutex();
     _auto_display = true;
     monitor.panel = this;
   }
@@ -355,6 +353,7 @@ namespace lgfx
   {
     initFrameBuffer(_cfg.panel_width * 4, _cfg.panel_height);
     bool res = Panel_FrameBufferBase::init(use_reset);
+    mark_all_dirty();
 
     _list_monitor.push_back(&monitor);
 
@@ -379,59 +378,78 @@ namespace lgfx
     return depth;
   }
 
-  Panel_sdl::lock_t::lock_t(Panel_sdl* parent)
-  : _parent { parent }
+  /// Moves what the last primitive wrote into the area the update thread
+  /// uploads next. Runs after the pixels are written, so an area the update
+  /// thread has taken never misses them.
+  void Panel_sdl::publish_modified(void)
   {
-    SDL_LockMutex(parent->_sdl_mutex);
-  };
-
-  Panel_sdl::lock_t::~lock_t(void)
-  {
-    ++_parent->_modified_counter;
-    SDL_UnlockMutex(_parent->_sdl_mutex);
-    if (SDL_SemValue(_update_in_semaphore) < 2)
+    auto r = takeModifiedRange();
+    if (r.empty()) { return; }
+    uint64_t prev = _dirty.load(std::memory_order_relaxed);
+    uint64_t next;
+    do
+    {
+      int_fast16_t left   = std::min<int_fast16_t>(r.left  , (prev      ) & 0xFFFF);
+      int_fast16_t right  = std::max<int_fast16_t>(r.right , (prev >> 16) & 0xFFFF);
+      int_fast16_t top    = std::min<int_fast16_t>(r.top   , (prev >> 32) & 0xFFFF);
+      int_fast16_t bottom = std::max<int_fast16_t>(r.bottom, (prev >> 48) & 0xFFFF);
+      next = (uint64_t)left | (uint64_t)right << 16 | (uint64_t)top << 32 | (uint64_t)bottom << 48;
+    } while (!_dirty.compare_exchange_weak(prev, next, std::memory_order_release, std::memory_order_relaxed));
+    _modified_counter.fetch_add(1, std::memory_order_release);
+
+    // Wake the update thread once per batch rather than once per primitive
+    if (prev == DIRTY_NONE && SDL_SemValue(_update_in_semaphore) < 2)
     {
       SDL_SemPost(_update_in_semaphore);
-      if (!_in_step_exec) {
-        SDL_SemWaitTimeout(_update_out_semaphore, 1);
-      }
     }
-  };
+  }
+
+  void Panel_sdl::mark_all_dirty(void)
+  {
+    uint64_t all = (uint64_t)(_cfg.panel_width - 1) << 16 | (uint64_t)(_cfg.panel_height - 1) << 48;
+    _dirty.store(all, std::memory_order_release);
+    _modified_counter.fetch_add(1, std::memory_order_release);
+  }
 
   void Panel_sdl::drawPixelPreclipped(uint_fast16_t x, uint_fast16_t y, uint32_t rawcolor)
   {
-    lock_t lock(this);
     Panel_FrameBufferBase::drawPixelPreclipped(x, y, rawcolor);
+    publish_modified();
   }
 
   void Panel_sdl::writeFillRectPreclipped(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, uint32_t rawcolor)
   {
-    lock_t lock(this);
     Panel_FrameBufferBase::writeFillRectPreclipped(x, y, w, h, rawcolor);
+    publish_modified();
   }
 
   void Panel_sdl::writeBlock(uint32_t rawcolor, uint32_t length)
   {
-//    lock_t lock(this);
     Panel_FrameBufferBase::writeBlock(rawcolor, length);
   }
 
   void Panel_sdl::writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool use_dma)
   {
-    lock_t lock(this);
     Panel_FrameBufferBase::writeImage(x, y, w, h, param, use_dma);
+    publish_modified();
   }
 
   void Panel_sdl::writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param)
   {
-    lock_t lock(this);
     Panel_FrameBufferBase::writeImageARGB(x, y, w, h, param);
+    publish_modified();
   }
 
   void Panel_sdl::writePixels(pixelcopy_t* param, uint32_t len, bool use_dma)
   {
-    lock_t lock(this);
     Panel_FrameBufferBase::writePixels(param, len, use_dma);
+    publish_modified();
+  }
+
+  void Panel_sdl::copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y)
+  {
+    Panel_FrameBufferBase::copyRect(dst_x, dst_y, w, h, src_x, src_y);
+    publish_modified();
   }
 
   void Panel_sdl::display(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h)
@@ -539,6 +557,7 @@ namespace lgfx
     if (monitor.renderer == nullptr)
     {
       sdl_create(&monitor);
+      mark_all_dirty();
     }
 
     bool step_exec = _in_step_exec;
@@ -555,17 +574,27 @@ namespace lgfx
         pc.fp_copy = pixelcopy_t::copy_rgb_fast<bgr888_t, grayscale_t>;
       }
 
-      if (0 == SDL_LockMutex(_sdl_mutex))
+      // The counter first: anything it counts has already been merged into _dirty
+      _texupdate_counter = _modified_counter.load(std::memory_order_acquire);
+      uint64_t dirty = _dirty.exchange(DIRTY_NONE, std::memory_order_acquire);
+      int left   = (dirty      ) & 0xFFFF;
+      int right  = (dirty >> 16) & 0xFFFF;
+      int top    = (dirty >> 32) & 0xFFFF;
+      int bottom = (dirty >> 48) & 0xFFFF;
+      if (right >= _cfg.panel_width ) { right  = _cfg.panel_width  - 1; }
+      if (bottom >= _cfg.panel_height) { bottom = _cfg.panel_height - 1; }
+      if (left <= right && top <= bottom)
       {
-        _texupdate_counter = _modified_counter;
-        for (int y = 0; y < _cfg.panel_height; ++y)
+        // Only the drawn area is converted and uploaded. Rows being drawn
+        // meanwhile come back dirty and are converted again next time.
+        for (int y = top; y <= bottom; ++y)
         {
-          pc.src_x32 = 0;
+          pc.src_x32 = left;  // the fast copies count source pixels, not 32-bit fixed point
           pc.src_data = _lines_buffer[y];
-          pc.fp_copy(&_texturebuf[y * _cfg.panel_width], 0, _cfg.panel_width, &pc);
+          pc.fp_copy(&_texturebuf[y * _cfg.panel_width], left, right + 1, &pc);
         }
-        SDL_UnlockMutex(_sdl_mutex);
-        SDL_UpdateTexture(monitor.texture, nullptr, _texturebuf, _cfg.panel_width * sizeof(rgb888_t));
+        SDL_Rect rect = { left, top, right + 1 - left, bottom + 1 - top };
+        SDL_UpdateTexture(monitor.texture, &rect, &_texturebuf[top * _cfg.panel_width + left], _cfg.panel_width * sizeof(rgb888_t));
       }
     }
 
@@ -22,6 +22,7 @@ Porting for SDL:
 
 #include "common.hpp"
 #include <cstdint>
+#include <atomic>
 #if defined (SDL_h_)
 #include "../../panel/Panel_FrameBufferBase.hpp"
 #include "../../misc/range.hpp"
@@ -87,6 +88,7 @@ namespace lgfx
     void writeImage(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param, bool use_dma) override;
     void writeImageARGB(uint_fast16_t x, uint_fast16_t y, uint_fast16_t w, uint_fast16_t h, pixelcopy_t* param) override;
     void writePixels(pixelcopy_t* param, uint32_t len, bool use_dma) override;
+    void copyRect(uint_fast16_t dst_x, uint_fast16_t dst_y, uint_fast16_t w, uint_fast16_t h, uint_fast16_t src_x, uint_fast16_t src_y) override;
 
     uint_fast8_t getTouchRaw(touch_point_t* tp, uint_fast8_t count) override;
 
@@ -113,7 +115,6 @@ namespace lgfx
 
   protected:
     const char* _window_title = "LGFX Simulator";
-    SDL_mutex *_sdl_mutex = nullptr;
 
     void sdl_create(monitor_t * m);
     void sdl_update(void);
@@ -122,11 +123,18 @@ namespace lgfx
     monitor_t monitor;
 
     rgb888_t* _texturebuf = nullptr;
-    uint_fast16_t _modified_counter;
-    uint_fast16_t _texupdate_counter;
-    uint_fast16_t _display_counter;
+    std::atomic<uint32_t> _modified_counter { 0 };
+    uint32_t _texupdate_counter = 0;
+    uint32_t _display_counter = 0;
     bool _invalidated;
 
+    /// Area drawn but not yet uploaded, handed from the drawing thread to the
+    /// update thread without a lock: left, right, top, bottom in 16 bits each.
+    static constexpr uint64_t DIRTY_NONE = 0x0000FFFF0000FFFFull;
+    std::atomic<uint64_t> _dirty { DIRTY_NONE };
+    void publish_modified(void);
+    void mark_all_dirty(void);
+
     static void _event_proc(void);
     static void _update_proc(void);
     static void _update_scaling(monitor_t * m, float sx, float sy);
@@ -136,13 +144,6 @@ namespace lgfx
     void deinitFrameBuffer(void);
 
     static SDL_Keymod _keymod;
-
-    struct lock_t {
-      lock_t(Panel_sdl* parent);
-      ~lock_t();
-    protected:
-      Panel_sdl* _parent;
-    };
   };
 
 //----------------------------------------------------------------------------
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/* Stroke stream capture files
+ *
+ * A capture is the received packets in arrival order, each stored as a
+ * little-endian 16-bit length followed by the packet bytes.
+ */
+
+inline bool capture_write(FILE* fp, const uint8_t* data, size_t len) {
+    uint8_t hdr[2] = { (uint8_t)len, (uint8_t)(len >> 8) };
+    return fwrite(hdr, 1, 2, fp) == 2 && fwrite(data, 1, len, fp) == len;
+}
+
+// Returns the packet length, or 0 at end of file or on a truncated record.
+inline size_t capture_read(FILE* fp, uint8_t* buf, size_t max) {
+    uint8_t hdr[2];
+    if (fread(hdr, 1, 2, fp) != 2) return 0;
+    size_t len = hdr[0] | (hdr[1] << 8);
+    if (len == 0 || len > max) return 0;
+    return fread(buf, 1, len, fp) == len ? len : 0;
+}
@@ -0,0 +1,224 @@
+/* Linux framebuffer panel benchmark
+ *
+ * Draws the same frames through Panel_fb in each buffer mode, with a file
+ * mapped in place of /dev/fb0 at 16, 24 and 32 bpp, and into a sprite as the
+ * reference. Reports the time per frame, display() included, and checks the
+ * page shown after every display() equals the sprite.
+ *
+ *   fb_bench [-f file] [-n frames] [--device /dev/fbN]
+ *
+ * With --device the panel drives a real framebuffer, at its own depth,
+ * instead of the file and the comparison is skipped.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+#include <lgfx/v1/platforms/framebuffer/Panel_fb.hpp>
+
+static const int SCREEN_W = 480;
+static const int SCREEN_H = 320;
+
+using Clock = std::chrono::steady_clock;
+
+class FbDevice : public lgfx::LGFX_Device {
+public:
+    FbDevice(const char* path, lgfx::Panel_fb::buffer_mode_t mode, int bits) {
+        auto cfg = _panel.config();
+        cfg.memory_width = cfg.panel_width = SCREEN_W;
+        cfg.memory_height = cfg.panel_height = SCREEN_H;
+        _panel.config(cfg);
+        auto detail = _panel.config_detail();
+        detail.device_name = path;
+        detail.buffer_mode = mode;
+        detail.file_bits = bits;
+        _panel.config_detail(detail);
+        setPanel(&_panel);
+    }
+    lgfx::Panel_fb& panel(void) { return _panel; }
+
+private:
+    lgfx::Panel_fb _panel;
+};
+
+/* Frames */
+
+struct Scene {
+    const char* name;
+    std::function<void(LovyanGFX&, int)> frame;
+};
+
+static LGFX_Sprite* g_image;
+static lgfx::argb8888_t* g_alpha_image;  // 48x48, alpha rising left to right
+static const int ALPHA_SIZE = 48;
+
+static void fill_rects(LovyanGFX& g, int f) {
+    for (int i = 0; i < 64; i++) {
+        int x = (i * 53 + f * 7) % (SCREEN_W - 60);
+        int y = (i * 31 + f * 5) % (SCREEN_H - 40);
+        g.fillRect(x, y, 20 + i % 40, 10 + i % 30, g.color565(i * 4, f * 9, 255 - i * 4));
+    }
+}
+
+static void lines(LovyanGFX& g, int f) {
+    for (int i = 0; i < 64; i++) {
+        g.drawLine((i * 7 + f) % SCREEN_W, 0, SCREEN_W - 1 - (i * 11) % SCREEN_W, SCREEN_H - 1, g.color565(f * 20, i * 4, 128));
+    }
+}
+
+static void images(LovyanGFX& g, int f) {
+    for (int i = 0; i < 8; i++) {
+        g_image->pushSprite(&g, (i * 57 + f * 3) % (SCREEN_W - 64), (i * 37 + f) % (SCREEN_H - 64));
+    }
+}
+
+static void text(LovyanGFX& g, int f) {
+    g.setTextColor(TFT_WHITE, TFT_NAVY);
+    g.setFont(&fonts::Font2);
+    for (int i = 0; i < 12; i++) {
+        g.setCursor(8, 8 + i * 24);
+        g.printf("frame %d line %d: the quick brown fox", f, i);
+    }
+}
+
+// Blends over what is there, so the panel's pixels are read back
+static void alpha(LovyanGFX& g, int f) {
+    for (int i = 0; i < 8; i++) {
+        g.pushAlphaImage((i * 59 + f * 3) % (SCREEN_W - ALPHA_SIZE), (i * 41 + f) % (SCREEN_H - ALPHA_SIZE), ALPHA_SIZE, ALPHA_SIZE, g_alpha_image);
+    }
+}
+
+static void rotate_aa(LovyanGFX& g, int f) {
+    for (int i = 0; i < 4; i++) {
+        g_image->pushRotateZoomWithAA(&g, 60 + i * 110, 80 + (i & 1) * 150, f * 7 + i * 40, 0.8f + i * 0.3f, 1.1f);
+    }
+}
+
+// Copies blocks of the screen elsewhere through each read call
+static void read_back(LovyanGFX& g, int f) {
+    static uint16_t buf565[64 * 48];
+    static lgfx::rgb888_t buf888[64 * 48];
+    int x = (f * 13) % (SCREEN_W - 64), y = (f * 7) % (SCREEN_H - 48);
+    g.readRect(x, y, 64, 48, buf565);
+    g.pushImage((x + 200) % (SCREEN_W - 64), y, 64, 48, buf565);
+    g.readRectRGB(x, (y + 100) % (SCREEN_H - 48), 64, 48, (lgfx::bgr888_t*)buf888);
+    g.pushImage(x, (y + 150) % (SCREEN_H - 48), 64, 48, (lgfx::bgr888_t*)buf888);
+    for (int i = 0; i < 64; i++) {
+        int px = (i * 37 + f) % SCREEN_W, py = (i * 23 + f * 3) % SCREEN_H;
+        g.drawPixel((px + 7) % SCREEN_W, py, g.readPixel(px, py));
+    }
+}
+
+static void clear(LovyanGFX& g, int f) {
+    g.fillScreen(f & 1 ? TFT_DARKGREY : TFT_BLACK);
+}
+
+static const Scene SCENES[] = {
+    { "fill",  fill_rects },
+    { "lines", lines },
+    { "image", images },
+    { "text",  text },
+    { "alpha", alpha },
+    { "rotaa", rotate_aa },
+    { "read",  read_back },
+    { "clear", clear },
+};
+
+// The panel keeps red highest in native order, the sprite swaps bytes; both
+// are compared as RGB888, the sprite having the panel's precision
+static bool matches(const uint8_t* fb, size_t stride, int bits, LGFX_Sprite& ref, lgfx::bgr888_t* rgb) {
+    ref.readRectRGB(0, 0, SCREEN_W, SCREEN_H, rgb);
+    for (int y = 0; y < SCREEN_H; y++) {
+        const uint8_t* row = fb + y * stride;
+        for (int x = 0; x < SCREEN_W; x++, rgb++) {
+            uint32_t c;
+            if (bits == 16) c = lgfx::color_convert<lgfx::rgb888_t, lgfx::rgb565_t>(((const uint16_t*)row)[x]);
+            else c = row[x * bits / 8 + 2] << 16 | row[x * bits / 8 + 1] << 8 | row[x * bits / 8];
+            if (c != (uint32_t)(rgb->R8() << 16 | rgb->G8() << 8 | rgb->B8())) return false;
+        }
+    }
+    return true;
+}
+
+static const char* MODE_NAMES[] = { "direct", "copy", "flip" };
+
+int main(int argc, char** argv) {
+    const char* path = "fb_bench.bin";
+    const char* device = nullptr;
+    int frames = 200;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-f") && i + 1 < argc) path = argv[++i];
+        else if (!strcmp(argv[i], "-n") && i + 1 < argc) frames = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--device") && i + 1 < argc) device = argv[++i];
+    }
+
+    LGFX_Sprite image;
+    image.setColorDepth(16);
+    image.createSprite(64, 64);
+    for (int y = 0; y < 64; y++) image.drawFastHLine(0, y, 64, image.color565(y * 4, 255 - y * 4, 64));
+    image.fillCircle(32, 32, 20, TFT_YELLOW);
+    g_image = &image;
+    static lgfx::argb8888_t alpha_image[ALPHA_SIZE * ALPHA_SIZE];
+    for (int y = 0; y < ALPHA_SIZE; y++) {
+        for (int x = 0; x < ALPHA_SIZE; x++) {
+            int a = x == 0 ? 0 : x >= ALPHA_SIZE - 8 ? 255 : x * 255 / ALPHA_SIZE;
+            alpha_image[y * ALPHA_SIZE + x] = y < 16 ? lgfx::argb8888_t(a, 255, 0, 0) : lgfx::argb8888_t(a, y * 5, 255 - y * 5, x * 5);
+        }
+    }
+    g_alpha_image = alpha_image;
+    static lgfx::bgr888_t rgb[SCREEN_W * SCREEN_H];
+
+    bool ok = true;
+    for (int bits : { 16, 24, 32 }) {
+        if (device && bits != 16) break;  // a device has the one depth it was set up with
+        if (!device) printf("%d bpp\n", bits);
+        printf("%-6s", "mode");
+        for (const Scene& sc : SCENES) printf(" %8s", sc.name);
+        printf("   (us per frame)\n");
+        for (int m = lgfx::Panel_fb::buffer_direct; m <= lgfx::Panel_fb::buffer_flip; m++) {
+            if (!device) {
+                FILE* fp = fopen(path, "wb");
+                if (fp) fclose(fp);
+            }
+            FbDevice fb(device ? device : path, (lgfx::Panel_fb::buffer_mode_t)m, bits);
+            LGFX_Sprite ref;
+            ref.setColorDepth(bits == 16 ? 16 : 24);
+            if (!fb.init() || !ref.createSprite(SCREEN_W, SCREEN_H)) {
+                fprintf(stderr, "%s: init failed\n", MODE_NAMES[m]);
+                return 1;
+            }
+            ref.fillScreen(TFT_BLACK);
+            const char* name = MODE_NAMES[fb.panel().getBufferMode()];
+
+            printf("%-6s", name);
+            for (const Scene& sc : SCENES) {
+                double us = 0;
+                for (int f = 0; f < frames; f++) {
+                    auto t0 = Clock::now();
+                    fb.startWrite();
+                    sc.frame(fb, f);
+                    fb.endWrite();
+                    fb.display();
+                    us += std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+
+                    if (device) continue;
+                    sc.frame(ref, f);
+                    if (!matches(fb.panel().getVisibleBuffer(), fb.panel().getLineLength(), bits, ref, rgb)) {
+                        fprintf(stderr, "%d bpp %s/%s: frame %d differs from the sprite\n", bits, name, sc.name, f);
+                        ok = false;
+                        break;
+                    }
+                }
+                printf(" %8.1f", us / frames);
+                fflush(stdout);
+            }
+            printf("\n");
+        }
+    }
+    if (!device) remove(path);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,198 @@
+/* Render loop frame-time benchmark
+ *
+ * Runs SketchApp, the board's render loop, against a headless 480x320
+ * LGFX_Sprite standing in for the ILI9486, with scripted joystick and button
+ * traces on a virtual clock. Each scenario reports per-frame CPU time
+ * percentiles for its timed phase.
+ *
+ *   frame_bench [-n repeats] [--max-p99-us N]
+ *
+ * With --max-p99-us the exit status is non-zero if any scenario's p99 exceeds
+ * the budget, so the benchmark can gate a change.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include "sketch_app.hpp"
+
+static const int CENTER = 2048;
+static const int FULL = 2000;       // joystick deflection for top speed
+static const int FRAME_MS = 2;      // virtual clock step per frame
+
+enum : uint8_t {
+    BTN_DRAW  = 1 << 0,
+    BTN_COLOR = 1 << 1,
+    BTN_UNDO  = 1 << 2,
+    BTN_TOOL  = 1 << 3,
+};
+
+struct TraceFrame {
+    int16_t dx, dy;    // joystick offset from centre
+    uint8_t buttons;
+    bool timed;
+};
+
+/* Trace scripting */
+
+class Trace {
+public:
+    using Motion = std::function<void(int i, int& dx, int& dy)>;
+
+    // `frames` frames with `buttons` held and the joystick following `motion`.
+    Trace& hold(int frames, uint8_t buttons, Motion motion = nullptr, bool timed = true) {
+        for (int i = 0; i < frames; i++) {
+            int dx = 0, dy = 0;
+            if (motion) motion(i, dx, dy);
+            _frames.push_back({ (int16_t)dx, (int16_t)dy, buttons, timed });
+        }
+        return *this;
+    }
+    Trace& idle(int frames, bool timed = true) { return hold(frames, 0, nullptr, timed); }
+
+    // Press and release, long enough to pass the 20 ms debounce each way.
+    Trace& click(uint8_t button, bool timed = true) { return hold(15, button, nullptr, timed).idle(15, timed); }
+
+    const std::vector<TraceFrame>& frames(void) const { return _frames; }
+
+private:
+    std::vector<TraceFrame> _frames;
+};
+
+// Steers the cursor round a circle; a faster turn makes a smaller circle,
+// 2 / `turn` pixels across at full deflection.
+static Trace::Motion circle(int deflection, double turn) {
+    return [=](int i, int& dx, int& dy) {
+        dx = (int)(-deflection * sin(i * turn));
+        dy = (int)(deflection * cos(i * turn));
+    };
+}
+
+// Replays a trace as board inputs on a virtual clock.
+class ScriptedInput : public IInputSource {
+public:
+    explicit ScriptedInput(const Trace& trace) : _trace(trace) {}
+
+    bool done(void) const { return _index >= _trace.frames().size(); }
+    bool timed(void) const { return _trace.frames()[_index].timed; }
+
+    void read(InputState& in) override {
+        const TraceFrame& f = _trace.frames()[_index++];
+        _now_ms += FRAME_MS;
+        in.now_ms = _now_ms;
+        in.has_joy = true;
+        in.joy_x = CENTER + f.dx;
+        in.joy_y = CENTER + f.dy;
+        in.btn_draw  = f.buttons & BTN_DRAW;
+        in.btn_color = f.buttons & BTN_COLOR;
+        in.btn_undo  = f.buttons & BTN_UNDO;
+        in.btn_tool  = f.buttons & BTN_TOOL;
+    }
+
+private:
+    const Trace& _trace;
+    size_t _index = 0;
+    int64_t _now_ms = 0;
+};
+
+/* Scenarios */
+
+struct Scenario {
+    const char* name;
+    std::function<void(Trace&)> build;
+};
+
+static const Scenario SCENARIOS[] = {
+    { "cursor", [](Trace& t) {
+        t.hold(4000, 0, circle(FULL, 0.02));
+    } },
+    { "stroke", [](Trace& t) {
+        for (int s = 0; s < 8; s++) {
+            t.hold(500, BTN_DRAW, circle(FULL, 0.02 + s * 0.004));
+            t.click(BTN_TOOL, false);
+        }
+    } },
+    { "undo", [](Trace& t) {
+        for (int s = 0; s < 64; s++) t.hold(150, BTN_DRAW, circle(FULL, 0.02 + s * 0.001), false).idle(2, false);
+        for (int s = 0; s < 64; s++) t.click(BTN_UNDO);
+    } },
+    { "clear", [](Trace& t) {
+        for (int s = 0; s < 16; s++) {
+            t.hold(400, BTN_DRAW, circle(FULL, 0.02 + s * 0.003), false).idle(2, false);
+            t.hold(450, BTN_UNDO).idle(15);
+        }
+    } },
+    { "wheel", [](Trace& t) {
+        t.hold(200, BTN_COLOR, nullptr, false);
+        t.hold(4000, BTN_COLOR, [](int i, int& dx, int& dy) {
+            double r = FULL * (0.5 + 0.5 * sin(i * 0.003));
+            dx = (int)(r * cos(i * 0.02));
+            dy = (int)(r * sin(i * 0.02));
+        });
+        t.idle(15, false);
+    } },
+};
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[i];
+}
+
+int main(int argc, char** argv) {
+    int repeats = 3;
+    double max_p99_us = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) repeats = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--max-p99-us") && i + 1 < argc) max_p99_us = atof(argv[++i]);
+    }
+
+    bool over_budget = false;
+    printf("%-8s %8s %9s %9s %9s %9s %9s\n", "scenario", "frames", "mean_us", "p50_us", "p90_us", "p99_us", "max_us");
+    for (const Scenario& sc : SCENARIOS) {
+        Trace trace;
+        sc.build(trace);
+
+        std::vector<double> times;
+        for (int r = 0; r < repeats; r++) {
+            // Fresh app and screen per run so every run starts from a blank canvas
+            LGFX_Sprite screen;
+            screen.setColorDepth(16);
+            screen.createSprite(SketchApp::WIDTH, SketchApp::HEIGHT);
+            SketchApp* app = new SketchApp(&screen);
+            if (!app->init(CENTER, CENTER)) {
+                fprintf(stderr, "app init failed\n");
+                return 1;
+            }
+
+            ScriptedInput input(trace);
+            while (!input.done()) {
+                bool timed = input.timed();
+                InputState in;
+                input.read(in);
+                auto t0 = std::chrono::steady_clock::now();
+                app->frame(in);
+                auto t1 = std::chrono::steady_clock::now();
+                if (timed) times.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+            }
+            delete app;
+        }
+
+        std::sort(times.begin(), times.end());
+        double sum = 0;
+        for (double t : times) sum += t;
+        double p99 = percentile(times, 0.99);
+        printf("%-8s %8zu %9.2f %9.2f %9.2f %9.2f %9.2f\n", sc.name, times.size(), sum / times.size(),
+               percentile(times, 0.50), percentile(times, 0.90), p99, times.back());
+        if (max_p99_us > 0 && p99 > max_p99_us) over_budget = true;
+    }
+    return over_budget ? 1 : 0;
+}
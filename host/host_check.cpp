@@ -0,0 +1,915 @@
+/* Host checks
+ *
+ * Runs the firmware's portable modules and the LovyanGFX paths they rely on
+ * against references computed here, on the host: each check drives one module
+ * with known input and compares what comes out. Prints one line per check and
+ * exits non-zero if any fails.
+ *
+ *   host_check [name...]
+ *
+ * With names, only the checks whose name contains one of them run.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include "undo_history.hpp"
+#include "joystick_input.hpp"
+#include "color_wheel.hpp"
+#include "stroke_streamer.hpp"
+#include "diff_presenter.hpp"
+#include "gfx_bench.hpp"
+#include <lgfx/v1/panel/Panel_Headless.hpp>
+// JPEGs that ship with the LovyanGFX examples
+#include "../components/LovyanGFX/examples/Sprite/TransitionFX/assets.h"
+
+static bool fail(const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    fprintf(stderr, "  ");
+    vfprintf(stderr, fmt, ap);
+    fprintf(stderr, "\n");
+    va_end(ap);
+    return false;
+}
+
+/* Undo history */
+
+// A step that saved nothing, such as a pen-down without motion, must not
+// swallow an undo press: the press undoes the stroke before it, and with
+// only empty steps left there is nothing to undo.
+static bool check_undo() {
+    const int W = 40, H = 40;
+    static uint16_t canvas[W * H];
+    UndoHistory history;
+    if (!history.init(canvas, W, H, 2 * 9, 8)) return fail("init failed");
+    for (auto& p : canvas) p = 0x1111;
+
+    history.beginStep();
+    history.touch(5, 5, 20, 20);
+    for (int y = 5; y < 25; y++) for (int x = 5; x < 25; x++) canvas[y * W + x] = 0xF800;
+    history.beginStep();                  // pen down, no motion
+    history.beginStep();                  // reused, still empty
+    history.touch(-10, -10, 5, 5);        // off the canvas, saves nothing
+
+    UndoHistory::Rect dirty;
+    if (!history.undo(&dirty)) return fail("undo after an empty step did nothing");
+    if (dirty.w == 0 || dirty.h == 0) return fail("undo after an empty step restored no area");
+    for (int i = 0; i < W * H; i++) {
+        if (canvas[i] != 0x1111) return fail("pixel %d,%d not restored", i % W, i / W);
+    }
+    history.beginStep();
+    if (history.undo(&dirty)) return fail("undo with only an empty step left reported a change");
+    if (history.depth() != 0) return fail("%u steps left", (unsigned)history.depth());
+    return true;
+}
+
+/* Joystick input */
+
+// Feeds JoystickInput from FakeAdcSource as the input task would, without the task
+static bool check_joystick() {
+    int level_x = 1000, level_y = 3000;
+    FakeAdcSource source([&](int64_t, uint16_t& x, uint16_t& y) {
+        x = level_x;
+        y = level_y;
+    });
+    JoystickInput input;
+    JoystickInput::Config cfg;
+    if (!input.begin(&source, cfg)) return fail("begin failed");
+
+    // Steady input: one sample per `oversample` pairs, 1 ms apart, exact values
+    int count = 0;
+    int64_t prev_us = -1;
+    for (int i = 0; i < 50; i++) {
+        input.process(0);
+        JoystickSample s;
+        while (input.pop(s)) {
+            if (s.x != level_x || s.y != level_y) return fail("steady sample %d is %d,%d", count, s.x, s.y);
+            if (prev_us >= 0 && s.time_us - prev_us != 1000) return fail("samples %lld us apart", (long long)(s.time_us - prev_us));
+            prev_us = s.time_us;
+            count++;
+        }
+    }
+    int expected = 50 * 16 / cfg.oversample;
+    if (count != expected) return fail("%d samples from %d pairs, expected %d", count, 50 * 16, expected);
+
+    // Step: the IIR filter moves towards the new level without overshoot and
+    // settles within a few dozen samples
+    level_x = 3000;
+    level_y = 500;
+    int settled = -1;
+    JoystickSample prev = { 0, 1000, 3000 };
+    for (int i = 0; i < 20 && settled < 0; i++) {
+        input.process(0);
+        JoystickSample s;
+        while (input.pop(s)) {
+            if (s.x < prev.x || s.x > level_x || s.y > prev.y || s.y < level_y) return fail("step response overshoots at %d,%d", s.x, s.y);
+            prev = s;
+            count++;
+            if (settled < 0 && abs(s.x - level_x) <= 1 && abs(s.y - level_y) <= 1) settled = count;
+        }
+    }
+    if (settled < 0) return fail("step not settled, last sample %d,%d", prev.x, prev.y);
+    if (settled - expected > 40) return fail("step settled after %d samples", settled - expected);
+
+    // A stalled consumer loses the newest samples, counts them, and latest()
+    // still returns the newest one kept. The filter's integer step stops
+    // within one count of the level.
+    for (int i = 0; i < 200; i++) input.process(0);
+    if (input.dropped() == 0) return fail("a full ring dropped nothing");
+    JoystickSample s;
+    if (!input.latest(s) || abs(s.x - level_x) > 1 || abs(s.y - level_y) > 1) return fail("latest() after overflow is %d,%d", s.x, s.y);
+    if (input.pop(s)) return fail("latest() left samples in the ring");
+    return true;
+}
+
+/* Colour wheel */
+
+// The float mapping the integer bucketing replaced. `margin` is how close the
+// offset lies to a bucket edge, in degrees for hue and units for distance.
+static WheelBucket wheel_bucket_float(int dx, int dy, float& hue_margin, float& dist_margin) {
+    float dist = sqrtf((float)dx * dx + (float)dy * dy);
+    dist_margin = fabsf(dist - WHEEL_CENTER_DEADZONE);
+    hue_margin = 360.0f;
+    if (dist < WHEEL_CENTER_DEADZONE) return { 0, -1 };
+
+    float angle = atan2f(dy, dx) * 180.0f / (float)M_PI;
+    if (angle < 0) angle += 360.0f;
+    float steps = angle * WHEEL_HUE_STEPS / 360.0f + 0.5f;
+    int hue = (int)steps % WHEEL_HUE_STEPS;
+    hue_margin = fabsf(steps - roundf(steps)) * 360.0f / WHEEL_HUE_STEPS;
+
+    float factor = (dist - WHEEL_CENTER_DEADZONE) / WHEEL_FULL_RANGE;
+    if (factor < WHEEL_MIN_FACTOR) factor = WHEEL_MIN_FACTOR;
+    if (factor > 1.0f) factor = 1.0f;
+    float levels = (factor - WHEEL_MIN_FACTOR) * (WHEEL_LEVEL_STEPS - 1) / (1.0f - WHEEL_MIN_FACTOR) + 0.5f;
+    int level = (int)levels;
+    float edge = fabsf(levels - roundf(levels)) * (1.0f - WHEEL_MIN_FACTOR) / (WHEEL_LEVEL_STEPS - 1) * WHEEL_FULL_RANGE;
+    if (edge < dist_margin) dist_margin = edge;
+    return { (int8_t)hue, (int8_t)level };
+}
+
+// Every offset the 12-bit ADC can produce against the float mapping: they
+// may only disagree within 0.01 degrees or units of an edge, where the Q12
+// tangents (about 0.005 degrees) and float rounding decide. Every palette
+// entry against hsv_to_rgb565() evaluated at run time.
+static bool check_wheel() {
+    for (int dy = -2048; dy < 2048; dy++) {
+        for (int dx = -2048; dx < 2048; dx++) {
+            float hue_margin, dist_margin;
+            WheelBucket ref = wheel_bucket_float(dx, dy, hue_margin, dist_margin);
+            WheelBucket got = wheel_bucket(dx, dy);
+            bool centre = got.level < 0 || ref.level < 0;  // hue is meaningless there
+            bool hue_ok = got.hue == ref.hue || hue_margin <= 0.01f || centre;
+            bool level_ok = got.level == ref.level || dist_margin <= 0.01f;
+            if (!hue_ok || !level_ok) {
+                return fail("offset %d,%d: bucket %d/%d, float mapping %d/%d", dx, dy, got.hue, got.level, ref.hue, ref.level);
+            }
+        }
+    }
+
+    for (int light = 0; light < 2; light++) {
+        if (wheel_color({ 0, -1 }, light) != (light ? TFT_WHITE : TFT_BLACK)) return fail("centre colour wrong");
+        for (int hue = 0; hue < WHEEL_HUE_STEPS; hue++) {
+            for (int level = 0; level < WHEEL_LEVEL_STEPS; level++) {
+                volatile float angle = hue * (360.0f / WHEEL_HUE_STEPS);
+                float factor = WHEEL_MIN_FACTOR + level * (1.0f - WHEEL_MIN_FACTOR) / (WHEEL_LEVEL_STEPS - 1);
+                uint16_t ref = light ? hsv_to_rgb565(angle, factor, 1.0f) : hsv_to_rgb565(angle, 1.0f, factor);
+                uint16_t got = wheel_color({ (int8_t)hue, (int8_t)level }, light);
+                if (got != ref) return fail("%s hue %d level %d: %04x, expected %04x", light ? "light" : "dark", hue, level, got, ref);
+            }
+        }
+    }
+    return true;
+}
+
+/* Stroke streamer */
+
+// Keeps the pen position the receiver would reach from the packets sent
+class PositionSink : public IStreamTransport {
+public:
+    bool send(const uint8_t* data, size_t len) override {
+        stroke_stream::State start;
+        uint16_t seq;
+        return stroke_stream::parse_packet(data, len, &seq, &start, on_event, this);
+    }
+    int x = -1, y = -1;
+    int moves = 0;
+
+private:
+    static void on_event(const stroke_stream::Event&, const stroke_stream::State& after, void* user) {
+        PositionSink* sink = (PositionSink*)user;
+        sink->x = after.x;
+        sink->y = after.y;
+        sink->moves++;
+    }
+};
+
+// A burst of moves while the stream task is stalled leaves the last one
+// coalesced. Once the pen rests, idle() must hand it over after one
+// interval, and not before.
+static bool check_streamer() {
+    PositionSink sink;
+    StrokeStreamer streamer;
+    const uint32_t interval = 15;
+    streamer.begin(&sink, interval);
+
+    uint32_t now = 1000;
+    for (int i = 0; i < 200; i++) streamer.move(20 + i, 40 + i / 2, now);
+    if (streamer.stats().coalesced == 0) return fail("a stalled queue coalesced nothing");
+
+    streamer.process(now);
+    streamer.idle(now + interval - 1);
+    streamer.process(now + 2 * interval);
+    if (sink.moves == 0) return fail("queued moves were not sent");
+    if (sink.x == 20 + 199) return fail("last move sent before the interval passed");
+
+    streamer.idle(now + interval);
+    streamer.process(now + 4 * interval);
+    streamer.process(now + 5 * interval);
+    if (sink.x != 20 + 199 || sink.y != 40 + 199 / 2) return fail("pen at rest reported at %d,%d, expected %d,%d", sink.x, sink.y, 20 + 199, 40 + 199 / 2);
+
+    // Nothing is pending any more, so idle() sends nothing new
+    int moves = sink.moves;
+    streamer.idle(now + 10 * interval);
+    streamer.process(now + 12 * interval);
+    streamer.process(now + 13 * interval);
+    if (sink.moves != moves) return fail("idle() repeated a move");
+    return true;
+}
+
+/* Diff presenter */
+
+// Two changed pixels on a row are joined into one window when the unchanged
+// pixels between them cost no more than a window, and sent apart otherwise.
+static bool check_presenter() {
+    const int W = 64, H = 4;
+    const int gap = DiffPresenter::DEFAULT_WINDOW_COST / 2;
+    LGFX_Sprite canvas, panel;
+    for (LGFX_Sprite* s : { &canvas, &panel }) {
+        s->setColorDepth(16);
+        if (!s->createSprite(W, H)) return fail("allocation failed");
+        s->fillScreen(TFT_WHITE);
+    }
+    DiffPresenter presenter(&panel, &canvas);
+    if (!presenter.init()) return fail("init failed");
+
+    for (int between = gap - 1; between <= gap + 1; between++) {
+        canvas.drawPixel(4, 1, TFT_RED + between);
+        canvas.drawPixel(5 + between, 1, TFT_BLUE + between);
+        presenter.resetStats();
+        presenter.present(0, 0, W, H);
+        uint32_t expected = between <= gap ? 1 : 2;
+        if (presenter.stats().windows != expected) {
+            return fail("%d unchanged pixels between runs: %u windows, expected %u", between, presenter.stats().windows, expected);
+        }
+        if (memcmp(canvas.getBuffer(), panel.getBuffer(), W * H * 2)) return fail("panel differs from canvas");
+    }
+    return true;
+}
+
+/* Rotated sprite pushes */
+
+// Same sprite, but rotations are written row by row as on a panel
+class RowLoopSprite : public LGFX_Sprite {
+    int32_t affineTile_impl(void) const override { return 0; }
+};
+
+// Rotate-zoom pushes into sprites go through the tiled writer; they must match
+// the row loop byte for byte, including into sprites with their own rotation,
+// where Panel_Sprite rewrites the pixel copy's steps on every span.
+static bool check_affine() {
+    LGFX_Sprite small, large;
+    small.setColorDepth(16);
+    large.setColorDepth(16);
+    if (!small.createSprite(64, 48) || !large.createSprite(400, 300)) return fail("allocation failed");
+    for (LGFX_Sprite* s : { &small, &large }) {
+        for (int y = 0; y < s->height(); y++) s->drawFastHLine(0, y, s->width(), s->color888(y * 3, 255 - y, (y * 7) & 255));
+        for (int i = 0; i < 12; i++) s->fillCircle((i * 37) % s->width(), (i * 23) % s->height(), 6 + i, s->color888(i * 20, 0, 255 - i * 20));
+    }
+
+    static const float ANGLES[] = { 30.0f, 90.0f, 137.0f, 270.0f };
+    static const float ZOOMS[] = { 0.5f, 1.0f, 1.7f };
+    for (int bits : { 8, 16, 24 }) {
+        for (int rotation = 0; rotation < 8; rotation++) {
+            LGFX_Sprite tiled;
+            RowLoopSprite rows;
+            for (LGFX_Sprite* d : { &tiled, (LGFX_Sprite*)&rows }) {
+                d->setColorDepth(bits);
+                if (!d->createSprite(240, 200)) return fail("allocation failed");
+                d->setRotation(rotation);
+            }
+            for (LGFX_Sprite* src : { &small, &large }) {
+                for (float angle : ANGLES) {
+                    for (float zoom : ZOOMS) {
+                        for (int mode = 0; mode < 3; mode++) {
+                            for (LGFX_Sprite* d : { &tiled, (LGFX_Sprite*)&rows }) {
+                                d->fillScreen(TFT_DARKGREY);
+                                if (mode == 0) src->pushRotateZoom(d, 100, 90, angle, zoom, zoom);
+                                else if (mode == 1) src->pushRotateZoom(d, 100, 90, angle, zoom, zoom * 0.8f, TFT_WHITE);
+                                else d->pushImageRotateZoom(100, 90, src->width() / 2, src->height() / 2, angle, zoom, zoom,
+                                                             src->width(), src->height(), (const lgfx::swap565_t*)src->getBuffer());
+                            }
+                            if (memcmp(tiled.getBuffer(), rows.getBuffer(), tiled.bufferLength())) {
+                                return fail("%d bpp, rotation %d, %dx%d source at %.0f degrees x%.1f, mode %d: differs from the row loop",
+                                            bits, rotation, src->width(), src->height(), angle, zoom, mode);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/* Wide and wedge lines */
+
+// Coverage of one pixel as LGFXBase defines it: the distance to the tapered
+// capsule, evaluated with the same float operations, for every pixel.
+static uint8_t wedge_alpha(float ax, float ay, float bx, float by, float ar, float br, int xp, int yp) {
+    if (fabsf(ax - bx) < 0.01f && fabsf(ay - by) < 0.01f) bx += 0.01f;
+    float rdt = ar - br;
+    ar += 0.5f;
+    float xpax = xp - ax, ypay = yp - ay, bax = bx - ax, bay = by - ay;
+    float d = (xpax * bax + ypay * bay) / (bax * bax + bay * bay);
+    float h = d < 0.0f ? 0.0f : d > 1.0f ? 1.0f : d;
+    float dx = xpax - bax * h, dy = ypay - bay * h;
+    float a = ar - (sqrtf(dx * dx + dy * dy) + h * rdt);
+    if (a <= 1.0f / 32.0f) return 0;
+    return a > 1.0f - 1.0f / 32.0f ? 255 : (uint8_t)(a * 255.0f);
+}
+
+// White on black, so each channel is the blend of one coverage value. Thin
+// lines and wedges are included: under half a pixel no pixel is solid.
+static bool check_wedge() {
+    const int W = 96, H = 80;
+    LGFX_Sprite s;
+    s.setColorDepth(24);
+    if (!s.createSprite(W, H)) return fail("allocation failed");
+    auto* px = (const uint8_t*)s.getBuffer();
+
+    uint32_t seed = 11;
+    auto rnd = [&seed](uint32_t n) { seed = seed * 1664525u + 1013904223u; return (seed >> 8) % n; };
+    auto radius = [&]() { return rnd(4) == 0 ? 0.05f + rnd(60) * 0.01f : 0.25f * rnd(64); };
+    for (int i = 0; i < 6000; i++) {
+        int kind = rnd(3);
+        int ax = (int)rnd(W + 20) - 10, ay = (int)rnd(H + 20) - 10;
+        int bx = (int)rnd(W + 20) - 10, by = (int)rnd(H + 20) - 10;
+        if (kind == 2) { bx = ax; by = ay; }
+        float ar = radius(), br = kind == 1 ? radius() : ar;
+        s.fillScreen(TFT_BLACK);
+        if (kind == 0) s.drawWideLine(ax, ay, bx, by, ar, TFT_WHITE);
+        else if (kind == 1) s.drawWedgeLine(ax, ay, bx, by, ar, br, TFT_WHITE);
+        else s.drawSpot(ax, ay, ar, TFT_WHITE);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                int expect = (255 * (1 + wedge_alpha(ax, ay, bx, by, ar, br, x, y))) >> 8;
+                int got = px[(y * W + x) * 3];
+                if (got != expect) {
+                    return fail("%s (%d,%d)-(%d,%d) r %.2f/%.2f: pixel %d,%d is %d, coverage gives %d",
+                                kind == 0 ? "line" : kind == 1 ? "wedge" : "spot", ax, ay, bx, by, ar, br, x, y, got, expect);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/* VLW glyph cache */
+
+static const char* const TEXT[] = {
+    "The quick brown fox jumps over the lazy dog",
+    "0123456789 !\"#$%&'()*+,-./:;<=>?@[]^_`{|}~",
+    "Sphinx of black quartz, judge my vow. AAAA",
+};
+
+// Draws TEXT three times over, with and without a background and at two
+// sizes, so later passes find the glyphs the earlier ones cached.
+static void draw_text(LGFX_Sprite& s) {
+    s.fillScreen(TFT_DARKGREY);
+    for (int pass = 0; pass < 3; pass++) {
+        for (int i = 0; i < 3; i++) {
+            int y = pass * 100 + i * 30;
+            s.setTextSize(1 + (i & 1));
+            if (pass == 1) s.setTextColor(TFT_YELLOW, TFT_NAVY);
+            else s.setTextColor(pass ? TFT_CYAN : TFT_WHITE);
+            s.drawString(TEXT[i], 4 + pass * 3, y);
+        }
+    }
+    s.setTextSize(1);
+}
+
+// Text drawn through the glyph cache must match text drawn from the font
+// data directly, with a cache big enough for the font, one that fits about
+// one glyph and so evicts on almost every character, one smaller than most
+// glyphs, and a cache shrunk and regrown while the font stays loaded.
+static bool check_glyph_cache() {
+    size_t vlw_len = 0;
+    uint8_t* vlw = GfxBench::buildVlw(fonts::FreeSans12pt7b, &vlw_len);
+    if (!vlw) return fail("allocation failed");
+    size_t largest = 0;
+    for (const lgfx::GFXglyph* g = fonts::FreeSans12pt7b.glyph; g <= &fonts::FreeSans12pt7b.glyph[fonts::FreeSans12pt7b.last - fonts::FreeSans12pt7b.first]; g++) {
+        if ((size_t)g->width * g->height > largest) largest = (size_t)g->width * g->height;
+    }
+
+    bool ok = true;
+    LGFX_Sprite ref, got;
+    for (LGFX_Sprite* s : { &ref, &got }) {
+        s->setColorDepth(16);
+        if (!s->createSprite(480, 320)) ok = fail("allocation failed");
+    }
+    ref.setGlyphCache(0);
+    if (ok && !ref.loadFont(vlw)) ok = fail("loadFont failed");
+    if (ok) draw_text(ref);
+
+    struct { const char* name; size_t bytes; bool prewarm; } sizes[] = {
+        { "large",    64 * 1024,      true },
+        { "one",      largest + 64,   false },
+        { "tiny",     64,             false },
+    };
+    for (auto& sz : sizes) {
+        if (!ok) break;
+        got.setGlyphCache(sz.bytes, false);
+        if (!got.loadFont(vlw)) { ok = fail("loadFont failed"); break; }
+        if (sz.prewarm && got.prewarmGlyphs(0x20, 0x7E) == 0) ok = fail("%s cache: prewarm cached nothing", sz.name);
+        draw_text(got);
+        if (memcmp(ref.getBuffer(), got.getBuffer(), ref.bufferLength())) ok = fail("%s cache: text differs from uncached", sz.name);
+        got.unloadFont();
+    }
+    if (ok) {
+        got.setGlyphCache(64 * 1024, false);
+        got.loadFont(vlw);
+        draw_text(got);
+        got.setGlyphCache(largest + 64, false);
+        draw_text(got);
+        got.setGlyphCache(0);
+        draw_text(got);
+        got.setGlyphCache(8 * 1024, false);
+        draw_text(got);
+        if (memcmp(ref.getBuffer(), got.getBuffer(), ref.bufferLength())) ok = fail("resized cache: text differs from uncached");
+        got.unloadFont();
+    }
+    ref.unloadFont();
+    free(vlw);
+    return ok;
+}
+
+/* Text run cache */
+
+// One label per font family LovyanGFX has, the VLW one with graded alpha so
+// anti-aliased runs blend over their background colour.
+static bool check_text_cache() {
+    size_t vlw_len = 0;
+    uint8_t* vlw = GfxBench::buildVlw(fonts::FreeSans9pt7b, &vlw_len);
+    if (!vlw) return fail("allocation failed");
+    size_t glyphs = 24 + (fonts::FreeSans9pt7b.last - fonts::FreeSans9pt7b.first + 1) * 28;
+    for (size_t i = glyphs; i < vlw_len; i++) if (vlw[i]) vlw[i] = 40 + (i * 37) % 216;
+
+    static const struct { const char* name; const lgfx::IFont* font; } FONTS[] = {
+        { "Font0", &fonts::Font0 },
+        { "Font2", &fonts::Font2 },
+        { "Font4", &fonts::Font4 },
+        { "FreeSans9pt7b", &fonts::FreeSans9pt7b },
+        { "DejaVu18", &fonts::DejaVu18 },
+        { "vlw", nullptr },
+    };
+    // Black on white and white on black paint both all-zero and all-one
+    // pixels; equal colours leave the background showing through, so black
+    // ones need a transparent key other than zero.
+    static const struct { uint32_t fore, back; } COLORS[] = {
+        { 0x000000u, 0xFFFFFFu }, { 0xFFFFFFu, 0x000000u }, { 0xFFE000u, 0x000080u },
+        { 0x00FFFFu, 0x00FFFFu }, { 0x000000u, 0x000000u },
+    };
+    static const lgfx::textdatum_t DATUMS[] = { top_left, middle_center, bottom_right, baseline_left };
+    static const char* const LABELS[] = { "Brush 12", "Palette: Ocean", "g" };
+
+    bool ok = true;
+    for (int bits : { 8, 16, 24 }) {
+        LGFX_Sprite ref, got;
+        for (LGFX_Sprite* s : { &ref, &got }) {
+            s->setColorDepth(bits);
+            if (!s->createSprite(200, 60)) { ok = fail("allocation failed"); break; }
+        }
+        lgfx::TextRunCache cache(8 * 1024);
+        for (auto& f : FONTS) {
+            if (!ok) break;
+            for (LGFX_Sprite* s : { &ref, &got }) {
+                if (f.font) s->setFont(f.font);
+                else if (!s->loadFont(vlw)) { ok = fail("loadFont failed"); break; }
+            }
+            for (auto& c : COLORS) {
+                for (lgfx::textdatum_t datum : DATUMS) {
+                    for (int size = 1; size <= 2 && ok; size++) {
+                        for (const char* label : LABELS) {
+                            // the second draw of a label blits the run the first one cached
+                            for (int pass = 0; pass < 2 && ok; pass++) {
+                                int x = pass ? 170 : 100, y = 30;  // the second one past the right edge
+                                for (LGFX_Sprite* s : { &ref, &got }) {
+                                    for (int row = 0; row < 60; row++) s->drawFastHLine(0, row, 200, s->color888(row * 4, 255 - row * 4, 128));
+                                    s->setTextColor(c.fore, c.back);
+                                    s->setTextDatum(datum);
+                                    s->setTextSize(size);
+                                    s->setTextPadding(size == 2 ? 90 : 0);
+                                }
+                                int32_t want = ref.drawString(label, x, y);
+                                int32_t have = cache.drawString(&got, label, x, y);
+                                if (want != have || memcmp(ref.getBuffer(), got.getBuffer(), ref.bufferLength())) {
+                                    ok = fail("%d bpp, %s, %06x on %06x, datum %d, size %d, \"%s\" at %d: %s", bits, f.name, c.fore, c.back,
+                                              (int)datum, size, label, x, want != have ? "advance differs" : "pixels differ from drawString");
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            for (LGFX_Sprite* s : { &ref, &got }) {
+                if (f.font) s->setFont(&fonts::Font0);
+                else s->unloadFont();
+            }
+            cache.clear();
+        }
+        auto& st = cache.getStats();
+        if (ok && (st.hits == 0 || st.misses == 0 || st.evictions == 0)) {
+            ok = fail("%d bpp: %u hits, %u misses, %u evictions", bits, st.hits, st.misses, st.evictions);
+        }
+        if (ok && cache.getUsed() != 0) ok = fail("%d bpp: %u bytes still used after clear", bits, (unsigned)cache.getUsed());
+    }
+    free(vlw);
+    return ok;
+}
+
+/* Read-ahead */
+
+// Exposes where the window starts, so a seek can land just before it
+struct WindowedWrapper : public lgfx::BufferedDataWrapper {
+    uint32_t windowStart() const { return _base; }
+};
+
+// A temporary file holding `data`, positioned at its start; closing it deletes it
+static FILE* temp_file(const std::vector<uint8_t>& data) {
+    FILE* fp = tmpfile();
+    if (!fp) return nullptr;
+    if (fwrite(data.data(), 1, data.size(), fp) != data.size()) { fclose(fp); return nullptr; }
+    rewind(fp);
+    return fp;
+}
+
+// Drives `got` through `window` with reads of every size, seeks, skips and
+// peeks, and compares every result with PointerWrapper over the same bytes.
+static bool read_ahead_ops(const char* name, lgfx::DataWrapper* src, uint32_t window, const std::vector<uint8_t>& data) {
+    WindowedWrapper got;
+    if (!got.attach(src, window)) return fail("%s: attach failed", name);
+    lgfx::PointerWrapper ref(data.data(), data.size());
+    const int32_t length = data.size();
+    uint8_t a[6000], b[6000];
+    uint32_t seed = window;
+    auto rnd = [&seed](uint32_t n) { seed = seed * 1664525u + 1013904223u; return (seed >> 8) % n; };
+    int edge_seeks = 0;
+
+    for (int op = 0; op < 4000; op++) {
+        int kind = rnd(8);
+        const char* what = "";
+        if (kind == 0 || kind == 1) {
+            // Small reads, and now and then one bigger than the window
+            uint32_t len = rnd(10) ? rnd(200) : window + rnd(3000);
+            uint32_t required = kind ? rnd(len + 1) : len;
+            int n = kind ? got.read(a, len, required) : got.read(a, len);
+            int m = ref.read(b, len);
+            if (n != m || memcmp(a, b, n)) return fail("%s, %u window: read %u at %d gave %d bytes, expected %d", name, window, len, ref.tell() - m, n, m);
+            what = "read";
+        } else if (kind == 2) {
+            int32_t offset = rnd(length + 1);
+            if (!got.seek(offset)) return fail("%s, %u window: seek to %d failed", name, window, offset);
+            ref.seek(offset);
+            what = "seek";
+        } else if (kind == 3) {
+            // Just before the window, so the next read starts behind what is
+            // held; by seek or by a relative skip
+            int32_t start = got.windowStart();
+            if (start == 0) continue;
+            int32_t offset = start - 1 - (int32_t)rnd(std::min<int32_t>(start, 8));
+            if (rnd(2)) {
+                if (!got.seek(offset)) return fail("%s, %u window: seek back to %d failed", name, window, offset);
+            } else {
+                got.skip(offset - got.tell());
+            }
+            ref.seek(offset);
+            int n = got.read(a, 20);
+            int m = ref.read(b, 20);
+            if (n != m || memcmp(a, b, n)) return fail("%s, %u window: read after seeking back to %d differs", name, window, offset);
+            edge_seeks++;
+            what = "seek back";
+        } else if (kind == 4) {
+            int32_t pos = ref.tell();
+            int32_t offset = (int32_t)rnd(600 + window) - 300;
+            if (pos + offset < 0) offset = -pos;
+            if (pos + offset > length) offset = length - pos;
+            got.skip(offset);
+            ref.skip(offset);
+            what = "skip";
+        } else if (kind == 5) {
+            uint32_t len = rnd(window + 16);
+            const uint8_t* p = got.peek(len);
+            bool reachable = len <= window && (int32_t)len <= length - ref.tell();
+            if (!p != !reachable) return fail("%s, %u window: peek %u at %d %s", name, window, len, ref.tell(), p ? "should have failed" : "failed");
+            if (p && memcmp(p, &data[ref.tell()], len)) return fail("%s, %u window: peek %u at %d differs", name, window, len, ref.tell());
+            what = "peek";
+        } else {
+            // At the end nothing is read and neither result is defined
+            int32_t pos = ref.tell();
+            uint8_t x = got.read8();
+            uint8_t y = ref.read8();
+            if (pos < length && x != y) return fail("%s, %u window: read8 at %d differs", name, window, pos);
+            what = "read8";
+        }
+        if (got.tell() != ref.tell()) return fail("%s, %u window: after %s at op %d, tell() is %d, expected %d", name, window, what, op, got.tell(), ref.tell());
+    }
+    if (edge_seeks < 100) return fail("%s, %u window: only %d seeks across the window edge", name, window, edge_seeks);
+
+    // Detaching hands the source back at the position read up to
+    int32_t pos = got.tell();
+    got.read(a, 3);
+    got.seek(pos);
+    got.detach();
+    if (src->tell() != pos) return fail("%s, %u window: source at %d after detach, expected %d", name, window, src->tell(), pos);
+    return true;
+}
+
+// Writes `s` as an uncompressed BMP of 8 (RGB332 palette), 24 or 32 bits,
+// bottom-up or top-down
+static std::vector<uint8_t> make_bmp(LGFX_Sprite& s, int bits, bool top_down) {
+    int w = s.width(), h = s.height();
+    uint32_t stride = ((w * bits + 31) >> 5) << 2;
+    uint32_t palette = bits == 8 ? 256 * 4 : 0;
+    std::vector<uint8_t> v;
+    auto put16 = [&v](uint16_t x) { v.push_back(x); v.push_back(x >> 8); };
+    auto put32 = [&v](uint32_t x) { for (int i = 0; i < 4; i++) v.push_back(x >> (i * 8)); };
+    v.push_back('B'); v.push_back('M');
+    put32(54 + palette + stride * h); put32(0); put32(54 + palette);
+    put32(40); put32(w); put32(top_down ? -h : h); put16(1); put16(bits);
+    put32(0); put32(stride * h); put32(0); put32(0); put32(bits == 8 ? 256 : 0); put32(0);
+    if (bits == 8) {
+        for (int i = 0; i < 256; i++) {
+            lgfx::rgb332_t c;
+            c.raw = i;
+            v.push_back(c.B8()); v.push_back(c.G8()); v.push_back(c.R8()); v.push_back(0);
+        }
+    }
+    for (int row = 0; row < h; row++) {
+        int y = top_down ? row : h - 1 - row;
+        size_t start = v.size();
+        for (int x = 0; x < w; x++) {
+            auto c = s.readPixelRGB(x, y);
+            if (bits == 8) v.push_back(lgfx::color332(c.r, c.g, c.b));
+            else { v.push_back(c.b); v.push_back(c.g); v.push_back(c.r); if (bits == 32) v.push_back(255); }
+        }
+        v.resize(start + stride);
+    }
+    return v;
+}
+
+enum { SOURCE_MEMORY, SOURCE_FILE, SOURCE_MAPPED };
+
+// What each way of reading an image or font is checked with: a file read
+// directly, through a default and an odd-sized window, and mapped
+static const struct { const char* name; int source; uint32_t window; } READERS[] = {
+    { "file",        SOURCE_FILE,   0 },
+    { "window 2048", SOURCE_FILE,   2048 },
+    { "window 61",   SOURCE_FILE,   61 },
+    { "mapped",      SOURCE_MAPPED, 2048 },
+};
+
+// Wraps `data` as `source` reads it
+static lgfx::DataWrapper* open_source(int source, const std::vector<uint8_t>& data) {
+    if (source == SOURCE_MEMORY) return new lgfx::PointerWrapper(data.data(), data.size());
+    FILE* fp = temp_file(data);
+    if (!fp) return nullptr;
+    if (source == SOURCE_MAPPED) return new lgfx::MappedFileWrapper(fp);
+    return new lgfx::DataWrapperT<FILE>(fp);
+}
+
+// The BMP, PNG, QOI and JPG decoders and VLW fonts must draw the same
+// pixels from a file, with and without read-ahead, and from a mapped file, as
+// from memory; and the window itself must read, seek, skip and peek like the
+// source it wraps, across its edges, over memory, stdio and mapped sources.
+static bool check_read_ahead() {
+    std::vector<uint8_t> bytes(10000);
+    uint32_t seed = 1;
+    for (auto& x : bytes) { seed = seed * 1103515245u + 12345u; x = seed >> 16; }
+    for (uint32_t window : { 61u, 2048u }) {
+        for (int source : { SOURCE_MEMORY, SOURCE_FILE, SOURCE_MAPPED }) {
+            static const char* const NAMES[] = { "memory", "file", "mapped file" };
+            lgfx::DataWrapper* src = open_source(source, bytes);
+            if (!src) return fail("cannot open a temporary file");
+            bool ok = read_ahead_ops(NAMES[source], src, window, bytes);
+            src->close();
+            delete src;
+            if (!ok) return false;
+        }
+    }
+
+    LGFX_Sprite image;
+    image.setColorDepth(16);
+    if (!image.createSprite(320, 240)) return fail("allocation failed");
+    for (int y = 0; y < 240; y++) image.drawFastHLine(0, y, 320, image.color888(y, 128, 255 - y));
+    for (int i = 0; i < 20; i++) image.fillCircle((i * 71) % 320, (i * 43) % 240, 8 + i * 2, image.color888(i * 12, 255 - i * 12, i * 5));
+
+    struct Image { const char* name; std::vector<uint8_t> data; };
+    std::vector<Image> images;
+    size_t len = 0;
+    if (void* p = image.createPng(&len, 0, 0, 320, 240)) { images.push_back({ "PNG", std::vector<uint8_t>((uint8_t*)p, (uint8_t*)p + len) }); free(p); }
+    if (void* p = image.createQoi(&len, 0, 0, 320, 240)) { images.push_back({ "QOI", std::vector<uint8_t>((uint8_t*)p, (uint8_t*)p + len) }); free(p); }
+    if (images.size() != 2) return fail("encoding failed");
+    images.push_back({ "BMP 8", make_bmp(image, 8, false) });
+    images.push_back({ "BMP 24", make_bmp(image, 24, false) });
+    images.push_back({ "BMP 32", make_bmp(image, 32, true) });
+    images.push_back({ "JPG", std::vector<uint8_t>(dog_200_200_jpg, dog_200_200_jpg + sizeof(dog_200_200_jpg)) });
+    images.push_back({ "JPG with ICC", std::vector<uint8_t>(lgfx_logo_201x197_jpg, lgfx_logo_201x197_jpg + sizeof(lgfx_logo_201x197_jpg)) });
+
+    LGFX_Sprite ref, got;
+    for (LGFX_Sprite* s : { &ref, &got }) {
+        s->setColorDepth(16);
+        if (!s->createSprite(320, 240)) return fail("allocation failed");
+    }
+    // Whole, then clipped on the left and scaled down from an offset, which
+    // skips over parts of the data
+    auto draw = [](LGFX_Sprite& s, const Image& im, lgfx::DataWrapper* data, int variant) {
+        s.fillScreen(TFT_DARKGREY);
+        int x = variant ? -20 : 5, y = variant ? 7 : 3, off = variant ? 13 : 0;
+        float scale = variant ? 0.7f : 1.0f;
+        switch (im.name[0]) {
+        case 'P': return s.drawPng(data, x, y, 0, 0, off, off, scale, scale);
+        case 'Q': return s.drawQoi(data, x, y, 0, 0, off, off, scale, scale);
+        case 'B': return s.drawBmp(data, x, y, 0, 0, off, off, scale, scale);
+        default:  return s.drawJpg(data, x, y, 0, 0, off, off, scale, scale);
+        }
+    };
+    for (const Image& im : images) {
+        for (int variant = 0; variant < 2; variant++) {
+            lgfx::PointerWrapper memory(im.data.data(), im.data.size());
+            if (!draw(ref, im, &memory, variant)) return fail("%s: drawing from memory failed", im.name);
+            for (auto& reader : READERS) {
+                lgfx::DataWrapper* data = open_source(reader.source, im.data);
+                if (!data) return fail("cannot open a temporary file");
+                got.setReadAhead(reader.window);
+                bool ok = draw(got, im, data, variant);
+                data->close();
+                delete data;
+                if (!ok) return fail("%s from %s, variant %d: drawing failed", im.name, reader.name, variant);
+                if (memcmp(ref.getBuffer(), got.getBuffer(), ref.bufferLength())) return fail("%s from %s, variant %d: differs from memory", im.name, reader.name, variant);
+            }
+        }
+    }
+
+    // VLW fonts read their metrics through the window and, uncached, each
+    // glyph straight from the source
+    size_t vlw_len = 0;
+    uint8_t* vlw = GfxBench::buildVlw(fonts::FreeSans12pt7b, &vlw_len);
+    if (!vlw) return fail("allocation failed");
+    std::vector<uint8_t> font(vlw, vlw + vlw_len);
+    free(vlw);
+    for (LGFX_Sprite* s : { &ref, &got }) {
+        s->deleteSprite();
+        s->setGlyphCache(0);
+        if (!s->createSprite(480, 320)) return fail("allocation failed");
+    }
+    if (!ref.loadFont(font.data())) return fail("loadFont from memory failed");
+    draw_text(ref);
+    ref.unloadFont();
+    bool ok = true;
+    for (auto& reader : READERS) {
+        lgfx::DataWrapper* data = open_source(reader.source, font);
+        if (!data) return fail("cannot open a temporary file");
+        got.setReadAhead(reader.window);
+        if (!got.loadFont(data)) ok = fail("VLW from %s: loadFont failed", reader.name);
+        else {
+            draw_text(got);
+            if (memcmp(ref.getBuffer(), got.getBuffer(), ref.bufferLength())) ok = fail("VLW from %s: text differs from memory", reader.name);
+        }
+        got.unloadFont();
+        data->close();
+        delete data;
+        if (!ok) break;
+    }
+    return ok;
+}
+
+/* Modified range */
+
+class HeadlessDevice : public lgfx::LGFX_Device {
+public:
+    HeadlessDevice(int w, int h) {
+        auto cfg = _panel.config();
+        cfg.memory_width = cfg.panel_width = w;
+        cfg.memory_height = cfg.panel_height = h;
+        _panel.config(cfg);
+        setPanel(&_panel);
+    }
+    lgfx::Panel_Headless& panel(void) { return _panel; }
+
+private:
+    lgfx::Panel_Headless _panel;
+};
+
+// Panel_fb copies out and Panel_sdl uploads only the range the frame-buffer
+// panel reports, so every pixel a primitive changes must lie inside it, in
+// memory coordinates, at every rotation.
+static bool check_modified_range() {
+    static const char* const OPS[] = {
+        "fillRect", "drawPixel", "drawLine", "pushImage", "pushAlphaImage", "pushRotateZoomWithAA", "copyRect", "fillSmoothCircle",
+    };
+    const int W = 120, H = 90, OP_COUNT = sizeof(OPS) / sizeof(OPS[0]);
+    LGFX_Sprite image;
+    image.setColorDepth(16);
+    if (!image.createSprite(30, 20)) return fail("allocation failed");
+    image.fillScreen(TFT_BLUE);
+    image.fillCircle(15, 10, 8, TFT_YELLOW);
+    lgfx::argb8888_t alpha[24 * 24];
+    for (int i = 0; i < 24 * 24; i++) alpha[i] = lgfx::argb8888_t(i % 24 * 11, 255, i / 24 * 10, 40);
+
+    for (int bits : { 16, 24 }) {
+        for (int rotation = 0; rotation < 8; rotation++) {
+            HeadlessDevice dev(W, H);
+            dev.setColorDepth(bits);
+            if (!dev.init()) return fail("init failed");
+            dev.setRotation(rotation);
+            lgfx::Panel_Headless& panel = dev.panel();
+            const uint8_t* frame = (const uint8_t*)panel.getBuffer();
+            const int bytes = bits / 8;
+            std::vector<uint8_t> before(panel.getBufferLength());
+            srand(bits * 8 + rotation);
+            dev.startWrite();
+            for (int i = 0; i < 800; i++) {
+                int op = i % OP_COUNT;
+                int x = rand() % (dev.width() + 40) - 20, y = rand() % (dev.height() + 40) - 20;
+                int w = rand() % 40 + 1, h = rand() % 30 + 1;
+                uint32_t c = rand() | 0x010101;
+                panel.snapshot(before.data());
+                panel.takeModifiedRange();
+                switch (op) {
+                case 0: dev.fillRect(x, y, w, h, c); break;
+                case 1: dev.drawPixel(x, y, c); break;
+                case 2: dev.drawLine(x, y, x + w, y + h, c); break;
+                case 3: image.pushSprite(&dev, x, y); break;
+                case 4: dev.pushAlphaImage(x, y, 24, 24, alpha); break;
+                case 5: image.pushRotateZoomWithAA(&dev, x, y, rand() % 360, 0.7f + w / 40.0f, 1.2f); break;
+                case 6: dev.copyRect(x, y, w, h, x + 5, y + 3); break;
+                case 7: dev.fillSmoothCircle(x, y, h / 2, c); break;
+                }
+                auto r = panel.takeModifiedRange();
+                for (int py = 0; py < H; py++) {
+                    for (int px = 0; px < W; px++) {
+                        size_t at = (py * W + px) * bytes;
+                        if (!memcmp(&frame[at], &before[at], bytes)) continue;
+                        if (px < r.left || px > r.right || py < r.top || py > r.bottom) {
+                            return fail("%d bpp, rotation %d, %s: pixel %d,%d changed outside %d..%d x %d..%d",
+                                        bits, rotation, OPS[op], px, py, (int)r.left, (int)r.right, (int)r.top, (int)r.bottom);
+                        }
+                    }
+                }
+            }
+            dev.endWrite();
+        }
+    }
+    return true;
+}
+
+/* Runner */
+
+struct Check {
+    const char* name;
+    bool (*run)();
+};
+
+static const Check CHECKS[] = {
+    { "undo",     check_undo },
+    { "joystick", check_joystick },
+    { "wheel",    check_wheel },
+    { "streamer", check_streamer },
+    { "presenter", check_presenter },
+    { "affine",   check_affine },
+    { "wedge",    check_wedge },
+    { "glyph_cache", check_glyph_cache },
+    { "text_cache", check_text_cache },
+    { "read_ahead", check_read_ahead },
+    { "mod_range", check_modified_range },
+};
+
+int main(int argc, char** argv) {
+    int failed = 0;
+    for (const Check& c : CHECKS) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; i++) selected |= strstr(c.name, argv[i]) != nullptr;
+        if (!selected) continue;
+        bool ok = c.run();
+        printf("%-12s %s\n", c.name, ok ? "ok" : "FAILED");
+        fflush(stdout);
+        if (!ok) failed++;
+    }
+    return failed ? 1 : 0;
+}
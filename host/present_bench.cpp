@@ -0,0 +1,193 @@
+/* Diff presenter benchmark
+ *
+ * Replays scripted drawing on a 480x320 canvas and presents every change two
+ * ways into headless panels: each dirty rectangle pushed whole, as the app did
+ * before, and through DiffPresenter. Reports bytes on the wire, windows and
+ * the presenter's CPU time, and checks both panels end up equal to the canvas.
+ *
+ *   present_bench [-n repeats] [--window-cost bytes]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <functional>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include "diff_presenter.hpp"
+#include "dirty_region.hpp"
+#include "stroke_rasterizer.hpp"
+#include "undo_history.hpp"
+
+static const int CANVAS_W = 480;
+static const int CANVAS_H = 320;
+static const double SPI_HZ = 40e6;
+
+struct Totals {
+    uint32_t presents = 0;
+    uint64_t whole_bytes = 0;
+    uint64_t diff_bytes = 0;
+    uint64_t windows = 0;
+    double diff_us = 0;
+};
+
+class Bench {
+public:
+    explicit Bench(int window_cost) : _ink(CANVAS_W, CANVAS_H), _frame(CANVAS_W, CANVAS_H)
+    , _stroke(&_canvas, &_history, &_frame), _presenter(&_diffed, &_canvas), _window_cost(window_cost) {}
+
+    bool init(void) {
+        for (LGFX_Sprite* s : { &_canvas, &_whole, &_diffed }) {
+            s->setColorDepth(16);
+            if (!s->createSprite(CANVAS_W, CANVAS_H)) return false;
+            s->fillScreen(TFT_WHITE);
+        }
+        _presenter.setWindowCost(_window_cost);
+        return _presenter.init()
+            && _history.init((uint16_t*)_canvas.getBuffer(), CANVAS_W, CANVAS_H, 4096, 256);
+    }
+
+    // Draws a closed loop of `steps` segments, presenting every segment.
+    void stroke(int cx, int cy, int r, int radius, uint16_t color, int steps) {
+        _history.beginStep();
+        for (int i = 0; i <= steps; i++) {
+            double a = i * 2 * M_PI / steps;
+            int x = cx + (int)(r * cos(a));
+            int y = cy + (int)(r * 0.7 * sin(a * 2));
+            if (i == 0) _stroke.begin(x, y, radius, color);
+            else _stroke.extendTo(x, y, radius, color);
+            flushFrame();
+        }
+        _stroke.end();
+    }
+
+    void undo(void) {
+        UndoHistory::Rect r;
+        if (!_history.undo(&r)) return;
+        _frame.add(r.x, r.y, r.w, r.h);
+        flushFrame();
+    }
+
+    void clear(void) {
+        _history.beginStep();
+        for (int i = 0; i < _ink.count(); i++) {
+            const DirtyRegion::Rect& r = _ink[i];
+            _history.touch(r.x, r.y, r.w, r.h);
+            _canvas.fillRect(r.x, r.y, r.w, r.h, TFT_WHITE);
+            _frame.add(r.x, r.y, r.w, r.h);
+        }
+        _ink.clear();
+        flushFrame();
+    }
+
+    bool panelsMatch(void) const {
+        size_t len = CANVAS_W * CANVAS_H * sizeof(uint16_t);
+        return memcmp(_whole.getBuffer(), _canvas.getBuffer(), len) == 0
+            && memcmp(_diffed.getBuffer(), _canvas.getBuffer(), len) == 0;
+    }
+
+    Totals totals;
+
+private:
+    void flushFrame(void) {
+        for (int i = 0; i < _frame.count(); i++) {
+            const DirtyRegion::Rect& r = _frame[i];
+            _ink.add(r.x, r.y, r.w, r.h);
+
+            _whole.setClipRect(r.x, r.y, r.w, r.h);
+            _canvas.pushSprite(&_whole, 0, 0);
+            _whole.clearClipRect();
+            totals.whole_bytes += (uint64_t)r.w * r.h * sizeof(uint16_t) + _window_cost;
+
+            uint64_t before = _presenter.stats().bytes_sent;
+            uint32_t windows = _presenter.stats().windows;
+            auto t0 = std::chrono::steady_clock::now();
+            _presenter.present(r.x, r.y, r.w, r.h);
+            auto t1 = std::chrono::steady_clock::now();
+            totals.diff_us += std::chrono::duration<double, std::micro>(t1 - t0).count();
+            totals.diff_bytes += _presenter.stats().bytes_sent - before;
+            totals.windows += _presenter.stats().windows - windows;
+            totals.presents++;
+        }
+        _frame.clear();
+    }
+
+    LGFX_Sprite _canvas;
+    LGFX_Sprite _whole;
+    LGFX_Sprite _diffed;
+    UndoHistory _history;
+    DirtyRegion _ink;
+    DirtyRegion _frame;   // changed since the last present
+    StrokeRasterizer _stroke;
+    DiffPresenter _presenter;
+    int _window_cost;
+};
+
+/* Scenarios */
+
+struct Scenario {
+    const char* name;
+    std::function<void(Bench&)> setup;   // untimed
+    std::function<void(Bench&)> run;
+};
+
+static void draw_strokes(Bench& b, int count) {
+    static const uint16_t COLORS[] = { TFT_BLACK, TFT_RED, TFT_BLUE, TFT_DARKGREEN };
+    static const int RADII[] = { 2, 4, 8 };
+    for (int s = 0; s < count; s++) {
+        b.stroke(60 + (s * 37) % 360, 50 + (s * 23) % 220, 30 + s % 40, RADII[s % 3], COLORS[s % 4], 120);
+    }
+}
+
+static const Scenario SCENARIOS[] = {
+    { "stroke", nullptr, [](Bench& b) { draw_strokes(b, 32); } },
+    { "undo",   [](Bench& b) { draw_strokes(b, 32); }, [](Bench& b) { for (int i = 0; i < 32; i++) b.undo(); } },
+    { "clear",  [](Bench& b) { draw_strokes(b, 32); }, [](Bench& b) { b.clear(); } },
+};
+
+int main(int argc, char** argv) {
+    int repeats = 3;
+    int window_cost = DiffPresenter::DEFAULT_WINDOW_COST;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) repeats = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--window-cost") && i + 1 < argc) window_cost = atoi(argv[++i]);
+    }
+
+    bool ok = true;
+    printf("%-8s %8s %12s %12s %7s %9s %10s %10s %10s\n", "scenario", "presents", "whole_bytes", "diff_bytes",
+           "saved", "windows", "diff_us", "whole_ms", "diff_ms");
+    for (const Scenario& sc : SCENARIOS) {
+        Totals sum;
+        for (int r = 0; r < repeats; r++) {
+            Bench* bench = new Bench(window_cost);
+            if (!bench->init()) {
+                fprintf(stderr, "allocation failed\n");
+                return 1;
+            }
+            if (sc.setup) {
+                sc.setup(*bench);
+                bench->totals = Totals();
+            }
+            sc.run(*bench);
+            if (!bench->panelsMatch()) {
+                fprintf(stderr, "%s: panel differs from canvas\n", sc.name);
+                ok = false;
+            }
+            sum.presents += bench->totals.presents;
+            sum.whole_bytes += bench->totals.whole_bytes;
+            sum.diff_bytes += bench->totals.diff_bytes;
+            sum.windows += bench->totals.windows;
+            sum.diff_us += bench->totals.diff_us;
+            delete bench;
+        }
+        // Per run; the wire time assumes the bus is the only cost
+        double n = repeats;
+        printf("%-8s %8.0f %12.0f %12.0f %6.1f%% %9.0f %10.1f %10.2f %10.2f\n", sc.name, sum.presents / n,
+               sum.whole_bytes / n, sum.diff_bytes / n, 100.0 * (1.0 - (double)sum.diff_bytes / sum.whole_bytes),
+               sum.windows / n, sum.diff_us / n, sum.whole_bytes * 8e3 / SPI_HZ / n, sum.diff_bytes * 8e3 / SPI_HZ / n);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,83 @@
+/* LovyanGFX primitive microbenchmarks
+ *
+ * Runs GfxBench, the suite the firmware runs on the board, against 480x320
+ * sprites at 1, 2, 4, 8, 16 and 24 bpp and against Panel_Headless at 8, 16
+ * and 24 bpp. Prints ns per call, ns per pixel and pixels per second for each
+ * primitive, and writes the same results as Google Benchmark JSON so runs can
+ * be compared across releases.
+ *
+ *   primitive_bench [--min-time ms] [--filter name] [--depths 1,16,...] [--json file]
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+#include <lgfx/v1/panel/Panel_Headless.hpp>
+
+#include "gfx_bench.hpp"
+
+static const int SCREEN_W = 480;
+static const int SCREEN_H = 320;
+
+class HeadlessDevice : public lgfx::LGFX_Device {
+public:
+    HeadlessDevice(void) {
+        auto cfg = _panel.config();
+        cfg.memory_width = cfg.panel_width = SCREEN_W;
+        cfg.memory_height = cfg.panel_height = SCREEN_H;
+        _panel.config(cfg);
+        setPanel(&_panel);
+    }
+
+private:
+    lgfx::Panel_Headless _panel;
+};
+
+int main(int argc, char** argv) {
+    const char* json = nullptr;
+    const char* depths = "1,2,4,8,16,24";
+    GfxBench bench;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--min-time") && i + 1 < argc) bench.setMinTime(atoi(argv[++i]));
+        else if (!strcmp(argv[i], "--filter") && i + 1 < argc) bench.setFilter(argv[++i]);
+        else if (!strcmp(argv[i], "--depths") && i + 1 < argc) depths = argv[++i];
+        else if (!strcmp(argv[i], "--json") && i + 1 < argc) json = argv[++i];
+    }
+
+    int bits[8];
+    int count = 0;
+    for (const char* p = depths; *p && count < 8; p = strchr(p, ',') ? strchr(p, ',') + 1 : "") {
+        bits[count++] = atoi(p);
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (!bench.runSprite(SCREEN_W, SCREEN_H, bits[i], false)) {
+            fprintf(stderr, "%d bpp sprite: allocation failed\n", bits[i]);
+            return 1;
+        }
+    }
+    // The headless panel has no palette modes
+    for (int i = 0; i < count; i++) {
+        if (bits[i] < 8) continue;
+        HeadlessDevice dev;
+        dev.setColorDepth(bits[i]);
+        if (!dev.init() || !bench.run(&dev, "headless")) {
+            fprintf(stderr, "%d bpp headless panel: init failed\n", bits[i]);
+            return 1;
+        }
+    }
+
+    bench.printTable(stdout);
+    if (json) {
+        FILE* fp = fopen(json, "w");
+        if (!fp) {
+            fprintf(stderr, "%s: cannot write\n", json);
+            return 1;
+        }
+        bench.writeJson(fp);
+        fclose(fp);
+    }
+    return 0;
+}
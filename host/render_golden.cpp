@@ -0,0 +1,267 @@
+/* Golden-image rendering check
+ *
+ * Draws a fixed scene per LGFXBase primitive family into Panel_Headless at
+ * 8, 16 and 24 bpp, with no window or framebuffer device. Reports the time per
+ * scene and what reached the panel, per kind of panel call, and checks a
+ * second rendering of each scene matches the first byte for byte.
+ *
+ *   render_golden [-n repeats] [--write dir] [--check dir]
+ *
+ * --write saves each frame as <dir>/<scene>_<bits>.qoi and .png; --check
+ * re-encodes each frame and fails on any scene whose QOI differs from the one
+ * in <dir>, so goldens written on a known-good tree catch rendering changes.
+ * The goldens for this tree are in host/golden.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+#include <lgfx/v1/panel/Panel_Headless.hpp>
+
+static const int SCREEN_W = 480;
+static const int SCREEN_H = 320;
+
+using Clock = std::chrono::steady_clock;
+using lgfx::Panel_Headless;
+
+class HeadlessDevice : public lgfx::LGFX_Device {
+public:
+    HeadlessDevice(void) {
+        auto cfg = _panel.config();
+        cfg.memory_width = cfg.panel_width = SCREEN_W;
+        cfg.memory_height = cfg.panel_height = SCREEN_H;
+        _panel.config(cfg);
+        setPanel(&_panel);
+    }
+    Panel_Headless& panel(void) { return _panel; }
+
+private:
+    Panel_Headless _panel;
+};
+
+/* Scenes */
+
+struct Scene {
+    const char* name;
+    std::function<void(LovyanGFX&)> draw;
+};
+
+static LGFX_Sprite* g_image;
+
+static void shapes(LovyanGFX& g) {
+    for (int i = 0; i < 24; i++) {
+        int x = (i * 53) % (SCREEN_W - 80);
+        int y = (i * 31) % (SCREEN_H - 60);
+        uint32_t c = g.color888(i * 10, 255 - i * 10, 128);
+        switch (i % 6) {
+        case 0: g.fillRect(x, y, 60, 40, c); break;
+        case 1: g.drawRoundRect(x, y, 70, 50, 8, c); break;
+        case 2: g.fillCircle(x + 30, y + 30, 25, c); break;
+        case 3: g.fillTriangle(x, y + 50, x + 35, y, x + 70, y + 50, c); break;
+        case 4: g.fillEllipse(x + 35, y + 25, 35, 20, c); break;
+        case 5: g.fillArc(x + 30, y + 30, 28, 14, i * 15, i * 15 + 200, c); break;
+        }
+    }
+}
+
+static void lines(LovyanGFX& g) {
+    for (int i = 0; i < 48; i++) {
+        g.drawLine(i * 10, 0, SCREEN_W - 1 - i * 7, SCREEN_H - 1, g.color888(i * 5, 64, 255 - i * 5));
+        g.drawFastHLine(0, i * 6, SCREEN_W / 2, TFT_YELLOW);
+        g.drawFastVLine(SCREEN_W - 1 - i * 3, 0, SCREEN_H / 3, TFT_CYAN);
+    }
+}
+
+static void smooth(LovyanGFX& g) {
+    for (int i = 0; i < 12; i++) {
+        g.drawWideLine(20 + i * 35, 20, 460 - i * 30, 300, 1.5f + i * 0.5f, g.color888(255, i * 20, 0));
+        g.fillSmoothCircle(40 + i * 36, 160, 14, g.color888(0, i * 20, 255));
+        g.fillSmoothRoundRect(20 + i * 38, 250, 30, 40, 8, TFT_MAGENTA);
+    }
+}
+
+static void gradients(LovyanGFX& g) {
+    g.fillGradientRect(0, 0, SCREEN_W / 2, SCREEN_H / 2, lgfx::rgb888_t(255, 0, 0), lgfx::rgb888_t(0, 0, 255), lgfx::HLINEAR);
+    g.fillGradientRect(SCREEN_W / 2, 0, SCREEN_W / 2, SCREEN_H / 2, lgfx::rgb888_t(0, 255, 0), lgfx::rgb888_t(0, 0, 0), lgfx::VLINEAR);
+    g.fillGradientRect(0, SCREEN_H / 2, SCREEN_W, SCREEN_H / 2, lgfx::rgb888_t(255, 255, 0), lgfx::rgb888_t(0, 0, 128), lgfx::RADIAL);
+    g.drawGradientHLine(0, 10, SCREEN_W, lgfx::rgb888_t(255, 255, 255), lgfx::rgb888_t(0, 0, 0));
+}
+
+static void text(LovyanGFX& g) {
+    g.setTextColor(TFT_WHITE, TFT_NAVY);
+    g.setFont(&fonts::Font2);
+    for (int i = 0; i < 8; i++) {
+        g.setCursor(8, 8 + i * 20);
+        g.printf("line %d: the quick brown fox", i);
+    }
+    g.setFont(&fonts::FreeSansBold12pt7b);
+    g.setTextColor(TFT_ORANGE);
+    g.drawString("FreeSansBold12pt", 8, 180);
+    g.setFont(&fonts::DejaVu24);
+    g.setTextColor(TFT_GREEN);
+    g.drawString("DejaVu24", 8, 230);
+    g.setTextSize(2);
+    g.setFont(&fonts::Font0);
+    g.drawString("scaled Font0", 8, 280);
+    g.setTextSize(1);
+}
+
+static void images(LovyanGFX& g) {
+    for (int i = 0; i < 8; i++) {
+        g_image->pushSprite(&g, (i * 57) % (SCREEN_W - 64), (i * 37) % (SCREEN_H - 64));
+    }
+    g_image->pushSprite(&g, 400, 240, TFT_YELLOW);
+    g_image->pushRotateZoom(&g, 240, 160, 30.0f, 1.5f, 1.5f);
+    g.pushImage(0, SCREEN_H - 64, 64, 64, (const lgfx::swap565_t*)g_image->getBuffer());
+}
+
+static void copies(LovyanGFX& g) {
+    shapes(g);
+    g.copyRect(100, 60, 200, 120, 10, 10);
+    g.setScrollRect(0, 200, SCREEN_W, 120);
+    g.scroll(0, -30);
+    g.clearScrollRect();
+}
+
+static void pixels(LovyanGFX& g) {
+    for (int y = 0; y < SCREEN_H; y += 3) {
+        for (int x = (y / 3) % 4; x < SCREEN_W; x += 4) {
+            g.drawPixel(x, y, g.color888(x / 2, y, 200));
+        }
+    }
+}
+
+static const Scene SCENES[] = {
+    { "shapes",    shapes },
+    { "lines",     lines },
+    { "smooth",    smooth },
+    { "gradients", gradients },
+    { "text",      text },
+    { "images",    images },
+    { "copies",    copies },
+    { "pixels",    pixels },
+};
+
+static const char* OP_NAMES[] = { "pixel", "fill", "pixels", "image", "argb", "copy", "read" };
+
+static double render(HeadlessDevice& dev, const Scene& sc) {
+    auto t0 = Clock::now();
+    dev.startWrite();
+    dev.fillScreen(TFT_BLACK);
+    sc.draw(dev);
+    dev.endWrite();
+    return std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+}
+
+static bool read_file(const std::string& path, std::vector<uint8_t>& out) {
+    FILE* fp = fopen(path.c_str(), "rb");
+    if (!fp) return false;
+    fseek(fp, 0, SEEK_END);
+    out.resize(ftell(fp));
+    fseek(fp, 0, SEEK_SET);
+    bool ok = fread(out.data(), 1, out.size(), fp) == out.size();
+    fclose(fp);
+    return ok;
+}
+
+static bool write_file(const std::string& path, const void* data, size_t len) {
+    FILE* fp = fopen(path.c_str(), "wb");
+    if (!fp) return false;
+    bool ok = fwrite(data, 1, len, fp) == len;
+    fclose(fp);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    int repeats = 20;
+    const char* write_dir = nullptr;
+    const char* check_dir = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) repeats = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--write") && i + 1 < argc) write_dir = argv[++i];
+        else if (!strcmp(argv[i], "--check") && i + 1 < argc) check_dir = argv[++i];
+    }
+    if (repeats < 1) repeats = 1;
+
+    LGFX_Sprite image;
+    image.setColorDepth(16);
+    image.createSprite(64, 64);
+    for (int y = 0; y < 64; y++) image.drawFastHLine(0, y, 64, image.color565(y * 4, 255 - y * 4, 64));
+    image.fillCircle(32, 32, 20, TFT_YELLOW);
+    g_image = &image;
+
+    bool ok = true;
+    printf("%-4s %-10s %10s", "bpp", "scene", "us");
+    for (const char* op : OP_NAMES) printf(" %15s", op);
+    printf("   (calls/pixels per render)\n");
+    for (int bits : { 8, 16, 24 }) {
+        HeadlessDevice dev;
+        dev.setColorDepth(bits);
+        if (!dev.init()) {
+            fprintf(stderr, "%d bpp: init failed\n", bits);
+            return 1;
+        }
+        Panel_Headless& panel = dev.panel();
+        std::vector<uint8_t> first(panel.getBufferLength());
+
+        for (const Scene& sc : SCENES) {
+            panel.resetStats();
+            render(dev, sc);
+            panel.snapshot(first.data());
+            Panel_Headless::op_stats_t stats[Panel_Headless::op_max];
+            for (int op = 0; op < Panel_Headless::op_max; op++) stats[op] = panel.getStats((Panel_Headless::op_t)op);
+
+            double us = 0;
+            for (int r = 0; r < repeats; r++) us += render(dev, sc);
+            if (!panel.matches(first.data())) {
+                fprintf(stderr, "%d bpp/%s: rendering is not repeatable\n", bits, sc.name);
+                ok = false;
+            }
+
+            printf("%-4d %-10s %10.1f", bits, sc.name, us / repeats);
+            for (int op = 0; op < Panel_Headless::op_max; op++) {
+                char cell[32];
+                snprintf(cell, sizeof(cell), "%u/%llu", stats[op].calls, (unsigned long long)stats[op].pixels);
+                printf(" %15s", cell);
+            }
+            printf("\n");
+            fflush(stdout);
+
+            if (!write_dir && !check_dir) continue;
+            std::string base = std::string(write_dir ? write_dir : check_dir) + "/" + sc.name + "_" + std::to_string(bits);
+            size_t qoi_len = 0;
+            void* qoi = dev.createQoi(&qoi_len, 0, 0, SCREEN_W, SCREEN_H);
+            if (!qoi) {
+                fprintf(stderr, "%s: QOI encoding failed\n", base.c_str());
+                ok = false;
+                continue;
+            }
+            if (write_dir) {
+                size_t png_len = 0;
+                void* png = dev.createPng(&png_len, 0, 0, SCREEN_W, SCREEN_H);
+                if (!write_file(base + ".qoi", qoi, qoi_len) || !png || !write_file(base + ".png", png, png_len)) {
+                    fprintf(stderr, "%s: write failed\n", base.c_str());
+                    ok = false;
+                }
+                free(png);
+            } else {
+                std::vector<uint8_t> golden;
+                if (!read_file(base + ".qoi", golden)) {
+                    fprintf(stderr, "%s.qoi: missing\n", base.c_str());
+                    ok = false;
+                } else if (golden.size() != qoi_len || memcmp(golden.data(), qoi, qoi_len)) {
+                    fprintf(stderr, "%s.qoi: differs from the golden image\n", base.c_str());
+                    ok = false;
+                }
+            }
+            free(qoi);
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,231 @@
+/* UDP stroke stream sink
+ *
+ * Receives packets from the board, decodes them and checks the stream:
+ * sequence gaps, malformed packets, and that each packet header matches the
+ * state the previous packet left behind.
+ *
+ *   stream_sink [port]          listen for the board (default 5005)
+ *   stream_sink --loopback      stream a synthetic sketch to itself and verify it
+ *   -o <file>                   also record the packets for stroke_replay
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include "capture_file.hpp"
+#include "stroke_stream.hpp"
+#include "stroke_streamer.hpp"
+
+using namespace stroke_stream;
+
+struct SinkStats {
+    uint32_t packets = 0;
+    uint32_t bytes = 0;
+    uint32_t events = 0;
+    uint32_t moves = 0;
+    uint32_t strokes = 0;
+    uint32_t lost = 0;         // packets missing from the sequence
+    uint32_t malformed = 0;
+    uint32_t state_mismatch = 0;
+};
+
+static const char* event_name(uint8_t type) {
+    switch (type) {
+        case EV_MOVE:     return "move";
+        case EV_PEN_DOWN: return "pen-down";
+        case EV_PEN_UP:   return "pen-up";
+        case EV_BRUSH:    return "brush";
+        case EV_UNDO:     return "undo";
+        case EV_CLEAR:    return "clear";
+        default:          return "?";
+    }
+}
+
+static bool verbose = false;
+
+static void on_event(const Event& ev, const State& after, void* user) {
+    SinkStats* s = (SinkStats*)user;
+    s->events++;
+    if (ev.type == EV_MOVE) s->moves++;
+    if (ev.type == EV_PEN_DOWN) s->strokes++;
+    if (verbose && ev.type != EV_MOVE) {
+        printf("%8u ms  %-8s  (%d,%d) r=%d flags=%02x color=%04x\n", (unsigned)ev.time_ms, event_name(ev.type),
+               after.x, after.y, after.radius, after.flags, after.color);
+    }
+}
+
+class Sink {
+public:
+    void feed(const uint8_t* buf, size_t len) {
+        uint16_t seq;
+        State start;
+        _stats.packets++;
+        _stats.bytes += len;
+        if (!parse_packet(buf, len, &seq, &start, on_event, &_stats)) {
+            _stats.malformed++;
+            _synced = false;
+            return;
+        }
+
+        if (_synced) {
+            uint16_t expected = _next_seq;
+            if (seq != expected) {
+                _stats.lost += (uint16_t)(seq - expected);
+            } else if (memcmp(&start, &_end, sizeof(State)) != 0) {
+                _stats.state_mismatch++;
+            }
+        }
+
+        // Re-decode silently to learn the end state the next header must match
+        _end = start;
+        parse_packet(buf, len, nullptr, nullptr, [](const Event&, const State& after, void* user) {
+            *(State*)user = after;
+        }, &_end);
+        _next_seq = seq + 1;
+        _synced = true;
+    }
+
+    const SinkStats& stats(void) const { return _stats; }
+
+    void print(void) const {
+        printf("packets %u  bytes %u  events %u  moves %u  strokes %u  lost %u  malformed %u  state-mismatch %u\n",
+               _stats.packets, _stats.bytes, _stats.events, _stats.moves, _stats.strokes,
+               _stats.lost, _stats.malformed, _stats.state_mismatch);
+    }
+
+private:
+    SinkStats _stats;
+    State _end;
+    uint16_t _next_seq = 0;
+    bool _synced = false;
+};
+
+static int open_socket(uint16_t port) {
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) return -1;
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(sock, (const sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(sock);
+        return -1;
+    }
+    timeval tv = { 0, 200000 };
+    setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    return sock;
+}
+
+static uint32_t now_ms(void) {
+    using namespace std::chrono;
+    return (uint32_t)duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Plays a few strokes through the real streamer at render-loop pace.
+static void loopback_sender(uint16_t port, std::atomic<bool>* done, StrokeStreamer::Stats* out) {
+    UdpTransport transport;
+    StrokeStreamer streamer;
+    if (!transport.open("127.0.0.1", port)) {
+        *done = true;
+        return;
+    }
+    streamer.begin(&transport, 15);
+
+    std::atomic<bool> stop{false};
+    std::thread task([&] {
+        while (!stop) {
+            streamer.process(now_ms());
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        streamer.process(now_ms() + 1000);
+    });
+
+    static const uint16_t COLORS[] = { 0x0000, 0xF800, 0x07E0, 0x001F };
+    for (int s = 0; s < 8; s++) {
+        streamer.brush(2 + s, (s & 1) ? FLAG_ERASER : 0, COLORS[s & 3], now_ms());
+        for (int i = 0; i < 200; i++) {
+            int x = 240 + (int)(150 * cos((s * 200 + i) * 0.02));
+            int y = 160 + (int)(100 * sin((s * 200 + i) * 0.031));
+            streamer.move(x, y, now_ms());
+            if (i == 10) streamer.penDown(now_ms());
+            if (i == 190) streamer.penUp(now_ms());
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        if (s == 5) streamer.undo(now_ms());
+    }
+    streamer.clear(now_ms());
+
+    stop = true;
+    task.join();
+    *out = streamer.stats();
+    *done = true;
+}
+
+int main(int argc, char** argv) {
+    bool loopback = false;
+    uint16_t port = 5005;
+    FILE* record = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--loopback")) loopback = true;
+        else if (!strcmp(argv[i], "-v")) verbose = true;
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            record = fopen(argv[++i], "wb");
+            if (!record) {
+                perror(argv[i]);
+                return 1;
+            }
+        }
+        else port = (uint16_t)atoi(argv[i]);
+    }
+
+    int sock = open_socket(port);
+    if (sock < 0) {
+        perror("bind");
+        return 1;
+    }
+
+    Sink sink;
+    std::atomic<bool> done{false};
+    StrokeStreamer::Stats sent = {};
+    std::thread sender;
+    if (loopback) sender = std::thread(loopback_sender, port, &done, &sent);
+    else printf("Listening on UDP %u\n", port);
+
+    uint8_t buf[2048];
+    uint32_t last_report = now_ms();
+    for (;;) {
+        ssize_t n = recv(sock, buf, sizeof(buf), 0);
+        if (n > 0) {
+            sink.feed(buf, n);
+            if (record) {
+                capture_write(record, buf, n);
+                fflush(record);
+            }
+        } else if (loopback && done) break;
+
+        if (!loopback && now_ms() - last_report >= 1000) {
+            sink.print();
+            last_report = now_ms();
+        }
+    }
+    if (sender.joinable()) sender.join();
+    close(sock);
+    if (record) fclose(record);
+
+    sink.print();
+    printf("sent    %u  bytes %u  coalesced %u  dropped-events %u  dropped-packets %u\n",
+           sent.packets, sent.bytes, sent.coalesced, sent.dropped_events, sent.dropped_packets);
+
+    const SinkStats& s = sink.stats();
+    bool ok = s.packets == sent.packets && s.lost == 0 && s.malformed == 0 && s.state_mismatch == 0 && s.strokes == 8;
+    printf("%s\n", ok ? "stream OK" : "stream MISMATCH");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,288 @@
+/* Stroke stream replay
+ *
+ * Rebuilds the board's canvas from a recorded or live stroke stream with the
+ * firmware's own StrokeRasterizer, UndoHistory and DirtyRegion, so the result
+ * matches the panel pixel for pixel, and writes it out as PNG.
+ *
+ *   stroke_replay <capture> -o sketch.png     replay a stream_sink recording
+ *   stroke_replay --udp [port] -o sketch.png  replay live, PNG on every pen up
+ *   stroke_replay --synth <moves> -o out.png  replay a generated session
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include "capture_file.hpp"
+#include "stroke_stream.hpp"
+#include "stroke_rasterizer.hpp"
+#include "undo_history.hpp"
+#include "dirty_region.hpp"
+
+using namespace stroke_stream;
+
+// Must match the board's canvas and undo configuration in main.cpp
+static const int CANVAS_W = 480;
+static const int CANVAS_H = 320;
+static const size_t UNDO_ARENA_TILES = 4096;
+static const size_t MAX_UNDOS = 256;
+
+class Replayer {
+public:
+    Replayer(void) : _ink(CANVAS_W, CANVAS_H), _stroke(&_canvas, &_history, &_ink) {}
+
+    bool init(void) {
+        _canvas.setColorDepth(16);
+        if (!_canvas.createSprite(CANVAS_W, CANVAS_H)) return false;
+        _canvas.fillScreen(TFT_WHITE);
+        return _history.init((uint16_t*)_canvas.getBuffer(), CANVAS_W, CANVAS_H, UNDO_ARENA_TILES, MAX_UNDOS);
+    }
+
+    // Returns false on a malformed packet.
+    bool feed(const uint8_t* buf, size_t len) {
+        uint16_t seq;
+        State start;
+        // Decode the header alone first so a gap can be repaired before any event
+        if (!parse_packet(buf, len, &seq, &start, nullptr, nullptr)) return false;
+
+        if (_synced && seq != _next_seq) {
+            _lost += (uint16_t)(seq - _next_seq);
+            resync(start);
+        } else if (!_synced) {
+            resync(start);
+        }
+        _synced = true;
+        _next_seq = seq + 1;
+
+        _pen_ups = 0;
+        parse_packet(buf, len, nullptr, nullptr, [](const Event& ev, const State& after, void* user) {
+            ((Replayer*)user)->apply(ev, after);
+        }, this);
+        return true;
+    }
+
+    bool writePng(const char* path) {
+        size_t len = 0;
+        void* png = _canvas.createPng(&len, 0, 0, CANVAS_W, CANVAS_H);
+        if (!png) return false;
+        FILE* fp = fopen(path, "wb");
+        bool ok = fp && fwrite(png, 1, len, fp) == len;
+        if (fp) fclose(fp);
+        free(png);
+        return ok;
+    }
+
+    uint64_t events(void) const { return _events; }
+    uint32_t lost(void) const { return _lost; }
+    int penUpsInLastPacket(void) const { return _pen_ups; }
+
+private:
+    // A lost packet may have carried pen or brush changes; the next header
+    // holds the full state, so pick the stroke up again from there.
+    void resync(const State& start) {
+        _stroke.end();
+        if (start.flags & FLAG_PEN_DOWN) {
+            _history.beginStep();
+            _stroke.begin(start.x, start.y, start.radius, start.color);
+        }
+    }
+
+    // Mirrors the drawing, undo and clear paths of the render loop
+    void apply(const Event& ev, const State& s) {
+        _events++;
+        switch (ev.type) {
+            case EV_MOVE:
+                if (s.flags & FLAG_PEN_DOWN) _stroke.extendTo(s.x, s.y, s.radius, s.color);
+                break;
+            case EV_PEN_DOWN:
+                _history.beginStep();
+                _stroke.begin(s.x, s.y, s.radius, s.color);
+                break;
+            case EV_PEN_UP:
+                _stroke.end();
+                _pen_ups++;
+                break;
+            case EV_UNDO: {
+                UndoHistory::Rect dirty;
+                if (_history.undo(&dirty)) _ink.add(dirty.x, dirty.y, dirty.w, dirty.h);
+                break;
+            }
+            case EV_CLEAR:
+                _history.beginStep();
+                for (int i = 0; i < _ink.count(); i++) {
+                    const DirtyRegion::Rect& r = _ink[i];
+                    _history.touch(r.x, r.y, r.w, r.h);
+                    _canvas.fillRect(r.x, r.y, r.w, r.h, TFT_WHITE);
+                }
+                _ink.clear();
+                break;
+            default:
+                break;
+        }
+    }
+
+    LGFX_Sprite _canvas;
+    UndoHistory _history;
+    DirtyRegion _ink;
+    StrokeRasterizer _stroke;
+
+    bool _synced = false;
+    uint16_t _next_seq = 0;
+    uint64_t _events = 0;
+    uint32_t _lost = 0;
+    int _pen_ups = 0;
+};
+
+/* Synthetic sessions */
+
+// Packs a long wandering session the way the board's streamer would, with
+// one move per millisecond and a stroke every two seconds.
+static std::vector<std::vector<uint8_t>> synth_session(uint64_t moves) {
+    static const uint16_t COLORS[] = { TFT_BLACK, TFT_RED, TFT_BLUE, TFT_DARKGREEN };
+    static const int RADII[] = { 2, 4, 8 };
+
+    std::vector<std::vector<uint8_t>> packets;
+    PacketWriter packet;
+    State state;
+    uint16_t seq = 0;
+    packet.begin(seq++, state);
+
+    auto push = [&](const Event& ev) {
+        if (!packet.append(ev)) {
+            packets.emplace_back(packet.data(), packet.data() + packet.size());
+            packet.begin(seq++, state);
+            packet.append(ev);
+        }
+        state.apply(ev);
+    };
+
+    uint32_t packet_start = 0;
+    for (uint64_t i = 0; i < moves; i++) {
+        uint32_t t = (uint32_t)i;
+        if (i % 2000 == 0) {
+            int n = (int)(i / 2000);
+            if (n) push({ EV_PEN_UP, t, 0, 0, 0, 0, 0 });
+            if (n % 97 == 96) push({ EV_CLEAR, t, 0, 0, 0, 0, 0 });
+            else if (n % 7 == 6) push({ EV_UNDO, t, 0, 0, 0, 0, 0 });
+            push({ EV_BRUSH, t, 0, 0, (uint8_t)RADII[n % 3], 0, COLORS[n % 4] });
+        }
+        double a = i * 0.0021, b = i * 0.0013;
+        int x = 240 + (int)(200 * sin(a) * cos(b * 0.7));
+        int y = 160 + (int)(130 * cos(a * 1.3) * sin(b + 0.4));
+        if (x != state.x || y != state.y) push({ EV_MOVE, t, (int16_t)x, (int16_t)y, 0, 0, 0 });
+        if (i % 2000 == 100) push({ EV_PEN_DOWN, t, 0, 0, 0, 0, 0 });
+
+        // 15 ms packets, as the streamer sends them
+        if (t - packet_start >= 15 && packet.eventCount()) {
+            packets.emplace_back(packet.data(), packet.data() + packet.size());
+            packet.begin(seq++, state);
+            packet_start = t;
+        }
+    }
+    if (packet.eventCount()) packets.emplace_back(packet.data(), packet.data() + packet.size());
+    return packets;
+}
+
+/* Live UDP */
+
+static int open_socket(uint16_t port) {
+    int sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (sock < 0) return -1;
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(sock, (const sockaddr*)&addr, sizeof(addr)) != 0) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int main(int argc, char** argv) {
+    const char* input = nullptr;
+    const char* output = "sketch.png";
+    int udp_port = -1;
+    uint64_t synth = 0;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-o") && i + 1 < argc) output = argv[++i];
+        else if (!strcmp(argv[i], "--udp")) udp_port = (i + 1 < argc && argv[i + 1][0] != '-') ? atoi(argv[++i]) : 5005;
+        else if (!strcmp(argv[i], "--synth") && i + 1 < argc) synth = strtoull(argv[++i], nullptr, 10);
+        else input = argv[i];
+    }
+    if (!input && udp_port < 0 && !synth) {
+        fprintf(stderr, "usage: stroke_replay <capture> | --udp [port] | --synth <moves>  [-o out.png]\n");
+        return 2;
+    }
+
+    Replayer replayer;
+    if (!replayer.init()) {
+        fprintf(stderr, "canvas allocation failed\n");
+        return 1;
+    }
+
+    uint32_t malformed = 0;
+    uint64_t bytes = 0;
+    if (udp_port >= 0) {
+        int sock = open_socket(udp_port);
+        if (sock < 0) {
+            perror("bind");
+            return 1;
+        }
+        printf("Replaying UDP %d into %s\n", udp_port, output);
+        uint8_t buf[2048];
+        for (;;) {
+            ssize_t n = recv(sock, buf, sizeof(buf), 0);
+            if (n <= 0) continue;
+            if (!replayer.feed(buf, n)) malformed++;
+            // A finished stroke is a natural point to refresh the picture
+            if (replayer.penUpsInLastPacket() && !replayer.writePng(output)) perror(output);
+        }
+    }
+
+    std::vector<std::vector<uint8_t>> packets;
+    if (synth) {
+        packets = synth_session(synth);
+    } else {
+        FILE* fp = fopen(input, "rb");
+        if (!fp) {
+            perror(input);
+            return 1;
+        }
+        uint8_t buf[MAX_PACKET];
+        size_t n;
+        while ((n = capture_read(fp, buf, sizeof(buf))) != 0) packets.emplace_back(buf, buf + n);
+        fclose(fp);
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (const auto& p : packets) {
+        bytes += p.size();
+        if (!replayer.feed(p.data(), p.size())) malformed++;
+    }
+    double elapsed = seconds_since(t0);
+
+    printf("packets %zu  bytes %llu  events %llu  lost %u  malformed %u\n", packets.size(),
+           (unsigned long long)bytes, (unsigned long long)replayer.events(), replayer.lost(), malformed);
+    printf("replayed in %.3f s (%.2f Mevents/s)\n", elapsed, replayer.events() / elapsed / 1e6);
+
+    if (!replayer.writePng(output)) {
+        perror(output);
+        return 1;
+    }
+    printf("wrote %s\n", output);
+    return malformed ? 1 : 0;
+}
@@ -0,0 +1,25 @@
+#include "buttons.hpp"
+
+ButtonEvent Button::update(bool pressed, int64_t now_ms) {
+    if (pressed != _raw) {
+        _raw = pressed;
+        _raw_change_ms = now_ms;
+    }
+
+    // Level must stay put for the debounce window before it counts
+    if (_raw != _stable && now_ms - _raw_change_ms >= _debounce_ms) {
+        _stable = _raw;
+        if (_stable) {
+            _press_ms = now_ms;
+            _long_fired = false;
+            return ButtonEvent::Press;
+        }
+        return _long_fired ? ButtonEvent::LongRelease : ButtonEvent::Click;
+    }
+
+    if (_stable && !_long_fired && now_ms - _press_ms >= _long_press_ms) {
+        _long_fired = true;
+        return ButtonEvent::LongPress;
+    }
+    return ButtonEvent::None;
+}
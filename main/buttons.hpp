@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Debounced button state machine
+ *
+ * Feed the raw pin level every frame; update() reports at most one event.
+ * A press that is released before `long_press_ms` ends with Click, one held
+ * longer fires LongPress once while held and LongRelease when let go.
+ */
+enum class ButtonEvent : uint8_t {
+    None,
+    Press,        // debounced down edge
+    Click,        // released before the long-press threshold
+    LongPress,    // held past the threshold, fired once
+    LongRelease,  // released after LongPress
+};
+
+class Button {
+public:
+    Button(uint32_t long_press_ms, uint32_t debounce_ms = 20)
+    : _long_press_ms(long_press_ms), _debounce_ms(debounce_ms) {}
+
+    // `pressed` is the raw level already mapped to true = down.
+    ButtonEvent update(bool pressed, int64_t now_ms);
+
+    bool held(void) const { return _stable; }
+    bool longHeld(void) const { return _stable && _long_fired; }
+
+private:
+    uint32_t _long_press_ms;
+    uint32_t _debounce_ms;
+    bool _stable = false;      // debounced state
+    bool _raw = false;         // last raw level seen
+    bool _long_fired = false;
+    int64_t _raw_change_ms = 0;
+    int64_t _press_ms = 0;
+};
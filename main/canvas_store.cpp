@@ -0,0 +1,482 @@
+#include "canvas_store.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#include <lgfx/utility/lgfx_miniz.h>
+
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "esp_partition.h"
+static void* alloc_psram(size_t len) { return heap_caps_malloc(len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT); }
+static void free_psram(void* p) { heap_caps_free(p); }
+#else
+static void* alloc_psram(size_t len) { return malloc(len); }
+static void free_psram(void* p) { free(p); }
+#endif
+
+static const uint32_t MAGIC = 0x4B535454;  // "TTSK"
+static const uint16_t VERSION = 1;
+static const uint16_t COMMIT = 0xFFFE;
+static const uint16_t ERASED = 0xFFFF;
+static const uint16_t RAW_FLAG = 0x8000;
+
+// Few probes: tiles are small and mostly flat, and the save task shares the CPU
+static const int DEFLATE_FLAGS = 16 | TDEFL_GREEDY_PARSING_FLAG;
+
+static size_t align4(size_t n) { return (n + 3) & ~(size_t)3; }
+
+static uint32_t crc32(uint32_t crc, const void* data, size_t len) {
+    static const uint32_t NIBBLE[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = (crc >> 4) ^ NIBBLE[crc & 15];
+        crc = (crc >> 4) ^ NIBBLE[crc & 15];
+    }
+    return ~crc;
+}
+
+/* File storage */
+
+bool FileStorage::open(const char* path, size_t size, size_t erase_size) {
+    close();
+    _size = size;
+    _erase_size = erase_size;
+
+    _file = fopen(path, "r+b");
+    if (_file) {
+        fseek(_file, 0, SEEK_END);
+        if ((size_t)ftell(_file) == size) return true;
+        fclose(_file);
+    }
+    _file = fopen(path, "w+b");
+    if (!_file) return false;
+    if (!erase(0, size)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void FileStorage::close(void) {
+    if (_file) fclose(_file);
+    _file = nullptr;
+}
+
+bool FileStorage::read(size_t offset, void* dst, size_t len) {
+    if (!_file || offset + len > _size) return false;
+    return fseek(_file, offset, SEEK_SET) == 0 && fread(dst, 1, len, _file) == len;
+}
+
+// Like NOR flash, a write can only clear bits
+bool FileStorage::write(size_t offset, const void* src, size_t len) {
+    uint8_t buf[256];
+    const uint8_t* s = (const uint8_t*)src;
+    while (len) {
+        size_t n = len < sizeof(buf) ? len : sizeof(buf);
+        if (!read(offset, buf, n)) return false;
+        for (size_t i = 0; i < n; i++) buf[i] &= s[i];
+        if (fseek(_file, offset, SEEK_SET) != 0 || fwrite(buf, 1, n, _file) != n) return false;
+        offset += n;
+        s += n;
+        len -= n;
+    }
+    return fflush(_file) == 0;
+}
+
+bool FileStorage::erase(size_t offset, size_t len) {
+    if (!_file || offset % _erase_size || len % _erase_size || offset + len > _size) return false;
+    uint8_t buf[256];
+    memset(buf, 0xFF, sizeof(buf));
+    if (fseek(_file, offset, SEEK_SET) != 0) return false;
+    for (size_t done = 0; done < len; done += sizeof(buf)) {
+        size_t n = len - done < sizeof(buf) ? len - done : sizeof(buf);
+        if (fwrite(buf, 1, n, _file) != n) return false;
+    }
+    return fflush(_file) == 0;
+}
+
+#if defined(ESP_PLATFORM)
+/* Partition storage */
+
+bool PartitionStorage::open(const char* label) {
+    _partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    return _partition != nullptr;
+}
+
+size_t PartitionStorage::size(void) const {
+    return _partition ? ((const esp_partition_t*)_partition)->size : 0;
+}
+
+size_t PartitionStorage::eraseSize(void) const {
+    return _partition ? ((const esp_partition_t*)_partition)->erase_size : 4096;
+}
+
+bool PartitionStorage::read(size_t offset, void* dst, size_t len) {
+    return _partition && esp_partition_read((const esp_partition_t*)_partition, offset, dst, len) == ESP_OK;
+}
+
+bool PartitionStorage::write(size_t offset, const void* src, size_t len) {
+    return _partition && esp_partition_write((const esp_partition_t*)_partition, offset, src, len) == ESP_OK;
+}
+
+bool PartitionStorage::erase(size_t offset, size_t len) {
+    return _partition && esp_partition_erase_range((const esp_partition_t*)_partition, offset, len) == ESP_OK;
+}
+#endif
+
+/* Setup */
+
+bool CanvasStore::begin(ICanvasStorage* storage) {
+    release();
+    _storage = storage;
+    size_t unit = storage->eraseSize();
+    _bank_size = storage->size() / 2 / unit * unit;
+    return _bank_size > sizeof(BankHeader);
+}
+
+void CanvasStore::release(void) {
+    free(_hashes);
+    free(_tile);
+    free(_packed);
+    if (_deflate) free_psram(_deflate);
+    _hashes = nullptr;
+    _tile = nullptr;
+    _packed = nullptr;
+    _deflate = nullptr;
+    _need_full = true;
+}
+
+// Buffers wait for the canvas, which may be created after begin()
+bool CanvasStore::prepare(void) {
+    if (_hashes) return true;
+    if (!_storage || !_canvas->getBuffer() || _canvas->getColorDepth() != lgfx::rgb565_2Byte) return false;
+
+    _tiles_x = (_canvas->width() + TILE - 1) / TILE;
+    _tiles_y = (_canvas->height() + TILE - 1) / TILE;
+    _hashes = (uint32_t*)calloc(_tiles_x * _tiles_y, sizeof(uint32_t));
+    _tile = (uint16_t*)malloc(TILE * TILE * sizeof(uint16_t));
+    _packed = (uint8_t*)malloc(sizeof(RecordHeader) + TILE * TILE * sizeof(uint16_t));
+    _deflate = alloc_psram(sizeof(tdefl_compressor));
+    if (!_hashes || !_tile || !_packed || !_deflate) {
+        release();
+        return false;
+    }
+    return true;
+}
+
+/* Tiles */
+
+// Copies a tile out of the canvas into _tile; returns its size in bytes
+size_t CanvasStore::readTile(int tile) {
+    int width = _canvas->width();
+    int x = (tile % _tiles_x) * TILE;
+    int y = (tile / _tiles_x) * TILE;
+    int w = width - x < TILE ? width - x : TILE;
+    int h = _canvas->height() - y < TILE ? _canvas->height() - y : TILE;
+    const uint16_t* src = (const uint16_t*)_canvas->getBuffer() + (size_t)y * width + x;
+    for (int row = 0; row < h; row++) {
+        memcpy(&_tile[row * w], &src[(size_t)row * width], w * sizeof(uint16_t));
+    }
+    return (size_t)w * h * sizeof(uint16_t);
+}
+
+void CanvasStore::writeTile(int tile) {
+    int width = _canvas->width();
+    int x = (tile % _tiles_x) * TILE;
+    int y = (tile / _tiles_x) * TILE;
+    int w = width - x < TILE ? width - x : TILE;
+    int h = _canvas->height() - y < TILE ? _canvas->height() - y : TILE;
+    uint16_t* dst = (uint16_t*)_canvas->getBuffer() + (size_t)y * width + x;
+    for (int row = 0; row < h; row++) {
+        memcpy(&dst[(size_t)row * width], &_tile[row * w], w * sizeof(uint16_t));
+    }
+}
+
+uint32_t CanvasStore::hashTile(size_t len) const {
+    const uint32_t* p = (const uint32_t*)_tile;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len / 4; i++) h = (h ^ p[i]) * 16777619u;
+    return h;
+}
+
+/* Log records */
+
+// Deflates _tile into a record at `offset` of `bank`. False if it does not
+// fit or the write fails.
+bool CanvasStore::appendTile(int bank, int tile, size_t len, size_t* offset) {
+    uint8_t* payload = _packed + sizeof(RecordHeader);
+    size_t in_len = len;
+    size_t out_len = len;
+    tdefl_compressor* d = (tdefl_compressor*)_deflate;
+    tdefl_init(d, nullptr, nullptr, DEFLATE_FLAGS);
+    bool deflated = tdefl_compress(d, _tile, &in_len, payload, &out_len, TDEFL_FINISH) == TDEFL_STATUS_DONE
+                 && out_len < len;
+    if (!deflated) {
+        memcpy(payload, _tile, len);
+        out_len = len;
+    }
+
+    RecordHeader rh = { (uint16_t)tile, (uint16_t)(deflated ? out_len : (len | RAW_FLAG)), 0 };
+    rh.crc = crc32(crc32(0, &rh, offsetof(RecordHeader, crc)), payload, out_len);
+    memcpy(_packed, &rh, sizeof(rh));
+
+    size_t total = sizeof(rh) + out_len;
+    if (*offset + align4(total) > _bank_size) return false;
+    if (!_storage->write(bankBase(bank) + *offset, _packed, total)) return false;
+    *offset += align4(total);
+    _tiles_written.fetch_add(1, std::memory_order_relaxed);
+    _bytes_written.fetch_add(total, std::memory_order_relaxed);
+    return true;
+}
+
+bool CanvasStore::appendCommit(int bank, size_t* offset) {
+    RecordHeader rh = { COMMIT, 0, 0 };
+    rh.crc = crc32(0, &rh, offsetof(RecordHeader, crc));
+    if (*offset + sizeof(rh) > _bank_size) return false;
+    if (!_storage->write(bankBase(bank) + *offset, &rh, sizeof(rh))) return false;
+    *offset += sizeof(rh);
+    _bytes_written.fetch_add(sizeof(rh), std::memory_order_relaxed);
+    return true;
+}
+
+/* Restore */
+
+// Checks a bank's header and records. `commit_end` receives the end of its
+// last commit, `clean_end` whether only erased flash follows, and `latest`
+// the offset of each tile's newest committed record (0 if none).
+bool CanvasStore::scanBank(int bank, uint32_t* generation, size_t* commit_end, bool* clean_end, uint32_t* latest) {
+    size_t base = bankBase(bank);
+    BankHeader bh;
+    if (!_storage->read(base, &bh, sizeof(bh))) return false;
+    if (bh.magic != MAGIC || bh.version != VERSION || bh.tile != TILE
+     || bh.width != _canvas->width() || bh.height != _canvas->height()
+     || bh.crc != crc32(0, &bh, offsetof(BankHeader, crc))) return false;
+
+    int tiles = _tiles_x * _tiles_y;
+    memset(latest, 0, tiles * sizeof(uint32_t));
+    // Records of the save in progress; a save writes each tile once
+    uint16_t* pending_tile = (uint16_t*)malloc(tiles * sizeof(uint16_t));
+    uint32_t* pending_off = (uint32_t*)malloc(tiles * sizeof(uint32_t));
+    if (!pending_tile || !pending_off) {
+        free(pending_tile);
+        free(pending_off);
+        return false;
+    }
+    int pending = 0;
+
+    size_t off = sizeof(BankHeader);
+    size_t commit = 0;
+    bool clean = false;
+    while (off + sizeof(RecordHeader) <= _bank_size) {
+        RecordHeader rh;
+        if (!_storage->read(base + off, &rh, sizeof(rh))) break;
+        if (rh.tile == ERASED && rh.len == 0xFFFF && rh.crc == 0xFFFFFFFF) {
+            clean = true;
+            break;
+        }
+        if (rh.tile == COMMIT) {
+            if (rh.len != 0 || rh.crc != crc32(0, &rh, offsetof(RecordHeader, crc))) break;
+            for (int i = 0; i < pending; i++) latest[pending_tile[i]] = pending_off[i];
+            pending = 0;
+            off += sizeof(rh);
+            commit = off;
+            continue;
+        }
+
+        size_t len = rh.len & ~RAW_FLAG;
+        if (rh.tile >= tiles || len > TILE * TILE * sizeof(uint16_t) || pending == tiles) break;
+        uint8_t* payload = _packed + sizeof(RecordHeader);
+        if (!_storage->read(base + off + sizeof(rh), payload, len)) break;
+        if (rh.crc != crc32(crc32(0, &rh, offsetof(RecordHeader, crc)), payload, len)) break;
+        pending_tile[pending] = rh.tile;
+        pending_off[pending] = off;
+        pending++;
+        off += align4(sizeof(rh) + len);
+    }
+    free(pending_tile);
+    free(pending_off);
+
+    *generation = bh.generation;
+    *commit_end = commit;
+    *clean_end = clean && off == commit;
+    return commit != 0;
+}
+
+// Inflates each tile's newest record straight into the canvas
+bool CanvasStore::replayBank(int bank, const uint32_t* latest) {
+    lgfx_tinfl_decompressor* inflate = (lgfx_tinfl_decompressor*)malloc(sizeof(lgfx_tinfl_decompressor));
+    if (!inflate) return false;
+
+    bool ok = true;
+    for (int tile = 0; tile < _tiles_x * _tiles_y && ok; tile++) {
+        if (!latest[tile]) continue;
+        size_t off = bankBase(bank) + latest[tile];
+        RecordHeader rh;
+        ok = _storage->read(off, &rh, sizeof(rh));
+        size_t len = rh.len & ~RAW_FLAG;
+        uint8_t* payload = _packed + sizeof(RecordHeader);
+        ok = ok && _storage->read(off + sizeof(rh), payload, len);
+        if (!ok) break;
+
+        size_t expect = readTile(tile);  // for the tile's size
+        if (rh.len & RAW_FLAG) {
+            ok = len == expect;
+            if (ok) memcpy(_tile, payload, len);
+        } else {
+            size_t in_len = len;
+            size_t out_len = expect;
+            lgfx_tinfl_init(inflate);
+            ok = lgfx_tinfl_decompress(inflate, payload, &in_len, (uint8_t*)_tile, (uint8_t*)_tile, &out_len,
+                                       TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF) == TINFL_STATUS_DONE
+              && out_len == expect;
+        }
+        if (ok) writeTile(tile);
+    }
+    free(inflate);
+    return ok;
+}
+
+bool CanvasStore::restore(void) {
+    if (!prepare()) return false;
+
+    int tiles = _tiles_x * _tiles_y;
+    uint32_t* latest[2];
+    latest[0] = (uint32_t*)malloc(tiles * sizeof(uint32_t));
+    latest[1] = (uint32_t*)malloc(tiles * sizeof(uint32_t));
+    uint32_t generation[2];
+    size_t commit_end[2];
+    bool clean_end[2];
+    bool valid[2] = { false, false };
+    if (latest[0] && latest[1]) {
+        for (int b = 0; b < 2; b++) valid[b] = scanBank(b, &generation[b], &commit_end[b], &clean_end[b], latest[b]);
+    }
+
+    int best = -1;
+    if (valid[0] && valid[1]) best = (int32_t)(generation[1] - generation[0]) > 0 ? 1 : 0;
+    else if (valid[0]) best = 0;
+    else if (valid[1]) best = 1;
+
+    bool restored = best >= 0 && replayBank(best, latest[best]);
+    free(latest[0]);
+    free(latest[1]);
+
+    // Saves continue in the restored bank, or start a new one past it
+    _spare_erased = 0;
+    if (!restored) {
+        _need_full = true;
+        return false;
+    }
+    _bank = best;
+    _generation = generation[best];
+    _log_end = commit_end[best];
+    _need_full = !clean_end[best];
+    for (int tile = 0; tile < tiles; tile++) _hashes[tile] = hashTile(readTile(tile));
+    return true;
+}
+
+/* Save */
+
+// Writes every tile into the idle bank under the next generation and makes it
+// the active one. The old bank stays valid until this one has its commit.
+bool CanvasStore::compact(void) {
+    int target = 1 - _bank;
+    size_t base = bankBase(target);
+    bool ok = true;
+    if (_spare_erased < _bank_size) ok = _storage->erase(base + _spare_erased, _bank_size - _spare_erased);
+    _spare_erased = _bank_size;
+
+    BankHeader bh = { MAGIC, _generation + 1, (uint16_t)_canvas->width(), (uint16_t)_canvas->height(), TILE, VERSION, 0 };
+    bh.crc = crc32(0, &bh, offsetof(BankHeader, crc));
+    ok = ok && _storage->write(base, &bh, sizeof(bh));
+
+    size_t off = sizeof(bh);
+    for (int tile = 0; tile < _tiles_x * _tiles_y && ok; tile++) {
+        size_t len = readTile(tile);
+        _hashes[tile] = hashTile(len);
+        ok = appendTile(target, tile, len, &off);
+    }
+    ok = ok && appendCommit(target, &off);
+
+    if (!ok) {
+        // The idle bank holds a partial copy; erase it again next time
+        _spare_erased = 0;
+        _need_full = true;
+        _failures.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    _bank = target;
+    _generation++;
+    _log_end = off;
+    _spare_erased = 0;
+    _need_full = false;
+    _compactions.fetch_add(1, std::memory_order_relaxed);
+    _saves.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// One erase unit of the idle bank per save keeps compaction from erasing it all at once
+void CanvasStore::eraseStep(void) {
+    if (_spare_erased >= _bank_size) return;
+    size_t unit = _storage->eraseSize();
+    if (_storage->erase(bankBase(1 - _bank) + _spare_erased, unit)) _spare_erased += unit;
+}
+
+bool CanvasStore::save(void) {
+    if (!prepare()) return false;
+    if (_need_full) return compact();
+
+    eraseStep();
+    size_t off = _log_end;
+    bool wrote = false;
+    for (int tile = 0; tile < _tiles_x * _tiles_y; tile++) {
+        size_t len = readTile(tile);
+        uint32_t hash = hashTile(len);
+        if (hash == _hashes[tile]) continue;
+        // Out of room: what was appended is never committed
+        if (!appendTile(_bank, tile, len, &off)) return compact();
+        _hashes[tile] = hash;
+        wrote = true;
+    }
+    if (!wrote) return true;
+    if (!appendCommit(_bank, &off)) return compact();
+    _log_end = off;
+    _saves.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+CanvasStore::Stats CanvasStore::stats(void) const {
+    Stats s;
+    s.saves = _saves.load(std::memory_order_relaxed);
+    s.tiles_written = _tiles_written.load(std::memory_order_relaxed);
+    s.bytes_written = _bytes_written.load(std::memory_order_relaxed);
+    s.compactions = _compactions.load(std::memory_order_relaxed);
+    s.failures = _failures.load(std::memory_order_relaxed);
+    return s;
+}
+
+#if defined(ESP_PLATFORM)
+void CanvasStore::taskMain(void* arg) {
+    CanvasStore* store = (CanvasStore*)arg;
+    for (;;) {
+        vTaskDelay(pdMS_TO_TICKS(store->_interval_ms));
+        store->save();
+    }
+}
+
+bool CanvasStore::startTask(uint32_t interval_ms, int priority, int core) {
+    _interval_ms = interval_ms;
+    return xTaskCreatePinnedToCore(taskMain, "canvas_store", 6144, this, priority, nullptr, core) == pdPASS;
+}
+#else
+void CanvasStore::taskMain(void*) {}
+bool CanvasStore::startTask(uint32_t, int, int) { return false; }
+#endif
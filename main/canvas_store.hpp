@@ -0,0 +1,165 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <atomic>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+/* Canvas persistence
+ *
+ * Keeps the sketch in flash so a reset or power loss does not lose it. The
+ * storage is split into two banks, each an append-only log of deflated
+ * TILE x TILE blocks. A save appends the tiles that changed since they were
+ * last written, then a commit record. When the active bank is full, the other
+ * one is restarted with every tile under a newer generation number.
+ *
+ * Restore picks the newest bank with a commit and replays it up to its last
+ * commit, so a save cut short by power loss is dropped as a whole. Changed
+ * tiles are found by hashing the canvas rather than reported by the drawing
+ * code, so nothing the render loop does can be missed. A tile read while it
+ * was being drawn hashes differently afterwards and goes out again next save.
+ *
+ * Flash writes and erases stall the cache, and with it PSRAM, on both cores.
+ * Saves write a few small records. The idle bank is erased one sector per
+ * save long before it is needed.
+ */
+
+// Behaves like NOR flash: erase() sets whole erase units to 0xFF, write()
+// can only clear bits.
+class ICanvasStorage {
+public:
+    virtual ~ICanvasStorage(void) = default;
+    virtual size_t size(void) const = 0;
+    virtual size_t eraseSize(void) const = 0;
+    virtual bool read(size_t offset, void* dst, size_t len) = 0;
+    virtual bool write(size_t offset, const void* src, size_t len) = 0;
+    virtual bool erase(size_t offset, size_t len) = 0;
+};
+
+// A fixed-size file standing in for flash. Host tests, or a file on a
+// mounted filesystem on the board.
+class FileStorage : public ICanvasStorage {
+public:
+    ~FileStorage(void) override { close(); }
+
+    // Creates the file erased if it is missing or the wrong size.
+    bool open(const char* path, size_t size, size_t erase_size = 4096);
+    void close(void);
+
+    size_t size(void) const override { return _size; }
+    size_t eraseSize(void) const override { return _erase_size; }
+    bool read(size_t offset, void* dst, size_t len) override;
+    bool write(size_t offset, const void* src, size_t len) override;
+    bool erase(size_t offset, size_t len) override;
+
+private:
+    FILE* _file = nullptr;
+    size_t _size = 0;
+    size_t _erase_size = 4096;
+};
+
+#if defined(ESP_PLATFORM)
+// A raw data partition, found by label.
+class PartitionStorage : public ICanvasStorage {
+public:
+    bool open(const char* label);
+
+    size_t size(void) const override;
+    size_t eraseSize(void) const override;
+    bool read(size_t offset, void* dst, size_t len) override;
+    bool write(size_t offset, const void* src, size_t len) override;
+    bool erase(size_t offset, size_t len) override;
+
+private:
+    const void* _partition = nullptr;  // esp_partition_t, kept opaque
+};
+#endif
+
+class CanvasStore {
+public:
+    static constexpr int TILE = 32;
+
+    struct Stats {
+        uint32_t saves;          // saves that wrote anything
+        uint32_t tiles_written;
+        uint32_t bytes_written;  // records, headers included
+        uint32_t compactions;    // bank switches
+        uint32_t failures;
+    };
+
+    explicit CanvasStore(LGFX_Sprite* canvas) : _canvas(canvas) {}
+    ~CanvasStore(void) { release(); }
+
+    // Storage must hold two banks, each fitting the whole canvas compressed.
+    bool begin(ICanvasStorage* storage);
+    void release(void);
+
+    // Loads the last committed save into the canvas. False, with the canvas
+    // untouched, when the storage holds no save of a canvas this size.
+    bool restore(void);
+
+    // Writes the tiles that changed since the last save. Body of the save task.
+    bool save(void);
+
+    // Runs save() every `interval_ms` on a dedicated FreeRTOS task.
+    bool startTask(uint32_t interval_ms, int priority, int core);
+
+    Stats stats(void) const;
+
+private:
+    struct BankHeader {
+        uint32_t magic;
+        uint32_t generation;
+        uint16_t width;
+        uint16_t height;
+        uint16_t tile;
+        uint16_t version;
+        uint32_t crc;
+    };
+    struct RecordHeader {
+        uint16_t tile;   // index, or COMMIT
+        uint16_t len;    // payload bytes, RAW_FLAG if stored uncompressed
+        uint32_t crc;    // over tile, len and payload
+    };
+
+    bool prepare(void);
+    bool scanBank(int bank, uint32_t* generation, size_t* commit_end, bool* clean_end, uint32_t* latest);
+    bool replayBank(int bank, const uint32_t* latest);
+    bool compact(void);
+    void eraseStep(void);
+    bool appendTile(int bank, int tile, size_t len, size_t* offset);
+    bool appendCommit(int bank, size_t* offset);
+    size_t readTile(int tile);
+    void writeTile(int tile);
+    uint32_t hashTile(size_t len) const;
+    static void taskMain(void* arg);
+    size_t bankBase(int bank) const { return (size_t)bank * _bank_size; }
+
+    LGFX_Sprite* _canvas;
+    ICanvasStorage* _storage = nullptr;
+    size_t _bank_size = 0;
+
+    int _tiles_x = 0;
+    int _tiles_y = 0;
+    uint32_t* _hashes = nullptr;  // of each tile as last written
+    uint16_t* _tile = nullptr;    // TILE x TILE pixels, packed to the tile's width
+    uint8_t* _packed = nullptr;   // record being written or read
+    void* _deflate = nullptr;     // tdefl_compressor
+
+    int _bank = 0;                // active bank
+    uint32_t _generation = 0;
+    size_t _log_end = 0;          // next free byte in the active bank
+    size_t _spare_erased = 0;     // bytes of the idle bank erased so far
+    bool _need_full = true;       // the next save starts a new bank
+
+    uint32_t _interval_ms = 5000;
+
+    std::atomic<uint32_t> _saves{0};
+    std::atomic<uint32_t> _tiles_written{0};
+    std::atomic<uint32_t> _bytes_written{0};
+    std::atomic<uint32_t> _compactions{0};
+    std::atomic<uint32_t> _failures{0};
+};
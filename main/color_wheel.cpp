@@ -0,0 +1,103 @@
+#include "color_wheel.hpp"
+
+/* Compile-time palette
+ *
+ * hsv_to_rgb565() evaluated by the compiler for every bucket centre, so the
+ * picker costs one table read at runtime.
+ */
+struct WheelTable {
+    uint16_t color[2][WHEEL_HUE_STEPS][WHEEL_LEVEL_STEPS];  // [light_mode][hue][level]
+};
+
+static constexpr float level_factor(int level) {
+    return WHEEL_MIN_FACTOR + level * (1.0f - WHEEL_MIN_FACTOR) / (WHEEL_LEVEL_STEPS - 1);
+}
+
+static constexpr WheelTable make_wheel_table(void) {
+    WheelTable t = {};
+    for (int hue = 0; hue < WHEEL_HUE_STEPS; hue++) {
+        float angle = hue * (360.0f / WHEEL_HUE_STEPS);
+        for (int level = 0; level < WHEEL_LEVEL_STEPS; level++) {
+            float factor = level_factor(level);
+            // LIGHT: Saturation changes (Fade to White), DARK: Value changes (Fade to Black)
+            t.color[0][hue][level] = hsv_to_rgb565(angle, 1.0f, factor);
+            t.color[1][hue][level] = hsv_to_rgb565(angle, factor, 1.0f);
+        }
+    }
+    return t;
+}
+
+static constexpr WheelTable WHEEL_TABLE = make_wheel_table();
+
+static_assert(WHEEL_TABLE.color[0][0][WHEEL_LEVEL_STEPS - 1] == 0xF800, "full red expected at hue 0");
+static_assert(WHEEL_TABLE.color[1][8][0] == lgfx::color565(204, 255, 204), "pale green expected in light mode");
+
+/* Integer polar bucketing */
+
+// Squared distance at which each intensity level starts (level k rounds up from k - 0.5).
+struct LevelThresholds {
+    int32_t dist2[WHEEL_LEVEL_STEPS];
+};
+
+static constexpr LevelThresholds make_level_thresholds(void) {
+    LevelThresholds t = {};
+    for (int k = 1; k < WHEEL_LEVEL_STEPS; k++) {
+        float factor = level_factor(k) - (1.0f - WHEEL_MIN_FACTOR) / (WHEEL_LEVEL_STEPS - 1) / 2;
+        float dist = WHEEL_CENTER_DEADZONE + factor * WHEEL_FULL_RANGE;
+        t.dist2[k] = (int32_t)(dist * dist);
+    }
+    return t;
+}
+
+static constexpr LevelThresholds LEVEL_THRESHOLDS = make_level_thresholds();
+
+// tan() of the bucket edges inside one quadrant (7.5, 22.5 ... 82.5 degrees), Q12
+static constexpr int32_t HUE_EDGE_TAN_Q12[] = { 539, 1697, 3143, 5338, 9889, 31112 };
+static_assert(WHEEL_HUE_STEPS == 24, "hue edge table assumes 15 degree buckets");
+
+WheelBucket wheel_bucket(int dx, int dy) {
+    int32_t dist2 = dx * dx + dy * dy;
+    if (dist2 < WHEEL_CENTER_DEADZONE * WHEEL_CENTER_DEADZONE) return { 0, -1 };
+
+    // Angle = Hue: count the bucket edges below the angle within the quadrant
+    int32_t ax = dx < 0 ? -dx : dx;
+    int32_t ay = dy < 0 ? -dy : dy;
+    int k = 0;
+    while (k < 6 && (ay << 12) > ax * HUE_EDGE_TAN_Q12[k]) k++;
+
+    int hue;
+    if (dy >= 0) hue = dx >= 0 ? k : 12 - k;
+    else         hue = dx < 0 ? 12 + k : (WHEEL_HUE_STEPS - k) % WHEEL_HUE_STEPS;
+
+    // Distance = Intensity
+    int level = 0;
+    while (level + 1 < WHEEL_LEVEL_STEPS && dist2 >= LEVEL_THRESHOLDS.dist2[level + 1]) level++;
+
+    return { (int8_t)hue, (int8_t)level };
+}
+
+uint16_t wheel_color(WheelBucket b, bool light_mode) {
+    if (b.level < 0) return light_mode ? TFT_WHITE : TFT_BLACK;
+    return WHEEL_TABLE.color[light_mode][b.hue][b.level];
+}
+
+bool WheelOverlay::init(void) {
+    _sprite.setColorDepth(16);
+    return _sprite.createSprite(SIZE, SIZE) != nullptr;
+}
+
+void WheelOverlay::render(int x, int y, WheelBucket b, bool light_mode) {
+    const int c = SIZE / 2;
+    const float half = 180.0f / WHEEL_HUE_STEPS;
+    int level = b.level < 0 ? WHEEL_LEVEL_STEPS - 1 : b.level;
+
+    _sprite.fillScreen(TFT_DARKGREY);
+    for (int h = 0; h < WHEEL_HUE_STEPS; h++) {
+        float a = h * (360.0f / WHEEL_HUE_STEPS);
+        int outer = (b.level >= 0 && h == b.hue) ? c - 1 : c - 8;
+        _sprite.fillArc(c, c, 24, outer, a - half, a + half, wheel_color({ (int8_t)h, (int8_t)level }, light_mode));
+    }
+    _sprite.fillCircle(c, c, 18, wheel_color(b, light_mode));
+    _sprite.drawCircle(c, c, 18, TFT_LIGHTGREY);
+    _sprite.pushSprite(x, y);
+}
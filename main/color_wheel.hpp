@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+/* Colour wheel
+ *
+ * The joystick offset picks a hue bucket by angle and an intensity bucket by
+ * distance. Light palettes fade towards white, dark palettes towards black;
+ * the centre dead zone selects white or black itself.
+ */
+static constexpr int WHEEL_HUE_STEPS       = 24;  // 15 degrees each
+static constexpr int WHEEL_LEVEL_STEPS     = 8;
+static constexpr int WHEEL_CENTER_DEADZONE = 250;
+static constexpr int WHEEL_FULL_RANGE      = 1750;  // distance past the dead zone at full intensity
+static constexpr float WHEEL_MIN_FACTOR    = 0.2f;
+
+struct WheelBucket {
+    int8_t hue;    // 0 .. WHEEL_HUE_STEPS-1
+    int8_t level;  // 0 .. WHEEL_LEVEL_STEPS-1, or -1 for the centre zone
+
+    bool operator==(const WheelBucket& o) const { return hue == o.hue && level == o.level; }
+    bool operator!=(const WheelBucket& o) const { return !(*this == o); }
+};
+
+// Hue in degrees, saturation and value 0..1. constexpr so the wheel's
+// palette table is built by the compiler.
+constexpr uint16_t hsv_to_rgb565(float h, float s, float v) {
+    float r = 1, g = 1, b = 1;
+    int i = (int)(h / 60.0);
+    float f = (h / 60.0) - i;
+    float p = v * (1.0 - s);
+    float q = v * (1.0 - s * f);
+    float t = v * (1.0 - s * (1.0 - f));
+
+    switch(i % 6) {
+        case 0: r = v; g = t; b = p; break;
+        case 1: r = q; g = v; b = p; break;
+        case 2: r = p; g = v; b = t; break;
+        case 3: r = p; g = q; b = v; break;
+        case 4: r = t; g = p; b = v; break;
+        case 5: r = v; g = p; b = q; break;
+        default: break;
+    }
+    return lgfx::color565((uint8_t)(r*255), (uint8_t)(g*255), (uint8_t)(b*255));
+}
+
+// Maps a joystick offset from the calibrated centre to a bucket.
+WheelBucket wheel_bucket(int dx, int dy);
+uint16_t wheel_color(WheelBucket b, bool light_mode);
+
+// Small on-screen wheel shown while a colour is being picked.
+class WheelOverlay {
+public:
+    static constexpr int SIZE = 96;
+
+    explicit WheelOverlay(LovyanGFX* parent) : _sprite(parent) {}
+
+    bool init(void);
+    // Redraws the wheel for `b` and pushes it at (x, y).
+    void render(int x, int y, WheelBucket b, bool light_mode);
+
+private:
+    LGFX_Sprite _sprite;
+};
@@ -0,0 +1,82 @@
+#include "cursor_overlay.hpp"
+
+#include <string.h>
+
+// Two overlapping boxes never span more than this in either direction.
+static constexpr int MAX_SPAN = CursorOverlay::SIZE * 2 - 1;
+
+CursorOverlay::~CursorOverlay(void) {
+    if (_buffer) lgfx::heap_free(_buffer);
+}
+
+bool CursorOverlay::init(void) {
+    _sprite.setColorDepth(16);
+    _buffer = (uint16_t*)lgfx::heap_alloc_dma(MAX_SPAN * MAX_SPAN * sizeof(uint16_t));
+    return _buffer != nullptr;
+}
+
+void CursorOverlay::push(Rect r, bool with_cursor, int cx, int cy, const CursorStyle& style) {
+    int cw = _canvas->width();
+    int ch = _canvas->height();
+    if (r.x < 0) { r.w += r.x; r.x = 0; }
+    if (r.y < 0) { r.h += r.y; r.y = 0; }
+    if (r.x + r.w > cw) r.w = cw - r.x;
+    if (r.y + r.h > ch) r.h = ch - r.y;
+    if (r.w <= 0 || r.h <= 0) return;
+
+    // The previous transfer may still be reading the buffer
+    _lcd->waitDMA();
+
+    const uint16_t* src = (const uint16_t*)_canvas->getBuffer();
+    for (int row = 0; row < r.h; row++) {
+        memcpy(&_buffer[row * r.w], &src[(r.y + row) * cw + r.x], r.w * sizeof(uint16_t));
+    }
+
+    if (with_cursor) {
+        _sprite.setBuffer(_buffer, r.w, r.h, 16);
+        int ox = cx - r.x;
+        int oy = cy - r.y;
+        int x0 = ox - HALF;
+        int y0 = oy - HALF;
+
+        if (style.radius > 2) _sprite.drawCircle(ox, oy, style.radius / 2 + 1, TFT_DARKGREY);
+
+        _sprite.drawFastHLine(ox - 5, oy, 11, TFT_RED);
+        _sprite.drawFastVLine(ox, oy - 5, 11, TFT_RED);
+
+        if (!style.eraser) {
+            _sprite.fillRect(x0,      y0,      6, 6, style.color);
+            _sprite.fillRect(x0 + 30, y0,      6, 6, style.color);
+            _sprite.fillRect(x0,      y0 + 30, 6, 6, style.color);
+            _sprite.fillRect(x0 + 30, y0 + 30, 6, 6, style.color);
+        }
+    }
+
+    _lcd->pushImageDMA(r.x, r.y, r.w, r.h, (const lgfx::swap565_t*)_buffer);
+    // The glyph is left out: a present either keeps it or it is redrawn after
+    if (_presenter) _presenter->sync(r.x, r.y, r.w, r.h);
+}
+
+void CursorOverlay::moveTo(int x, int y, const CursorStyle& style) {
+    Rect next = boxAt(x, y);
+
+    if (_shown && (x != _x || y != _y)) {
+        Rect prev = boxAt(_x, _y);
+        bool overlap = prev.x < next.x + next.w && next.x < prev.x + prev.w
+                    && prev.y < next.y + next.h && next.y < prev.y + prev.h;
+        if (overlap) {
+            int x0 = prev.x < next.x ? prev.x : next.x;
+            int y0 = prev.y < next.y ? prev.y : next.y;
+            int x1 = prev.x + prev.w > next.x + next.w ? prev.x + prev.w : next.x + next.w;
+            int y1 = prev.y + prev.h > next.y + next.h ? prev.y + prev.h : next.y + next.h;
+            next = { x0, y0, x1 - x0, y1 - y0 };
+        } else {
+            push(prev, false, 0, 0, style);
+        }
+    }
+
+    push(next, true, x, y, style);
+    _shown = true;
+    _x = x;
+    _y = y;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include "diff_presenter.hpp"
+
+/* Cursor compositor
+ *
+ * Composes the canvas background and the cursor glyph into a small DMA
+ * buffer and pushes it in one transfer. When the old and new cursor boxes
+ * overlap, both are covered by a single push of their bounding box, which
+ * restores the old position and draws the new one at the same time.
+ */
+struct CursorStyle {
+    int radius;
+    bool eraser;
+    uint16_t color;
+};
+
+class CursorOverlay {
+public:
+    static constexpr int SIZE = 36;
+    static constexpr int HALF = SIZE / 2;
+
+    CursorOverlay(LovyanGFX* lcd, LGFX_Sprite* canvas) : _lcd(lcd), _canvas(canvas), _sprite(lcd) {}
+    ~CursorOverlay(void);
+
+    bool init(void);
+
+    // Optional; told about every push so its shadow keeps up with the panel.
+    void setPresenter(DiffPresenter* presenter) { _presenter = presenter; }
+
+    // Draws the cursor at (x, y), restoring the previous position if it moved.
+    void moveTo(int x, int y, const CursorStyle& style);
+
+private:
+    struct Rect {
+        int x, y, w, h;
+    };
+
+    Rect boxAt(int x, int y) const { return { x - HALF, y - HALF, SIZE, SIZE }; }
+    void push(Rect r, bool with_cursor, int cx, int cy, const CursorStyle& style);
+
+    LovyanGFX* _lcd;
+    LGFX_Sprite* _canvas;
+    DiffPresenter* _presenter = nullptr;
+    LGFX_Sprite _sprite;       // drawing view over _buffer with the current push width
+    uint16_t* _buffer = nullptr;
+    bool _shown = false;
+    int _x = 0;
+    int _y = 0;
+};
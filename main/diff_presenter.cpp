@@ -0,0 +1,157 @@
+#include "diff_presenter.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "esp_heap_caps.h"
+static void* alloc_psram(size_t len) { return heap_caps_malloc(len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT); }
+static void free_psram(void* p) { heap_caps_free(p); }
+#else
+static void* alloc_psram(size_t len) { return malloc(len); }
+static void free_psram(void* p) { free(p); }
+#endif
+
+bool DiffPresenter::init(void) {
+    release();
+    _width = _canvas->width();
+    _height = _canvas->height();
+    const uint16_t* src = (const uint16_t*)_canvas->getBuffer();
+    if (src == nullptr || _canvas->getColorDepth() != lgfx::rgb565_2Byte) return false;
+
+    size_t len = (size_t)_width * _height * sizeof(uint16_t);
+    _shadow = (uint16_t*)alloc_psram(len);
+    if (!_shadow) return false;
+    memcpy(_shadow, src, len);
+    return true;
+}
+
+void DiffPresenter::release(void) {
+    if (_shadow) free_psram(_shadow);
+    _shadow = nullptr;
+    _stale_count = 0;
+}
+
+bool DiffPresenter::clip(Rect& r) const {
+    if (r.x < 0) { r.w += r.x; r.x = 0; }
+    if (r.y < 0) { r.h += r.y; r.y = 0; }
+    if (r.x + r.w > _width) r.w = _width - r.x;
+    if (r.y + r.h > _height) r.h = _height - r.y;
+    return r.w > 0 && r.h > 0;
+}
+
+void DiffPresenter::sync(int x, int y, int w, int h) {
+    Rect r = { x, y, w, h };
+    if (!_shadow || !clip(r)) return;
+    const uint16_t* src = (const uint16_t*)_canvas->getBuffer();
+    for (int row = r.y; row < r.y + r.h; row++) {
+        size_t i = (size_t)row * _width + r.x;
+        memcpy(&_shadow[i], &src[i], r.w * sizeof(uint16_t));
+    }
+}
+
+void DiffPresenter::invalidate(int x, int y, int w, int h) {
+    Rect r = { x, y, w, h };
+    if (!clip(r)) return;
+    for (int i = 0; i < _stale_count; i++) {
+        const Rect& s = _stale[i];
+        if (r.x >= s.x && r.y >= s.y && r.x + r.w <= s.x + s.w && r.y + r.h <= s.y + s.h) return;
+    }
+    if (_stale_count < MAX_STALE) {
+        _stale[_stale_count++] = r;
+        return;
+    }
+    // Out of slots: widen the last one to cover both
+    Rect& s = _stale[MAX_STALE - 1];
+    int x1 = s.x + s.w > r.x + r.w ? s.x + s.w : r.x + r.w;
+    int y1 = s.y + s.h > r.y + r.h ? s.y + s.h : r.y + r.h;
+    s.x = s.x < r.x ? s.x : r.x;
+    s.y = s.y < r.y ? s.y : r.y;
+    s.w = x1 - s.x;
+    s.h = y1 - s.y;
+}
+
+/* Presenting */
+
+// One window over the rectangle, filled row by row from the canvas
+void DiffPresenter::sendRect(int x, int y, int w, int h) {
+    const uint16_t* src = (const uint16_t*)_canvas->getBuffer();
+    _display->setWindow(x, y, x + w - 1, y + h - 1);
+    for (int row = y; row < y + h; row++) {
+        size_t i = (size_t)row * _width + x;
+        _display->writePixels((const lgfx::swap565_t*)&src[i], w);
+        memcpy(&_shadow[i], &src[i], w * sizeof(uint16_t));
+    }
+
+    uint32_t pixels = (uint32_t)w * h;
+    _stats.windows++;
+    _stats.pixels_sent += pixels;
+    _stats.bytes_sent += pixels * sizeof(uint16_t) + _window_cost;
+}
+
+// Finds the runs of row `y` in [x0, x1) that differ from the shadow. A gap of
+// unchanged pixels that costs no more to resend than a new window, at most
+// `gap` pixels, joins two runs.
+// Returns what the runs cost on the wire; they are only sent if `send`.
+uint32_t DiffPresenter::presentRow(int x0, int x1, int y, bool send) {
+    const uint16_t* cur = (const uint16_t*)_canvas->getBuffer() + (size_t)y * _width;
+    const uint16_t* old = _shadow + (size_t)y * _width;
+    if (memcmp(&cur[x0], &old[x0], (x1 - x0) * sizeof(uint16_t)) == 0) return 0;
+
+    const int gap = _window_cost / (int)sizeof(uint16_t);
+    uint32_t cost = 0;
+    int x = x0;
+    for (;;) {
+        while (x < x1 && cur[x] == old[x]) x++;
+        if (x == x1) return cost;
+
+        int start = x;
+        int end;
+        for (;;) {
+            while (x < x1 && cur[x] != old[x]) x++;
+            end = x;
+            while (x < x1 && cur[x] == old[x] && x - end < gap) x++;
+            if (x == x1 || cur[x] == old[x]) break;
+        }
+        cost += (end - start) * sizeof(uint16_t) + _window_cost;
+        if (send) sendRect(start, y, end - start, 1);
+    }
+}
+
+void DiffPresenter::present(int x, int y, int w, int h) {
+    Rect r = { x, y, w, h };
+    if (!_shadow || !clip(r)) return;
+
+    uint64_t sent_before = _stats.bytes_sent;
+    _stats.presents++;
+    _display->startWrite();
+
+    // Areas the panel no longer shows the canvas in go out whole; the diff
+    // below then finds them equal to the shadow.
+    for (int i = 0; i < _stale_count;) {
+        const Rect& s = _stale[i];
+        int sx0 = s.x > r.x ? s.x : r.x;
+        int sy0 = s.y > r.y ? s.y : r.y;
+        int sx1 = s.x + s.w < r.x + r.w ? s.x + s.w : r.x + r.w;
+        int sy1 = s.y + s.h < r.y + r.h ? s.y + s.h : r.y + r.h;
+        if (sx0 < sx1 && sy0 < sy1) sendRect(sx0, sy0, sx1 - sx0, sy1 - sy0);
+
+        bool covered = s.x >= r.x && s.y >= r.y && s.x + s.w <= r.x + r.w && s.y + s.h <= r.y + r.h;
+        if (covered) _stale[i] = _stale[--_stale_count];
+        else i++;
+    }
+
+    // Small or busy rectangles are cheaper in one window than run by run
+    uint64_t whole = (uint64_t)r.w * r.h * sizeof(uint16_t) + _window_cost;
+    uint64_t runs = 0;
+    for (int row = r.y; row < r.y + r.h && runs < whole; row++) runs += presentRow(r.x, r.x + r.w, row, false);
+    if (runs >= whole) {
+        sendRect(r.x, r.y, r.w, r.h);
+    } else if (runs) {
+        for (int row = r.y; row < r.y + r.h; row++) presentRow(r.x, r.x + r.w, row, true);
+    }
+    _display->endWrite();
+
+    uint64_t sent = _stats.bytes_sent - sent_before;
+    if (sent < whole) _stats.bytes_saved += whole - sent;
+}
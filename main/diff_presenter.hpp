@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdint.h>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+/* Framebuffer-diff presenter
+ *
+ * Keeps a shadow copy of what the panel shows and, for each presented
+ * rectangle, sends only the runs of each row that differ from it. Runs
+ * separated by unchanged pixels costing no more than a window command are
+ * sent as one. A full copy rather than per-row hashes, because the runs need
+ * the old pixels and a hash only tells that a row changed.
+ *
+ * Anything else that draws to the panel reports it: sync() when the area
+ * now shows the canvas, invalidate() when it shows something else.
+ */
+class DiffPresenter {
+public:
+    struct Stats {
+        uint32_t presents;
+        uint32_t windows;       // setWindow + pixel bursts sent
+        uint64_t pixels_sent;
+        uint64_t bytes_sent;    // pixels plus window overhead
+        uint64_t bytes_saved;   // against pushing each presented rectangle whole
+    };
+
+    // Bytes a setWindow costs on the ILI9486: CASET, PASET and RAMWR with
+    // their arguments, rounded up for the D/C switches in between.
+    static constexpr int DEFAULT_WINDOW_COST = 16;
+
+    DiffPresenter(LovyanGFX* display, LGFX_Sprite* canvas) : _display(display), _canvas(canvas) {}
+    ~DiffPresenter(void) { release(); }
+
+    // Allocates the shadow. The panel must be showing the canvas as it is now.
+    bool init(void);
+    void release(void);
+
+    void setWindowCost(int bytes) { _window_cost = bytes; }
+
+    // Sends the changed pixels of the canvas inside the rectangle.
+    void present(int x, int y, int w, int h);
+
+    // The panel shows the canvas inside the rectangle again.
+    void sync(int x, int y, int w, int h);
+
+    // The panel shows something other than the canvas inside the rectangle;
+    // the next present() over it sends it whole.
+    void invalidate(int x, int y, int w, int h);
+
+    const Stats& stats(void) const { return _stats; }
+    void resetStats(void) { _stats = {}; }
+
+private:
+    static constexpr int MAX_STALE = 4;
+
+    struct Rect {
+        int x, y, w, h;
+    };
+
+    bool clip(Rect& r) const;
+    void sendRect(int x, int y, int w, int h);
+    uint32_t presentRow(int x0, int x1, int y, bool send);
+
+    LovyanGFX* _display;
+    LGFX_Sprite* _canvas;
+    uint16_t* _shadow = nullptr;
+    int _width = 0;
+    int _height = 0;
+    int _window_cost = DEFAULT_WINDOW_COST;
+
+    Rect _stale[MAX_STALE];
+    int _stale_count = 0;
+
+    Stats _stats = {};
+};
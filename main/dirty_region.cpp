@@ -0,0 +1,58 @@
+#include "dirty_region.hpp"
+
+// Extra pixels we accept pushing to save one setWindow round trip.
+static constexpr uint32_t MERGE_SLACK = 256;
+
+DirtyRegion::Rect DirtyRegion::unite(const Rect& a, const Rect& b) {
+    int x0 = a.x < b.x ? a.x : b.x;
+    int y0 = a.y < b.y ? a.y : b.y;
+    int x1 = a.x + a.w > b.x + b.w ? a.x + a.w : b.x + b.w;
+    int y1 = a.y + a.h > b.y + b.h ? a.y + a.h : b.y + b.h;
+    return { x0, y0, x1 - x0, y1 - y0 };
+}
+
+uint32_t DirtyRegion::area(void) const {
+    uint32_t sum = 0;
+    for (int i = 0; i < _count; i++) sum += areaOf(_rects[i]);
+    return sum;
+}
+
+void DirtyRegion::add(int x, int y, int w, int h) {
+    if (x < 0) { w += x; x = 0; }
+    if (y < 0) { h += y; y = 0; }
+    if (x + w > _width)  w = _width - x;
+    if (y + h > _height) h = _height - y;
+    if (w <= 0 || h <= 0) return;
+
+    Rect r = { x, y, w, h };
+    for (;;) {
+        bool merged = false;
+        for (int i = 0; i < _count; i++) {
+            const Rect& e = _rects[i];
+            bool overlap = r.x < e.x + e.w && e.x < r.x + r.w && r.y < e.y + e.h && e.y < r.y + r.h;
+            Rect u = unite(r, e);
+            if (overlap || areaOf(u) <= areaOf(r) + areaOf(e) + MERGE_SLACK) {
+                r = u;
+                remove(i);
+                merged = true;
+                break;
+            }
+        }
+        if (merged) continue;
+
+        if (_count < MAX_RECTS) {
+            _rects[_count++] = r;
+            return;
+        }
+
+        // List is full: fold the new rect into the neighbour that wastes the least area.
+        int best = 0;
+        uint32_t best_waste = UINT32_MAX;
+        for (int i = 0; i < _count; i++) {
+            uint32_t waste = areaOf(unite(r, _rects[i])) - areaOf(_rects[i]);
+            if (waste < best_waste) { best_waste = waste; best = i; }
+        }
+        r = unite(r, _rects[best]);
+        remove(best);
+    }
+}
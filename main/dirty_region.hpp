@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Dirty-region list
+ *
+ * Collects the canvas areas that differ from what is on the panel as a short
+ * list of rectangles. Overlapping rectangles, or ones whose union costs little
+ * more than the pair, are merged so each flush needs only a few windows.
+ */
+class DirtyRegion {
+public:
+    static constexpr int MAX_RECTS = 8;
+
+    struct Rect {
+        int x, y, w, h;
+    };
+
+    DirtyRegion(int width, int height) : _width(width), _height(height) {}
+
+    void add(int x, int y, int w, int h);
+    void addAll(void) { _count = 0; add(0, 0, _width, _height); }
+    void clear(void) { _count = 0; }
+
+    bool empty(void) const { return _count == 0; }
+    int count(void) const { return _count; }
+    const Rect& operator[](int i) const { return _rects[i]; }
+
+    // Total pixels covered by the list (rectangles never overlap after add()).
+    uint32_t area(void) const;
+
+private:
+    static Rect unite(const Rect& a, const Rect& b);
+    static uint32_t areaOf(const Rect& r) { return (uint32_t)r.w * r.h; }
+    void remove(int i) { _rects[i] = _rects[--_count]; }
+
+    Rect _rects[MAX_RECTS];
+    int _count = 0;
+    int _width;
+    int _height;
+};
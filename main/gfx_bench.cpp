@@ -0,0 +1,352 @@
+#include "gfx_bench.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+static int64_t now_ns(void) { return esp_timer_get_time() * 1000; }
+static const char* const PLATFORM = "esp32s3";
+#else
+#include <chrono>
+static int64_t now_ns(void) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+static const char* const PLATFORM = "host";
+#endif
+
+static const int IMAGE = 64;
+static const uint32_t MAX_ITERATIONS = 1u << 30;
+static const char* const TEXT = "The quick brown fox 0123";
+
+/* Cases */
+
+// Spreads successive calls over the target so no two draw the same place
+static int pos_x(const GfxBench::Context& ctx, uint32_t i, int w) { return (i * 37) % (ctx.width - w); }
+static int pos_y(const GfxBench::Context& ctx, uint32_t i, int h) { return (i * 23) % (ctx.height - h); }
+static uint32_t color(uint32_t i) { return lgfx::color888(i * 13, 255 - i * 7, i * 3); }
+
+static void clear(LovyanGFX& g) { g.fillScreen(TFT_BLACK); }
+
+// Anti-aliased drawing reads pixels back as RGB, which palette targets cannot
+static bool can_blend(LovyanGFX& g) { return !g.hasPalette(); }
+
+static uint32_t fill_rect_setup(LovyanGFX& g, GfxBench::Context&) {
+    clear(g);
+    return 40 * 30;
+}
+static void fill_rect(LovyanGFX& g, GfxBench::Context& ctx, uint32_t i) {
+    g.fillRect(pos_x(ctx, i, 40), pos_y(ctx, i, 30), 40, 30, color(i));
+}
+
+static uint32_t draw_line_setup(LovyanGFX& g, GfxBench::Context&) {
+    clear(g);
+    return 101;
+}
+static void draw_line(LovyanGFX& g, GfxBench::Context& ctx, uint32_t i) {
+    int x = pos_x(ctx, i, 101);
+    int y = pos_y(ctx, i, 61);
+    g.drawLine(x, y, x + 100, y + i % 61, color(i));
+}
+
+static uint32_t fill_circle_setup(LovyanGFX& g, GfxBench::Context&) {
+    clear(g);
+    return (uint32_t)(M_PI * 20 * 20);
+}
+static void fill_circle(LovyanGFX& g, GfxBench::Context& ctx, uint32_t i) {
+    g.fillCircle(pos_x(ctx, i, 41) + 20, pos_y(ctx, i, 41) + 20, 20, color(i));
+}
+
+static uint32_t fill_smooth_circle_setup(LovyanGFX& g, GfxBench::Context&) {
+    if (!can_blend(g)) return 0;
+    clear(g);
+    return (uint32_t)(M_PI * 20 * 20);
+}
+static void fill_smooth_circle(LovyanGFX& g, GfxBench::Context& ctx, uint32_t i) {
+    g.fillSmoothCircle(pos_x(ctx, i, 42) + 21, pos_y(ctx, i, 42) + 21, 20, color(i));
+}
+
+// 100 pixels long, 5 wide
+static uint32_t draw_wide_line_setup(LovyanGFX& g, GfxBench::Context&) {
+    if (!can_blend(g)) return 0;
+    clear(g);
+    return 100 * 5;
+}
+static void draw_wide_line(LovyanGFX& g, GfxBench::Context& ctx, uint32_t i) {
+    int x = pos_x(ctx, i, 90);
+    int y = pos_y(ctx, i, 70);
+    g.drawWideLine(x + 3, y + 3, x + 83, y + 63, 2.5f, color(i));
+}
+
+static uint32_t fill_triangle_setup(LovyanGFX& g, GfxBench::Context&) {
+    clear(g);
+    return 60 * 50 / 2;
+}
+static void fill_triangle(LovyanGFX& g, GfxBench::Context& ctx, uint32_t i) {
+    int x = pos_x(ctx, i, 61);
+    int y = pos_y(ctx, i, 51);
+    g.fillTriangle(x, y + 50, x + 30, y, x + 60, y + 50, color(i));
+}
+
+static uint32_t fill_smooth_round_rect_setup(LovyanGFX& g, GfxBench::Context&) {
+    if (!can_blend(g)) return 0;
+    clear(g);
+    return 60 * 40;
+}
+static void fill_smooth_round_rect(LovyanGFX& g, GfxBench::Context& ctx, uint32_t i) {
+    g.fillSmoothRoundRect(pos_x(ctx, i, 60), pos_y(ctx, i, 40), 60, 40, 8, color(i));
+}
+
+// Alternates the whole target between two colours; needs a readable target
+static uint32_t flood_fill_setup(LovyanGFX& g, GfxBench::Context& ctx) {
+    if (!g.isReadable()) return 0;
+    clear(g);
+    return ctx.width * ctx.height;
+}
+static void flood_fill(LovyanGFX& g, GfxBench::Context& ctx, uint32_t i) {
+    g.floodFill(ctx.width / 2, ctx.height / 2, (i & 1) ? TFT_BLACK : TFT_WHITE);
+}
+
+static uint32_t fill_screen_setup(LovyanGFX&, GfxBench::Context& ctx) { return ctx.width * ctx.height; }
+static void fill_screen(LovyanGFX& g, GfxBench::Context&, uint32_t i) { g.fillScreen(color(i)); }
+
+static uint32_t push_sprite_setup(LovyanGFX& g, GfxBench::Context&) {
+    clear(g);
+    return IMAGE * IMAGE;
+}
+static void push_sprite(LovyanGFX& g, GfxBench::Context& ctx, uint32_t i) {
+    ctx.image->pushSprite(&g, pos_x(ctx, i, IMAGE), pos_y(ctx, i, IMAGE));
+}
+
+// 1.5x each way, turned a little further every call
+static uint32_t rotate_zoom_setup(LovyanGFX& g, GfxBench::Context&) {
+    clear(g);
+    return IMAGE * IMAGE * 9 / 4;
+}
+static void rotate_zoom(LovyanGFX& g, GfxBench::Context& ctx, uint32_t i) {
+    g.pushImageRotateZoom(pos_x(ctx, i, 136) + 68, pos_y(ctx, i, 136) + 68, IMAGE / 2, IMAGE / 2, (float)(i % 360),
+                          1.5f, 1.5f, IMAGE, IMAGE, (const lgfx::swap565_t*)ctx.image565);
+}
+
+static uint32_t text_area(LovyanGFX& g) {
+    g.setTextColor(TFT_WHITE);
+    g.setTextDatum(lgfx::top_left);
+    return g.textWidth(TEXT) * g.fontHeight();
+}
+static void draw_string(LovyanGFX& g, GfxBench::Context& ctx, uint32_t i) {
+    int w = g.textWidth(TEXT);
+    g.setTextColor(color(i));
+    g.drawString(TEXT, pos_x(ctx, i, w), pos_y(ctx, i, g.fontHeight()));
+}
+static void reset_font(LovyanGFX& g) { g.setFont(&fonts::Font0); }
+
+static uint32_t text_gfx_setup(LovyanGFX& g, GfxBench::Context&) {
+    clear(g);
+    g.setFont(&fonts::FreeSans12pt7b);
+    return text_area(g);
+}
+
+static uint32_t text_u8g2_setup(LovyanGFX& g, GfxBench::Context&) {
+    clear(g);
+    g.setFont(&fonts::lgfxJapanGothic_24);
+    return text_area(g);
+}
+
+static uint32_t text_vlw_setup(LovyanGFX& g, GfxBench::Context& ctx) {
+    clear(g);
+    if (!ctx.vlw || !g.loadFont(ctx.vlw)) return 0;
+    return text_area(g);
+}
+static void text_vlw_teardown(LovyanGFX& g) {
+    g.unloadFont();
+    reset_font(g);
+}
+
+static const GfxBench::Case CASES[] = {
+    { "fillRect",                fill_rect_setup,              fill_rect,              nullptr },
+    { "drawLine",                draw_line_setup,              draw_line,              nullptr },
+    { "fillCircle",              fill_circle_setup,            fill_circle,            nullptr },
+    { "fillSmoothCircle",        fill_smooth_circle_setup,     fill_smooth_circle,     nullptr },
+    { "drawWideLine",            draw_wide_line_setup,         draw_wide_line,         nullptr },
+    { "fillTriangle",            fill_triangle_setup,          fill_triangle,          nullptr },
+    { "fillSmoothRoundRect",     fill_smooth_round_rect_setup, fill_smooth_round_rect, nullptr },
+    { "floodFill",               flood_fill_setup,             flood_fill,             nullptr },
+    { "fillScreen",              fill_screen_setup,            fill_screen,            nullptr },
+    { "pushSprite",              push_sprite_setup,            push_sprite,            nullptr },
+    { "pushImageRotateZoom",     rotate_zoom_setup,            rotate_zoom,            nullptr },
+    { "drawString/gfx",          text_gfx_setup,               draw_string,            reset_font },
+    { "drawString/u8g2",         text_u8g2_setup,              draw_string,            reset_font },
+    { "drawString/vlw",          text_vlw_setup,               draw_string,            text_vlw_teardown },
+};
+
+/* Harness */
+
+GfxBench::GfxBench(void) {
+    _image565 = (uint16_t*)malloc(IMAGE * IMAGE * sizeof(uint16_t));
+    if (_image565) {
+        for (int y = 0; y < IMAGE; y++) {
+            for (int x = 0; x < IMAGE; x++) {
+                int dx = x - IMAGE / 2;
+                int dy = y - IMAGE / 2;
+                uint16_t c = (dx * dx + dy * dy < 20 * 20) ? lgfx::color565(255, 255, 0)
+                                                             : lgfx::color565(y * 4, 255 - y * 4, x * 4);
+                _image565[y * IMAGE + x] = (uint16_t)(c >> 8 | c << 8);
+            }
+        }
+    }
+    _vlw = buildVlw(fonts::FreeSans12pt7b, nullptr);
+}
+
+GfxBench::~GfxBench(void) {
+    free(_image565);
+    free(_vlw);
+}
+
+// No VLW font ships with the tree, so the glyphs of a GFX font are written
+// out as one: a 24-byte header, 28 bytes per glyph, then the glyphs' alpha
+// bitmaps in order, all words big-endian.
+uint8_t* GfxBench::buildVlw(const lgfx::GFXfont& font, size_t* length) {
+    int count = font.last - font.first + 1;
+    size_t len = 24 + count * 28;
+    int ascent = 0;
+    int descent = 0;
+    for (int c = 0; c < count; c++) {
+        const lgfx::GFXglyph& gl = font.glyph[c];
+        len += gl.width * gl.height;
+        if (-gl.yOffset > ascent) ascent = -gl.yOffset;
+        if (gl.height + gl.yOffset > descent) descent = gl.height + gl.yOffset;
+    }
+    uint8_t* vlw = (uint8_t*)malloc(len);
+    if (!vlw) return nullptr;
+    if (length) *length = len;
+
+    uint8_t* p = vlw;
+    auto put = [&p](int32_t v) {
+        *p++ = v >> 24; *p++ = v >> 16; *p++ = v >> 8; *p++ = v;
+    };
+    put(count);
+    put(11);
+    put(font.yAdvance);
+    put(0);
+    put(ascent);
+    put(descent);
+    for (int c = 0; c < count; c++) {
+        const lgfx::GFXglyph& gl = font.glyph[c];
+        put(font.first + c);
+        put(gl.height);
+        put(gl.width);
+        put(gl.xAdvance);
+        put(-gl.yOffset);
+        put(gl.xOffset);
+        put(0);
+    }
+    for (int c = 0; c < count; c++) {
+        const lgfx::GFXglyph& gl = font.glyph[c];
+        const uint8_t* bits = &font.bitmap[gl.bitmapOffset];
+        for (int b = 0; b < gl.width * gl.height; b++) {
+            *p++ = (bits[b >> 3] & (0x80 >> (b & 7))) ? 255 : 0;
+        }
+    }
+    return vlw;
+}
+
+void GfxBench::runCase(LovyanGFX& g, Context& ctx, const Case& c, const char* target_name) {
+    uint32_t iterations = 1;
+    uint32_t pixels = 0;
+    int64_t elapsed = 0;
+    for (;;) {
+        pixels = c.setup(g, ctx);
+        if (!pixels) break;
+        g.startWrite();
+        int64_t t0 = now_ns();
+        for (uint32_t i = 0; i < iterations; i++) c.run(g, ctx, i);
+        g.endWrite();
+        g.waitDMA();
+        elapsed = now_ns() - t0;
+        if (elapsed >= _min_time_ns || iterations >= MAX_ITERATIONS) break;
+
+        // Aim 40% past the minimum, growing at most tenfold a batch
+        double grow = elapsed > 0 ? 1.4 * _min_time_ns / elapsed : 10;
+        if (grow > 10) grow = 10;
+        uint32_t next = (uint32_t)(iterations * grow);
+        iterations = next > iterations ? (next < MAX_ITERATIONS ? next : MAX_ITERATIONS) : iterations + 1;
+#if defined(ESP_PLATFORM)
+        vTaskDelay(1);  // let the idle task feed the watchdog
+#endif
+    }
+    if (c.teardown) c.teardown(g);
+    if (!pixels) return;
+
+    Result r;
+    r.name = c.name;
+    r.target = target_name;
+    r.bits = g.getColorDepth() & lgfx::color_depth_t::bit_mask;
+    r.iterations = iterations;
+    r.ns_per_op = (double)elapsed / iterations;
+    r.ns_per_pixel = r.ns_per_op / pixels;
+    r.pixels_per_s = r.ns_per_pixel > 0 ? 1e9 / r.ns_per_pixel : 0;
+    _results.push_back(r);
+}
+
+bool GfxBench::run(LovyanGFX* target, const char* target_name) {
+    LGFX_Sprite image;
+    image.setColorDepth(target->getColorDepth());
+    if (!image.createSprite(IMAGE, IMAGE) || !_image565) return false;
+    image.pushImage(0, 0, IMAGE, IMAGE, (const lgfx::swap565_t*)_image565);
+
+    Context ctx = { target->width(), target->height(), &image, _image565, _vlw };
+    for (const Case& c : CASES) {
+        if (_filter && !strstr(c.name, _filter)) continue;
+        runCase(*target, ctx, c, target_name);
+    }
+    return true;
+}
+
+bool GfxBench::runSprite(int width, int height, int bits, bool psram) {
+    LGFX_Sprite sprite;
+    sprite.setPsram(psram);
+    sprite.setColorDepth(bits);
+    if (!sprite.createSprite(width, height)) return false;
+    return run(&sprite, "sprite");
+}
+
+/* Report */
+
+void GfxBench::printTable(FILE* out) const {
+    fprintf(out, "%-22s %-9s %4s %10s %12s %10s %10s\n", "case", "target", "bpp", "iterations", "ns/op", "ns/pixel",
+            "Mpixel/s");
+    for (const Result& r : _results) {
+        fprintf(out, "%-22s %-9s %4d %10u %12.1f %10.3f %10.2f\n", r.name, r.target, r.bits, r.iterations, r.ns_per_op,
+                r.ns_per_pixel, r.pixels_per_s / 1e6);
+    }
+}
+
+// Laid out as Google Benchmark's --benchmark_format=json, so its tools read it
+void GfxBench::writeJson(FILE* out) const {
+    fprintf(out, "{\n  \"context\": {\n");
+    fprintf(out, "    \"platform\": \"%s\",\n", PLATFORM);
+#if defined(NDEBUG)
+    fprintf(out, "    \"library_build_type\": \"release\",\n");
+#else
+    fprintf(out, "    \"library_build_type\": \"debug\",\n");
+#endif
+    fprintf(out, "    \"min_time_ms\": %lld\n  },\n", (long long)(_min_time_ns / 1000000));
+    fprintf(out, "  \"benchmarks\": [");
+    for (size_t i = 0; i < _results.size(); i++) {
+        const Result& r = _results[i];
+        fprintf(out, "%s\n    {\n", i ? "," : "");
+        fprintf(out, "      \"name\": \"%s/%s/%d\",\n", r.name, r.target, r.bits);
+        fprintf(out, "      \"run_name\": \"%s/%s/%d\",\n", r.name, r.target, r.bits);
+        fprintf(out, "      \"run_type\": \"iteration\",\n");
+        fprintf(out, "      \"iterations\": %u,\n", r.iterations);
+        fprintf(out, "      \"real_time\": %.3f,\n", r.ns_per_op);
+        fprintf(out, "      \"cpu_time\": %.3f,\n", r.ns_per_op);
+        fprintf(out, "      \"time_unit\": \"ns\",\n");
+        fprintf(out, "      \"ns_per_pixel\": %.4f,\n", r.ns_per_pixel);
+        fprintf(out, "      \"pixels_per_second\": %.0f\n    }", r.pixels_per_s);
+    }
+    fprintf(out, "\n  ]\n}\n");
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <vector>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+/* Drawing primitive microbenchmarks
+ *
+ * Times a fixed set of LovyanGFX calls against any target: sprites at each
+ * colour depth, a headless panel or the display itself. Like Google
+ * Benchmark, each case runs in growing batches until one batch takes at least
+ * the minimum time, and that batch is reported: time per call, per pixel and
+ * pixels per second. The pixels of a call are the area its shape nominally
+ * covers, the same at every depth and on every target, so figures compare
+ * across them.
+ *
+ * The same code runs on the host and on the board, timed with esp_timer
+ * there, and prints the same table and JSON.
+ */
+class GfxBench {
+public:
+    struct Result {
+        const char* name;
+        const char* target;
+        int bits;
+        uint32_t iterations;
+        double ns_per_op;
+        double ns_per_pixel;
+        double pixels_per_s;
+    };
+
+    // Shared by the cases while they run on one target
+    struct Context {
+        int width;
+        int height;
+        LGFX_Sprite* image;           // 64x64 at the target's depth
+        const uint16_t* image565;     // the same pixels as swapped RGB565
+        const uint8_t* vlw;           // in-memory VLW font
+    };
+
+    struct Case {
+        const char* name;
+        // Prepares the target; returns the pixels one call covers, or 0 when
+        // the case cannot run on this target.
+        uint32_t (*setup)(LovyanGFX& g, Context& ctx);
+        void (*run)(LovyanGFX& g, Context& ctx, uint32_t i);
+        // Undoes setup, e.g. unloads a font. Optional.
+        void (*teardown)(LovyanGFX& g);
+    };
+
+    GfxBench(void);
+    ~GfxBench(void);
+
+    void setMinTime(uint32_t ms) { _min_time_ns = (int64_t)ms * 1000000; }
+    // Runs only the cases whose name contains `filter`; nullptr runs all.
+    void setFilter(const char* filter) { _filter = filter; }
+
+    // Runs every case on `target`, labelled `target_name` (kept, not copied).
+    bool run(LovyanGFX* target, const char* target_name);
+    // Runs every case on a width x height sprite of `bits` per pixel.
+    bool runSprite(int width, int height, int bits, bool psram);
+
+    const std::vector<Result>& results(void) const { return _results; }
+    void printTable(FILE* out) const;
+    void writeJson(FILE* out) const;
+
+    // Writes the glyphs of a GFX font out as an in-memory VLW font, in a
+    // malloc()ed buffer; `length` may be nullptr.
+    static uint8_t* buildVlw(const lgfx::GFXfont& font, size_t* length);
+
+private:
+    void runCase(LovyanGFX& g, Context& ctx, const Case& c, const char* target_name);
+
+    int64_t _min_time_ns = 100 * 1000000LL;
+    const char* _filter = nullptr;
+    std::vector<Result> _results;
+
+    uint16_t* _image565 = nullptr;
+    uint8_t* _vlw = nullptr;
+};
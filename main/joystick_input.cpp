@@ -0,0 +1,140 @@
+#include "joystick_input.hpp"
+
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_adc/adc_continuous.h"
+#include "esp_timer.h"
+
+/* ESP32-S3 continuous ADC */
+static constexpr size_t ADC_FRAME_PAIRS = 16;
+
+bool AdcContinuousSource::start(uint32_t pair_rate_hz) {
+    adc_continuous_handle_t handle;
+    adc_continuous_handle_cfg_t handle_cfg = {};
+    handle_cfg.max_store_buf_size = ADC_FRAME_PAIRS * 2 * SOC_ADC_DIGI_RESULT_BYTES * 8;
+    handle_cfg.conv_frame_size = ADC_FRAME_PAIRS * 2 * SOC_ADC_DIGI_RESULT_BYTES;
+    if (adc_continuous_new_handle(&handle_cfg, &handle) != ESP_OK) return false;
+
+    adc_digi_pattern_config_t pattern[2] = {};
+    pattern[0].atten = ADC_ATTEN_DB_12;
+    pattern[0].channel = _x_channel;
+    pattern[0].unit = ADC_UNIT_1;
+    pattern[0].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+    pattern[1] = pattern[0];
+    pattern[1].channel = _y_channel;
+
+    adc_continuous_config_t dig_cfg = {};
+    dig_cfg.pattern_num = 2;
+    dig_cfg.adc_pattern = pattern;
+    dig_cfg.sample_freq_hz = pair_rate_hz * 2;
+    dig_cfg.conv_mode = ADC_CONV_SINGLE_UNIT_1;
+    dig_cfg.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    if (adc_continuous_config(handle, &dig_cfg) != ESP_OK || adc_continuous_start(handle) != ESP_OK) {
+        adc_continuous_deinit(handle);
+        return false;
+    }
+    _handle = handle;
+    return true;
+}
+
+void AdcContinuousSource::stop(void) {
+    if (_handle == nullptr) return;
+    adc_continuous_stop((adc_continuous_handle_t)_handle);
+    adc_continuous_deinit((adc_continuous_handle_t)_handle);
+    _handle = nullptr;
+}
+
+size_t AdcContinuousSource::read(uint16_t* xs, uint16_t* ys, size_t max, uint32_t timeout_ms) {
+    uint8_t raw[ADC_FRAME_PAIRS * 2 * SOC_ADC_DIGI_RESULT_BYTES];
+    if (max > ADC_FRAME_PAIRS) max = ADC_FRAME_PAIRS;
+
+    uint32_t len = 0;
+    adc_continuous_read((adc_continuous_handle_t)_handle, raw, max * 2 * SOC_ADC_DIGI_RESULT_BYTES, &len, timeout_ms);
+    _last_time_us = esp_timer_get_time();
+
+    size_t pairs = 0;
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t* p = (const adc_digi_output_data_t*)&raw[i];
+        int channel = p->type2.channel;
+        if (channel == _x_channel) {
+            _pending_x = p->type2.data;
+        } else if (channel == _y_channel && _pending_x >= 0) {
+            xs[pairs] = _pending_x;
+            ys[pairs] = p->type2.data;
+            _pending_x = -1;
+            if (++pairs == max) break;
+        }
+    }
+    return pairs;
+}
+
+static void input_task(void* arg) {
+    JoystickInput* input = (JoystickInput*)arg;
+    for (;;) input->process(10);
+}
+
+bool JoystickInput::startTask(int priority, int core) {
+    return xTaskCreatePinnedToCore(input_task, "joy_input", 3072, this, priority, nullptr, core) == pdPASS;
+}
+#else
+bool JoystickInput::startTask(int, int) { return false; }
+#endif
+
+/* Filtering */
+bool JoystickInput::begin(IAdcSource* source, const Config& cfg) {
+    _source = source;
+    _cfg = cfg;
+    if (_cfg.oversample == 0) _cfg.oversample = 1;
+    _period_us = 1000000 / _cfg.sample_rate_hz;
+    _acc_x = _acc_y = 0;
+    _acc_count = 0;
+    _filt_x = -1;
+    return _source->start(_cfg.sample_rate_hz * _cfg.oversample);
+}
+
+void JoystickInput::process(uint32_t timeout_ms) {
+    uint16_t xs[BATCH], ys[BATCH];
+    size_t n = _source->read(xs, ys, BATCH, timeout_ms);
+    if (n == 0) return;
+
+    // Pairs are evenly spaced, so back-date each one from the newest capture time
+    int64_t pair_us = _period_us / _cfg.oversample;
+    int64_t t_last = _source->lastTimestampUs();
+
+    for (size_t i = 0; i < n; i++) {
+        _acc_x += xs[i];
+        _acc_y += ys[i];
+        if (++_acc_count < _cfg.oversample) continue;
+
+        int32_t avg_x = (_acc_x << FILTER_FRAC) / _acc_count;
+        int32_t avg_y = (_acc_y << FILTER_FRAC) / _acc_count;
+        _acc_x = _acc_y = 0;
+        _acc_count = 0;
+
+        if (_filt_x < 0) {
+            _filt_x = avg_x;
+            _filt_y = avg_y;
+        } else {
+            _filt_x += (avg_x - _filt_x) >> _cfg.iir_shift;
+            _filt_y += (avg_y - _filt_y) >> _cfg.iir_shift;
+        }
+
+        JoystickSample s;
+        s.time_us = t_last - (int64_t)(n - 1 - i) * pair_us;
+        s.x = _filt_x >> FILTER_FRAC;
+        s.y = _filt_y >> FILTER_FRAC;
+        if (!_ring.push(s)) _dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool JoystickInput::latest(JoystickSample& sample) {
+    bool got = false;
+    JoystickSample s;
+    while (_ring.pop(s)) {
+        sample = s;
+        got = true;
+    }
+    return got;
+}
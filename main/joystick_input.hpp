@@ -0,0 +1,126 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <functional>
+
+#include "spsc_ring.hpp"
+
+/* Joystick input subsystem
+ *
+ * A source delivers raw X/Y conversion pairs at a fixed hardware rate. The
+ * input task averages `oversample` pairs into one sample, runs it through a
+ * first-order IIR filter and publishes it with a timestamp into a lock-free
+ * ring that the render loop drains. Input rate no longer depends on frame rate.
+ */
+
+struct JoystickSample {
+    int64_t time_us;
+    int16_t x;
+    int16_t y;
+};
+
+// Raw ADC conversion source.
+class IAdcSource {
+public:
+    virtual ~IAdcSource(void) = default;
+
+    // Starts conversions at `pair_rate_hz` X/Y pairs per second.
+    virtual bool start(uint32_t pair_rate_hz) = 0;
+    virtual void stop(void) = 0;
+
+    // Waits up to `timeout_ms` and returns up to `max` pairs, oldest first.
+    virtual size_t read(uint16_t* xs, uint16_t* ys, size_t max, uint32_t timeout_ms) = 0;
+
+    // Capture time of the newest pair returned by read().
+    virtual int64_t lastTimestampUs(void) const = 0;
+};
+
+#if defined(ESP_PLATFORM)
+// ESP32-S3 ADC1 in continuous (DMA) mode; the conversion timer is the ADC's own.
+class AdcContinuousSource : public IAdcSource {
+public:
+    AdcContinuousSource(int x_channel, int y_channel) : _x_channel(x_channel), _y_channel(y_channel) {}
+    ~AdcContinuousSource(void) override { stop(); }
+
+    bool start(uint32_t pair_rate_hz) override;
+    void stop(void) override;
+    size_t read(uint16_t* xs, uint16_t* ys, size_t max, uint32_t timeout_ms) override;
+    int64_t lastTimestampUs(void) const override { return _last_time_us; }
+
+private:
+    void* _handle = nullptr;
+    int _x_channel;
+    int _y_channel;
+    int _pending_x = -1;  // X conversion waiting for its Y partner across reads
+    int64_t _last_time_us = 0;
+};
+#endif
+
+// Host stand-in: pairs come from a generator evaluated on a virtual clock.
+class FakeAdcSource : public IAdcSource {
+public:
+    using Generator = std::function<void(int64_t time_us, uint16_t& x, uint16_t& y)>;
+
+    explicit FakeAdcSource(Generator gen) : _gen(gen) {}
+
+    bool start(uint32_t pair_rate_hz) override { _period_us = 1000000.0 / pair_rate_hz; _index = 0; return true; }
+    void stop(void) override {}
+    size_t read(uint16_t* xs, uint16_t* ys, size_t max, uint32_t) override {
+        for (size_t i = 0; i < max; i++) _gen(timeAt(_index + i), xs[i], ys[i]);
+        _index += max;
+        return max;
+    }
+    int64_t lastTimestampUs(void) const override { return _index ? timeAt(_index - 1) : 0; }
+
+private:
+    int64_t timeAt(uint64_t index) const { return (int64_t)(index * _period_us); }
+
+    Generator _gen;
+    double _period_us = 1000.0;
+    uint64_t _index = 0;
+};
+
+class JoystickInput {
+public:
+    struct Config {
+        uint32_t sample_rate_hz = 1000;  // published samples per second
+        uint8_t oversample = 8;          // raw pairs averaged per sample
+        uint8_t iir_shift = 2;           // y += (x - y) >> shift
+    };
+
+    bool begin(IAdcSource* source, const Config& cfg);
+    bool begin(IAdcSource* source) { return begin(source, Config()); }
+
+    // Reads one batch from the source, filters it and publishes the samples.
+    // This is the body of the input task; host code can call it directly.
+    void process(uint32_t timeout_ms);
+
+    // Runs process() forever on a dedicated FreeRTOS task.
+    bool startTask(int priority, int core);
+
+    // Consumer side, called from the render loop.
+    bool pop(JoystickSample& sample) { return _ring.pop(sample); }
+    // Drains the ring and keeps only the newest sample.
+    bool latest(JoystickSample& sample);
+
+    uint32_t dropped(void) const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t BATCH = 16;   // pairs per read, 2 ms at the default rates
+    static constexpr int FILTER_FRAC = 4;  // fixed-point bits kept in the IIR state
+
+    IAdcSource* _source = nullptr;
+    Config _cfg;
+    uint32_t _period_us = 1000;
+
+    uint32_t _acc_x = 0;
+    uint32_t _acc_y = 0;
+    uint8_t _acc_count = 0;
+    int32_t _filt_x = -1;  // -1 until the first sample seeds the filter
+    int32_t _filt_y = 0;
+
+    SpscRing<JoystickSample, 256> _ring;
+    std::atomic<uint32_t> _dropped{0};
+};
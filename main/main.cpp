@@ -1,17 +1,21 @@
 #include <stdio.h>
-#include <math.h>
-#include <vector> 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "driver/gpio.h"
-#include "esp_adc/adc_oneshot.h" 
+#include "hal/adc_types.h" 
 #include "esp_timer.h" 
 
 #define LGFX_USE_V1
 #include <LovyanGFX.hpp>
 
+#include "joystick_input.hpp"
+#include "sketch_app.hpp"
+#include "canvas_store.hpp"
+#include "stroke_streamer.hpp"
+#include "wifi_sta.hpp"
+#include "gfx_bench.hpp"
+
 /* Wiring Config */
-#define ADC_UNIT       ADC_UNIT_1
 #define JOY_X_CHAN     ADC_CHANNEL_3
 #define JOY_Y_CHAN     ADC_CHANNEL_4
 
@@ -56,53 +60,18 @@ public:
 };
 
 LGFX lcd;
-LGFX_Sprite canvas(&lcd);      
-LGFX_Sprite cursorSprite(&lcd); 
-adc_oneshot_unit_handle_t adc1_handle;
-
-/* Undo setup */
-struct Snapshot {
-    uint16_t* buffer;
-};
-std::vector<Snapshot> undoStack;
-const int MAX_UNDOS = 20;
+SketchApp app(&lcd);
 
-void saveSnapshot() {
-    uint16_t* newBuf = (uint16_t*)heap_caps_malloc(320 * 480 * 2, MALLOC_CAP_SPIRAM);
-    if (newBuf == NULL) return;
-    memcpy(newBuf, canvas.getBuffer(), 320 * 480 * 2);
-    undoStack.push_back({newBuf});
-    if (undoStack.size() > MAX_UNDOS) {
-        free(undoStack.front().buffer);
-        undoStack.erase(undoStack.begin());
-    }
-}
-
-void performUndo() {
-    if (undoStack.empty()) return;
-    Snapshot last = undoStack.back();
-    memcpy(canvas.getBuffer(), last.buffer, 320 * 480 * 2);
-    free(last.buffer);
-    undoStack.pop_back();
-    canvas.pushSprite(0, 0);
-}
+/* Joystick sampling runs on its own task at 1 kHz */
+AdcContinuousSource joySource(JOY_X_CHAN, JOY_Y_CHAN);
+JoystickInput joystick;
 
 /* Joystick Calibration */
 int center_x = 2048; 
 int center_y = 2048; 
 
 void setup_inputs() {
-    adc_oneshot_unit_init_cfg_t init_config = {
-        .unit_id = ADC_UNIT,
-        .clk_src = ADC_RTC_CLK_SRC_DEFAULT, 
-        .ulp_mode = ADC_ULP_MODE_DISABLE,
-    };
-    ESP_ERROR_CHECK(adc_oneshot_new_unit(&init_config, &adc1_handle));
-
-    adc_oneshot_chan_cfg_t config = { .atten = ADC_ATTEN_DB_12, .bitwidth = ADC_BITWIDTH_DEFAULT };
-    ESP_ERROR_CHECK(adc_oneshot_config_channel(adc1_handle, JOY_X_CHAN, &config));
-    ESP_ERROR_CHECK(adc_oneshot_config_channel(adc1_handle, JOY_Y_CHAN, &config));
-
+    // The buttons work without the joystick, so they are configured first
     gpio_config_t btn_cfg = {};
     btn_cfg.intr_type = GPIO_INTR_DISABLE;
     btn_cfg.mode = GPIO_MODE_INPUT;
@@ -113,271 +82,132 @@ void setup_inputs() {
                            (1ULL << BTN_TOOL_PIN);
     gpio_config(&btn_cfg);
 
+    if (!joystick.begin(&joySource) || !joystick.startTask(5, 1)) {
+        printf("Joystick ADC start failed\n");
+        return;
+    }
+
+    // Half a second of samples at 1 kHz; keep the default centre if they
+    // have not arrived within two seconds.
     printf("Calibrating Joystick... DON'T TOUCH ME!!!\n");
+    const int CAL_SAMPLES = 500;
+    const int64_t CAL_TIMEOUT_US = 2000000;
+    int64_t deadline = esp_timer_get_time() + CAL_TIMEOUT_US;
     long sum_x = 0, sum_y = 0;
-    for(int i=0; i<50; i++) {
-        int r_x, r_y;
-        ESP_ERROR_CHECK(adc_oneshot_read(adc1_handle, JOY_X_CHAN, &r_x));
-        ESP_ERROR_CHECK(adc_oneshot_read(adc1_handle, JOY_Y_CHAN, &r_y));
-        sum_x += r_x; sum_y += r_y;
-        vTaskDelay(10 / portTICK_PERIOD_MS);
+    int count = 0;
+    while (count < CAL_SAMPLES) {
+        JoystickSample js;
+        if (!joystick.pop(js)) {
+            if (esp_timer_get_time() > deadline) break;
+            vTaskDelay(10 / portTICK_PERIOD_MS);
+            continue;
+        }
+        sum_x += js.x; sum_y += js.y;
+        count++;
+    }
+    if (count < CAL_SAMPLES) {
+        printf("Calibration timed out after %d samples, using centre %d,%d\n", count, center_x, center_y);
+        return;
     }
-    center_x = sum_x / 50;
-    center_y = sum_y / 50;
+    center_x = sum_x / CAL_SAMPLES;
+    center_y = sum_y / CAL_SAMPLES;
     printf("Calibration Complete.\n");
 }
 
-/* Colour math */
-uint16_t hsv_to_rgb565(float h, float s, float v) {
-    float r, g, b;
-    int i = (int)(h / 60.0);
-    float f = (h / 60.0) - i;
-    float p = v * (1.0 - s);
-    float q = v * (1.0 - s * f);
-    float t = v * (1.0 - s * (1.0 - f));
-    
-    switch(i % 6) {
-        case 0: r = v; g = t; b = p; break;
-        case 1: r = q; g = v; b = p; break;
-        case 2: r = p; g = v; b = t; break;
-        case 3: r = p; g = q; b = v; break;
-        case 4: r = t; g = p; b = v; break;
-        case 5: r = v; g = p; b = q; break;
-        default: r=1; g=1; b=1; break;
+// Buttons are active low; the joystick task supplies the newest sample
+class BoardInput : public IInputSource {
+public:
+    void read(InputState& in) override {
+        JoystickSample js{};  // left as zeros when no sample has arrived
+        in.has_joy = joystick.latest(js);
+        in.joy_x = js.x;
+        in.joy_y = js.y;
+        in.now_ms = esp_timer_get_time() / 1000;
+        in.btn_draw  = gpio_get_level((gpio_num_t)BTN_DRAW_PIN) == 0;
+        in.btn_color = gpio_get_level((gpio_num_t)BTN_COLOR_PIN) == 0;
+        in.btn_undo  = gpio_get_level((gpio_num_t)BTN_UNDO_PIN) == 0;
+        in.btn_tool  = gpio_get_level((gpio_num_t)BTN_TOOL_PIN) == 0;
     }
-    return lgfx::color565((uint8_t)(r*255), (uint8_t)(g*255), (uint8_t)(b*255));
-}
-
-/* Graphics State */
-int size_index = 1; 
-bool is_eraser = false;
-uint16_t current_color = TFT_BLACK;
-bool is_light_mode = false; 
-
-int BRUSH_SIZES[]  = {2, 4, 8};
-int ERASER_SIZES[] = {6, 12, 24}; 
+};
 
-int getBrushSize() {
-    if (is_eraser) return ERASER_SIZES[size_index];
-    else return BRUSH_SIZES[size_index];
+/* Stroke streaming */
+StrokeStreamer streamer;
+#if CONFIG_SKETCH_STREAM_MQTT
+MqttTransport streamTransport;
+#else
+UdpTransport streamTransport;
+#endif
+
+bool setup_stream() {
+    if (CONFIG_SKETCH_WIFI_SSID[0] == '\0') return false;
+    if (!wifi_sta_start(CONFIG_SKETCH_WIFI_SSID, CONFIG_SKETCH_WIFI_PASSWORD)) {
+        printf("Wi-Fi start failed\n");
+        return false;
+    }
+#if CONFIG_SKETCH_STREAM_MQTT
+    bool opened = streamTransport.open(CONFIG_SKETCH_STREAM_MQTT_URI, CONFIG_SKETCH_STREAM_MQTT_TOPIC);
+#else
+    bool opened = streamTransport.open(CONFIG_SKETCH_STREAM_HOST, CONFIG_SKETCH_STREAM_PORT);
+#endif
+    if (!opened) {
+        printf("Stroke stream transport failed\n");
+        return false;
+    }
+    streamer.begin(&streamTransport, CONFIG_SKETCH_STREAM_INTERVAL_MS);
+    return streamer.startTask(3, 0);
 }
 
-void drawCursorAt(int x, int y) {
-    cursorSprite.pushImage(-x + 18, -y + 18, 480, 320, (uint16_t*)canvas.getBuffer());
-    
-    uint16_t c;
-    if (is_eraser) c = TFT_BLUE; 
-    else c = current_color;      
-    
-    int r = getBrushSize();
-    if (r > 2) cursorSprite.drawCircle(18, 18, r/2 + 1, TFT_DARKGREY);
-    
-    cursorSprite.drawFastHLine(13, 18, 11, TFT_RED);
-    cursorSprite.drawFastVLine(18, 13, 11, TFT_RED);
-    
-    if (!is_eraser) {
-        cursorSprite.fillRect(0,0, 6, 6, current_color);
-        cursorSprite.fillRect(30,0, 6, 6, current_color);
-        cursorSprite.fillRect(0,30, 6, 6, current_color);
-        cursorSprite.fillRect(30,30, 6, 6, current_color);
+/* Canvas persistence */
+#if CONFIG_SKETCH_PERSIST
+PartitionStorage persistStorage;
+CanvasStore store(&app.canvas());
+
+bool setup_persist() {
+    if (!persistStorage.open(CONFIG_SKETCH_PERSIST_PARTITION) || !store.begin(&persistStorage)) {
+        printf("Canvas partition \"%s\" not found\n", CONFIG_SKETCH_PERSIST_PARTITION);
+        return false;
     }
-    cursorSprite.pushSprite(x - 18, y - 18);
+    return true;
 }
-
-void restoreBackgroundAt(int x, int y) {
-    cursorSprite.pushImage(-x + 18, -y + 18, 480, 320, (uint16_t*)canvas.getBuffer());
-    cursorSprite.pushSprite(x - 18, y - 18);
+#endif
+
+/* Primitive benchmarks */
+#if CONFIG_SKETCH_GFX_BENCH
+void run_gfx_bench() {
+    GfxBench bench;
+    for (int bits : { 1, 2, 4, 8, 16, 24 }) {
+        if (!bench.runSprite(lcd.width(), lcd.height(), bits, true)) printf("%d bpp sprite: allocation failed\n", bits);
+    }
+    bench.run(&lcd, "ili9486");
+    bench.printTable(stdout);
+    bench.writeJson(stdout);
 }
+#endif
 
 extern "C" void app_main(void)
 {
     if (!lcd.init()) return;
     setup_inputs();
+    if (setup_stream()) app.setStreamer(&streamer);
     lcd.setRotation(1); 
-
-    canvas.setColorDepth(16);
-    canvas.setPsram(true); 
-    canvas.createSprite(480, 320);
-    canvas.fillScreen(TFT_WHITE);
-    
-    cursorSprite.setColorDepth(16);
-    cursorSprite.createSprite(36, 36);
-
-    float cursor_x = 240.0, cursor_y = 160.0;
-    int prev_x = 240, prev_y = 160;
-
-    saveSnapshot();
-    canvas.pushSprite(0, 0);
-
-    /* Input States */
-    int last_tool_state = 1; 
-    int64_t tool_press_start = 0;
-    bool tool_handled = false;
-
-    int last_undo_state = 1;
-    int64_t undo_press_start = 0;
-    bool undo_handled = false;
-    
-    bool was_drawing = false;
-
-    const int DEADZONE = 120;
-    const float MAX_SPEED = 2; 
-    const float DIVISOR = 2000.0 / MAX_SPEED;
-
+#if CONFIG_SKETCH_GFX_BENCH
+    run_gfx_bench();
+#endif
+#if CONFIG_SKETCH_PERSIST
+    bool persist = setup_persist();
+    if (persist) app.setStore(&store);
+#endif
+
+    if (!app.init(center_x, center_y)) return;
+#if CONFIG_SKETCH_PERSIST
+    if (persist) store.startTask(CONFIG_SKETCH_PERSIST_INTERVAL_MS, 1, 1);
+#endif
+
+    BoardInput input;
     while (1) {
-        int raw_x, raw_y;
-        ESP_ERROR_CHECK(adc_oneshot_read(adc1_handle, JOY_X_CHAN, &raw_x));
-        ESP_ERROR_CHECK(adc_oneshot_read(adc1_handle, JOY_Y_CHAN, &raw_y));
-        
-        int btn_draw  = gpio_get_level((gpio_num_t)BTN_DRAW_PIN);
-        int btn_undo  = gpio_get_level((gpio_num_t)BTN_UNDO_PIN);
-        int btn_tool  = gpio_get_level((gpio_num_t)BTN_TOOL_PIN);
-        int btn_color = gpio_get_level((gpio_num_t)BTN_COLOR_PIN);
-
-        int64_t now = esp_timer_get_time() / 1000;
-
-        /* Colour selector logic */
-        if (btn_color == 0) {
-            int64_t press_start = now;
-            bool entered_wheel = false;
-
-            // Wait loop while button is held
-            while (gpio_get_level((gpio_num_t)BTN_COLOR_PIN) == 0) {
-                int64_t held_time = (esp_timer_get_time() / 1000) - press_start;
-
-                if (held_time > 300) { 
-                    // LONG HOLD -> Enter Color Wheel
-                    entered_wheel = true;
-
-                    // Read Joystick
-                    adc_oneshot_read(adc1_handle, JOY_X_CHAN, &raw_x);
-                    adc_oneshot_read(adc1_handle, JOY_Y_CHAN, &raw_y);
-                    
-                    float val_x = (float)raw_x - center_x;
-                    float val_y = (float)raw_y - center_y;
-                    
-                    // Angle = Hue
-                    float angle = atan2(val_y, val_x) * 180.0 / M_PI;
-                    if (angle < 0) angle += 360.0;
-                    
-                    // Distance = Intensity
-                    float dist = sqrt(val_x*val_x + val_y*val_y);
-                    
-                    if (dist < 250) {
-                        // Center Zone: Black (Dark Mode) or White (Light Mode)
-                        current_color = is_light_mode ? TFT_WHITE : TFT_BLACK;
-                    } else {
-                        // Map distance to 0.0 -> 1.0 factor
-                        float factor = (dist - 250) / 1750.0;
-                        if (factor < 0.2) factor = 0.2;
-                        if (factor > 1.0) factor = 1.0;
-
-                        if (is_light_mode) {
-                            // LIGHT: Saturation changes (Fade to White)
-                            current_color = hsv_to_rgb565(angle, factor, 1.0); 
-                        } else {
-                            // DARK: Value changes (Fade to Black)
-                            current_color = hsv_to_rgb565(angle, 1.0, factor);
-                        }
-                    }
-                    
-                    if (is_eraser) is_eraser = false;
-                    drawCursorAt((int)cursor_x, (int)cursor_y);
-                }
-                vTaskDelay(10 / portTICK_PERIOD_MS);
-            }
-
-            // Button released
-            // If never entered wheel, it was a press
-            if (!entered_wheel) {
-                is_light_mode = !is_light_mode;
-                printf("Palette: %s\n", is_light_mode ? "LIGHT" : "DARK");
-                // Force redraw to show the user
-                drawCursorAt((int)cursor_x, (int)cursor_y);
-            }
-            continue; // Skip movement processing for this frame
-        }
-
-
-        /* Tool Button */
-        if (btn_tool == 0) { 
-            if (last_tool_state == 1) {
-                tool_press_start = now;
-                tool_handled = false;
-            } else {
-                if (!tool_handled && (now - tool_press_start > 500)) { 
-                    is_eraser = !is_eraser; 
-                    tool_handled = true;
-                    drawCursorAt((int)cursor_x, (int)cursor_y);
-                }
-            }
-        } else { 
-            if (last_tool_state == 0 && !tool_handled) {
-                size_index++;
-                if (size_index > 2) size_index = 0;
-            }
-        }
-        last_tool_state = btn_tool;
-
-        /* Undo/Clear Button */
-        if (btn_undo == 0) { 
-            if (last_undo_state == 1) {
-                undo_press_start = now;
-                undo_handled = false;
-            } else {
-                if (!undo_handled && (now - undo_press_start > 800)) {
-                    saveSnapshot(); 
-                    canvas.fillScreen(TFT_WHITE);
-                    canvas.pushSprite(0, 0);
-                    undo_handled = true;
-                }
-            }
-        } else { 
-            if (last_undo_state == 0 && !undo_handled) performUndo();
-        }
-        last_undo_state = btn_undo;
-
-        /* Cursor Movement */
-        float val_x = (float)raw_x - center_x;
-        float val_y = (float)raw_y - center_y;
-
-        if (fabs(val_x) < DEADZONE) val_x = 0;
-        else val_x = val_x / DIVISOR;
-
-        if (fabs(val_y) < DEADZONE) val_y = 0;
-        else val_y = val_y / DIVISOR;
-
-        cursor_x += val_x; 
-        cursor_y += val_y; 
-
-        if (cursor_x < 18) cursor_x = 18;
-        if (cursor_x > 461) cursor_x = 461;
-        if (cursor_y < 18) cursor_y = 18;
-        if (cursor_y > 301) cursor_y = 301;
-
-        int curr_ix = (int)cursor_x;
-        int curr_iy = (int)cursor_y;
-
-        /* Drawing Logic */
-        bool moved = (curr_ix != prev_x || curr_iy != prev_y);
-        bool drawing = (btn_draw == 0);
-
-        if (drawing && !was_drawing) saveSnapshot();
-        was_drawing = drawing;
-
-        if (moved || drawing) {
-            if (moved) restoreBackgroundAt(prev_x, prev_y);
-            
-            if (drawing) {
-                uint16_t c = is_eraser ? TFT_WHITE : current_color;
-                canvas.fillCircle(curr_ix, curr_iy, getBrushSize(), c);
-            }
-            
-            drawCursorAt(curr_ix, curr_iy);
-            prev_x = curr_ix;
-            prev_y = curr_iy;
-        }
-
+        InputState in;
+        input.read(in);
+        app.frame(in);
         vTaskDelay(1); 
     }
 }
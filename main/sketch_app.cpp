@@ -0,0 +1,242 @@
+#include "sketch_app.hpp"
+
+#include <stdio.h>
+#include <math.h>
+
+/* Tunables */
+static const size_t UNDO_ARENA_TILES = 4096; // 2 MB of 16x16 tile pre-images in PSRAM
+static const size_t MAX_UNDOS = 256;
+
+static const int WHEEL_X = SketchApp::WIDTH - WheelOverlay::SIZE - 4;
+static const int WHEEL_Y = 4;
+
+static const int BRUSH_SIZES[]  = {2, 4, 8};
+static const int ERASER_SIZES[] = {6, 12, 24};
+
+static const int DEADZONE = 120;
+static const float MAX_SPEED = 2;
+static const float DIVISOR = 2000.0 / MAX_SPEED;
+
+SketchApp::SketchApp(LovyanGFX* display)
+: _display(display)
+, _canvas(display)
+, _presenter(display, &_canvas)
+, _cursor(display, &_canvas)
+, _wheel(display)
+, _dirty(WIDTH, HEIGHT)
+, _ink(WIDTH, HEIGHT)
+, _stroke(&_canvas, &_history, &_ink)
+, _btn_draw(UINT32_MAX)
+, _btn_color(300)
+, _btn_undo(800)
+, _btn_tool(500)
+{}
+
+bool SketchApp::init(int center_x, int center_y) {
+    _center_x = _raw_x = center_x;
+    _center_y = _raw_y = center_y;
+
+    _canvas.setColorDepth(16);
+    _canvas.setPsram(true);
+    if (!_canvas.createSprite(WIDTH, HEIGHT)) return false;
+    _canvas.fillScreen(TFT_WHITE);
+    // A restored sketch counts as ink so clear() wipes it
+    if (_store && _store->restore()) _ink.addAll();
+    if (!_history.init((uint16_t*)_canvas.getBuffer(), WIDTH, HEIGHT, UNDO_ARENA_TILES, MAX_UNDOS)) return false;
+
+    if (!_cursor.init() || !_wheel.init()) return false;
+
+    _canvas.pushSpriteAsync(0, 0, &_present);
+    if (!_presenter.init()) return false;
+    _cursor.setPresenter(&_presenter);
+    return true;
+}
+
+/* Partial flush */
+
+// Sends the pixels of the dirty rectangles that differ from what the panel
+// shows. A tile-aligned undo rectangle is mostly unchanged background.
+void SketchApp::flushDirty(void) {
+    if (_dirty.empty()) return;
+    _present.finish();
+    for (int i = 0; i < _dirty.count(); i++) {
+        const DirtyRegion::Rect& r = _dirty[i];
+        _presenter.present(r.x, r.y, r.w, r.h);
+    }
+    _dirty.clear();
+}
+
+void SketchApp::performUndo(void) {
+    UndoHistory::Rect dirty;
+    if (!_history.undo(&dirty)) return;
+    _dirty.add(dirty.x, dirty.y, dirty.w, dirty.h);
+    _ink.add(dirty.x, dirty.y, dirty.w, dirty.h);
+    flushDirty();
+}
+
+// Only the inked area differs from a blank canvas
+void SketchApp::clearCanvas(void) {
+    _history.beginStep();
+    for (int i = 0; i < _ink.count(); i++) {
+        const DirtyRegion::Rect& r = _ink[i];
+        _history.touch(r.x, r.y, r.w, r.h);
+        _canvas.fillRect(r.x, r.y, r.w, r.h, TFT_WHITE);
+        _dirty.add(r.x, r.y, r.w, r.h);
+    }
+    _ink.clear();
+    flushDirty();
+}
+
+int SketchApp::brushSize(void) const {
+    return _eraser ? ERASER_SIZES[_size_index] : BRUSH_SIZES[_size_index];
+}
+
+void SketchApp::drawCursorAt(int x, int y) {
+    _present.finish();
+    _cursor.moveTo(x, y, { brushSize(), _eraser, _color });
+}
+
+// Posts the brush state only when it differs from what the host last saw
+void SketchApp::streamBrush(uint32_t now) {
+    if (!_streamer) return;
+
+    int radius = brushSize();
+    uint8_t flags = (_eraser ? stroke_stream::FLAG_ERASER : 0) | (_light_mode ? stroke_stream::FLAG_LIGHT : 0);
+    uint16_t color = _eraser ? TFT_WHITE : _color;
+    if (radius == _sent_radius && flags == _sent_flags && color == _sent_color) return;
+
+    _sent_radius = radius;
+    _sent_flags = flags;
+    _sent_color = color;
+    _streamer->brush(radius, flags, color, now);
+}
+
+/* Render loop */
+
+void SketchApp::frame(const InputState& in) {
+    // Keep a present left in flight by the last frame moving
+    _present.poll();
+
+    // Newest filtered sample; older ones in the ring are superseded
+    if (in.has_joy) {
+        _raw_x = in.joy_x;
+        _raw_y = in.joy_y;
+    }
+    int64_t now = in.now_ms;
+
+    _btn_draw.update(in.btn_draw, now);
+    ButtonEvent ev_color = _btn_color.update(in.btn_color, now);
+    ButtonEvent ev_undo  = _btn_undo.update(in.btn_undo, now);
+    ButtonEvent ev_tool  = _btn_tool.update(in.btn_tool, now);
+
+    /* Colour Button */
+    if (ev_color == ButtonEvent::Click) {
+        _light_mode = !_light_mode;
+        printf("Palette: %s\n", _light_mode ? "LIGHT" : "DARK");
+        drawCursorAt(_prev_x, _prev_y);
+    } else if (ev_color == ButtonEvent::LongPress) {
+        // LONG HOLD -> Enter Color Wheel; first frame always renders
+        _in_wheel = true;
+        _wheel_sel = { -1, -1 };
+        if (_eraser) _eraser = false;
+    } else if (ev_color == ButtonEvent::LongRelease) {
+        _in_wheel = false;
+        _dirty.add(WHEEL_X, WHEEL_Y, WheelOverlay::SIZE, WheelOverlay::SIZE);
+        flushDirty();
+        drawCursorAt(_prev_x, _prev_y);
+    }
+
+    if (_in_wheel) {
+        // Only a bucket change costs any drawing
+        WheelBucket sel = wheel_bucket(_raw_x - _center_x, _raw_y - _center_y);
+        if (sel != _wheel_sel) {
+            _wheel_sel = sel;
+            _color = wheel_color(sel, _light_mode);
+            _present.finish();
+            _wheel.render(WHEEL_X, WHEEL_Y, sel, _light_mode);
+            _presenter.invalidate(WHEEL_X, WHEEL_Y, WheelOverlay::SIZE, WheelOverlay::SIZE);
+            drawCursorAt(_prev_x, _prev_y);
+        }
+    }
+
+    /* Tool Button */
+    if (ev_tool == ButtonEvent::Click) {
+        _size_index++;
+        if (_size_index > 2) _size_index = 0;
+        drawCursorAt(_prev_x, _prev_y);
+    } else if (ev_tool == ButtonEvent::LongPress) {
+        _eraser = !_eraser;
+        drawCursorAt(_prev_x, _prev_y);
+    }
+
+    streamBrush(now);
+
+    /* Undo/Clear Button */
+    if (ev_undo == ButtonEvent::Click) {
+        performUndo();
+        if (_streamer) _streamer->undo(now);
+        drawCursorAt(_prev_x, _prev_y);
+    } else if (ev_undo == ButtonEvent::LongPress) {
+        clearCanvas();
+        if (_streamer) _streamer->clear(now);
+        drawCursorAt(_prev_x, _prev_y);
+    }
+
+    // The joystick steers the wheel while the colour button is held
+    if (_btn_color.held()) return;
+
+    /* Cursor Movement */
+    float val_x = (float)_raw_x - _center_x;
+    float val_y = (float)_raw_y - _center_y;
+
+    if (fabs(val_x) < DEADZONE) val_x = 0;
+    else val_x = val_x / DIVISOR;
+
+    if (fabs(val_y) < DEADZONE) val_y = 0;
+    else val_y = val_y / DIVISOR;
+
+    _cursor_x += val_x;
+    _cursor_y += val_y;
+
+    if (_cursor_x < 18) _cursor_x = 18;
+    if (_cursor_x > 461) _cursor_x = 461;
+    if (_cursor_y < 18) _cursor_y = 18;
+    if (_cursor_y > 301) _cursor_y = 301;
+
+    int curr_ix = (int)_cursor_x;
+    int curr_iy = (int)_cursor_y;
+
+    /* Drawing Logic */
+    bool moved = (curr_ix != _prev_x || curr_iy != _prev_y);
+    bool drawing = _btn_draw.held();
+
+    bool stamped = false;
+    if (drawing) {
+        uint16_t c = _eraser ? TFT_WHITE : _color;
+        if (!_was_drawing) {
+            _history.beginStep();
+            _stroke.begin(curr_ix, curr_iy, brushSize(), c);
+            stamped = true;
+            if (_streamer) {
+                _streamer->move(curr_ix, curr_iy, now);
+                _streamer->penDown(now);
+            }
+        } else {
+            stamped = _stroke.extendTo(curr_ix, curr_iy, brushSize(), c);
+        }
+    } else if (_was_drawing) {
+        _stroke.end();
+        if (_streamer) _streamer->penUp(now);
+    }
+    _was_drawing = drawing;
+
+    // At rest the canvas is unchanged, so neither stroke nor cursor is redrawn
+    if (moved || stamped) {
+        drawCursorAt(curr_ix, curr_iy);
+        if (_streamer) _streamer->move(curr_ix, curr_iy, now);
+        _prev_x = curr_ix;
+        _prev_y = curr_iy;
+    } else if (_streamer) {
+        _streamer->idle(now);
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdint.h>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include "undo_history.hpp"
+#include "dirty_region.hpp"
+#include "stroke_rasterizer.hpp"
+#include "buttons.hpp"
+#include "color_wheel.hpp"
+#include "cursor_overlay.hpp"
+#include "stroke_streamer.hpp"
+#include "diff_presenter.hpp"
+#include "canvas_store.hpp"
+
+/* Sketch application
+ *
+ * Everything the render loop does between reading the inputs and waiting
+ * for the next tick. The board feeds it the joystick task, the buttons and
+ * the ILI9486; host builds feed it scripted inputs and a headless sprite.
+ */
+
+// One frame's worth of input, already sampled.
+struct InputState {
+    int64_t now_ms;
+    int joy_x;        // filtered raw ADC counts
+    int joy_y;
+    bool has_joy;     // false when no new sample arrived this frame
+    bool btn_draw;    // true while pressed
+    bool btn_color;
+    bool btn_undo;
+    bool btn_tool;
+};
+
+class IInputSource {
+public:
+    virtual ~IInputSource(void) = default;
+    virtual void read(InputState& in) = 0;
+};
+
+class SketchApp {
+public:
+    static constexpr int WIDTH = 480;
+    static constexpr int HEIGHT = 320;
+
+    explicit SketchApp(LovyanGFX* display);
+
+    // Allocates the canvas and overlays and shows the blank canvas.
+    // `center_x`/`center_y` are the calibrated joystick rest position.
+    bool init(int center_x, int center_y);
+
+    // Optional; events are posted while a streamer is attached.
+    void setStreamer(StrokeStreamer* streamer) { _streamer = streamer; }
+
+    // Optional; init() restores the last saved sketch from it.
+    void setStore(CanvasStore* store) { _store = store; }
+
+    // Runs one iteration of the render loop.
+    void frame(const InputState& in);
+
+    LGFX_Sprite& canvas(void) { return _canvas; }
+
+private:
+    void flushDirty(void);
+    void performUndo(void);
+    void clearCanvas(void);
+    int brushSize(void) const;
+    void drawCursorAt(int x, int y);
+    void streamBrush(uint32_t now);
+
+    LovyanGFX* _display;
+    LGFX_Sprite _canvas;
+    lgfx::AsyncPush _present;  // canvas push in flight; finish() before drawing to _display
+    DiffPresenter _presenter;
+    CursorOverlay _cursor;
+    WheelOverlay _wheel;
+    DirtyRegion _dirty;
+    DirtyRegion _ink;   // everything drawn since the last clear
+    UndoHistory _history;
+    StrokeRasterizer _stroke;
+    StrokeStreamer* _streamer = nullptr;
+    CanvasStore* _store = nullptr;
+
+    /* Input state */
+    Button _btn_draw;
+    Button _btn_color;
+    Button _btn_undo;
+    Button _btn_tool;
+    int _center_x = 2048;
+    int _center_y = 2048;
+    int _raw_x = 2048;
+    int _raw_y = 2048;
+
+    /* Graphics state */
+    int _size_index = 1;
+    bool _eraser = false;
+    uint16_t _color = TFT_BLACK;
+    bool _light_mode = false;
+    bool _in_wheel = false;
+    WheelBucket _wheel_sel = { 0, -1 };
+    bool _was_drawing = false;
+    float _cursor_x = WIDTH / 2;
+    float _cursor_y = HEIGHT / 2;
+    int _prev_x = WIDTH / 2;
+    int _prev_y = HEIGHT / 2;
+
+    /* Last brush state posted to the streamer */
+    int _sent_radius = -1;
+    uint8_t _sent_flags = 0;
+    uint16_t _sent_color = 0;
+};
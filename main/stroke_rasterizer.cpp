@@ -0,0 +1,32 @@
+#include "stroke_rasterizer.hpp"
+
+void StrokeRasterizer::segment(int x0, int y0, int x1, int y1, int radius, uint16_t color) {
+    int left = (x0 < x1 ? x0 : x1) - radius;
+    int top  = (y0 < y1 ? y0 : y1) - radius;
+    int w = (x0 < x1 ? x1 - x0 : x0 - x1) + radius * 2 + 1;
+    int h = (y0 < y1 ? y1 - y0 : y0 - y1) + radius * 2 + 1;
+
+    _history->touch(left, top, w, h);
+    _ink->add(left, top, w, h);
+    _canvas->drawWideLine(x0, y0, x1, y1, (float)radius, color);
+}
+
+void StrokeRasterizer::begin(int x, int y, int radius, uint16_t color) {
+    _active = true;
+    _last_x = x;
+    _last_y = y;
+    segment(x, y, x, y, radius, color);
+}
+
+bool StrokeRasterizer::extendTo(int x, int y, int radius, uint16_t color) {
+    if (!_active) {
+        begin(x, y, radius, color);
+        return true;
+    }
+    if (x == _last_x && y == _last_y) return false;
+
+    segment(_last_x, _last_y, x, y, radius, color);
+    _last_x = x;
+    _last_y = y;
+    return true;
+}
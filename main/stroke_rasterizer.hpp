@@ -0,0 +1,42 @@
+#pragma once
+
+#include <stdint.h>
+
+#define LGFX_USE_V1
+#include <LovyanGFX.hpp>
+
+#include "undo_history.hpp"
+#include "dirty_region.hpp"
+
+/* Continuous stroke rasterizer
+ *
+ * Joins consecutive cursor positions with one anti-aliased capsule
+ * (drawWideLine) so fast motion leaves no gaps between stamps. Positions
+ * that did not change since the last call draw nothing. Every touched
+ * area is saved to the undo history first and recorded as ink.
+ */
+class StrokeRasterizer {
+public:
+    StrokeRasterizer(LGFX_Sprite* canvas, UndoHistory* history, DirtyRegion* ink)
+    : _canvas(canvas), _history(history), _ink(ink) {}
+
+    // Starts a stroke with a single disc at (x, y).
+    void begin(int x, int y, int radius, uint16_t color);
+
+    // Draws the capsule from the previous point to (x, y).
+    // Returns false when the point did not move and nothing was drawn.
+    bool extendTo(int x, int y, int radius, uint16_t color);
+
+    void end(void) { _active = false; }
+    bool active(void) const { return _active; }
+
+private:
+    void segment(int x0, int y0, int x1, int y1, int radius, uint16_t color);
+
+    LGFX_Sprite* _canvas;
+    UndoHistory* _history;
+    DirtyRegion* _ink;
+    int _last_x = 0;
+    int _last_y = 0;
+    bool _active = false;
+};
@@ -0,0 +1,151 @@
+#include "stroke_stream.hpp"
+
+#include <string.h>
+
+namespace stroke_stream {
+
+static inline uint32_t zigzag(int32_t v) { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static inline int32_t unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+static size_t put_varint(uint8_t* dst, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        dst[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    dst[n++] = (uint8_t)v;
+    return n;
+}
+
+static bool get_varint(const uint8_t* buf, size_t len, size_t* pos, uint32_t* out) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*pos >= len) return false;
+        uint8_t b = buf[(*pos)++];
+        v |= (uint32_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+void State::apply(const Event& ev) {
+    time_ms = ev.time_ms;
+    switch (ev.type) {
+        case EV_MOVE:     x = ev.x; y = ev.y; break;
+        case EV_PEN_DOWN: flags |= FLAG_PEN_DOWN; break;
+        case EV_PEN_UP:   flags &= ~FLAG_PEN_DOWN; break;
+        case EV_BRUSH:
+            radius = ev.radius;
+            color = ev.color;
+            flags = (flags & FLAG_PEN_DOWN) | (ev.flags & ~FLAG_PEN_DOWN);
+            break;
+        default: break;
+    }
+}
+
+void PacketWriter::begin(uint16_t seq, const State& state) {
+    _state = state;
+    _events = 0;
+    _len = 0;
+    _buf[_len++] = MAGIC0;
+    _buf[_len++] = MAGIC1;
+    _buf[_len++] = VERSION;
+    _len += put_varint(&_buf[_len], seq);
+    _len += put_varint(&_buf[_len], state.time_ms);
+    _len += put_varint(&_buf[_len], zigzag(state.x));
+    _len += put_varint(&_buf[_len], zigzag(state.y));
+    _len += put_varint(&_buf[_len], state.radius);
+    _buf[_len++] = state.flags;
+    _len += put_varint(&_buf[_len], state.color);
+}
+
+bool PacketWriter::append(const Event& ev) {
+    // Worst case: tag + 5-byte dt + two 3-byte varints + flags
+    uint8_t tmp[16];
+    size_t n = 0;
+    tmp[n++] = ev.type;
+    n += put_varint(&tmp[n], ev.time_ms - _state.time_ms);
+    switch (ev.type) {
+        case EV_MOVE:
+            n += put_varint(&tmp[n], zigzag(ev.x - _state.x));
+            n += put_varint(&tmp[n], zigzag(ev.y - _state.y));
+            break;
+        case EV_BRUSH:
+            n += put_varint(&tmp[n], ev.radius);
+            tmp[n++] = ev.flags;
+            n += put_varint(&tmp[n], ev.color);
+            break;
+        default: break;
+    }
+    if (_len + n > MAX_PACKET) return false;
+
+    memcpy(&_buf[_len], tmp, n);
+    _len += n;
+    _events++;
+    _state.apply(ev);
+    return true;
+}
+
+bool parse_packet(const uint8_t* buf, size_t len, uint16_t* seq, State* start,
+                  void (*on_event)(const Event& ev, const State& after, void* user), void* user) {
+    if (len < 3 || buf[0] != MAGIC0 || buf[1] != MAGIC1 || buf[2] != VERSION) return false;
+
+    size_t pos = 3;
+    uint32_t v[7];
+    for (int i = 0; i < 5; i++) {
+        if (!get_varint(buf, len, &pos, &v[i])) return false;
+    }
+    if (pos >= len) return false;
+    uint8_t flags = buf[pos++];
+    if (!get_varint(buf, len, &pos, &v[5])) return false;
+
+    State state;
+    state.time_ms = v[1];
+    state.x = unzigzag(v[2]);
+    state.y = unzigzag(v[3]);
+    state.radius = v[4];
+    state.flags = flags;
+    state.color = v[5];
+    if (seq) *seq = v[0];
+    if (start) *start = state;
+
+    while (pos < len) {
+        Event ev = {};
+        ev.type = buf[pos++];
+        uint32_t dt;
+        if (!get_varint(buf, len, &pos, &dt)) return false;
+        ev.time_ms = state.time_ms + dt;
+        ev.x = state.x;
+        ev.y = state.y;
+
+        switch (ev.type) {
+            case EV_MOVE:
+                if (!get_varint(buf, len, &pos, &v[0]) || !get_varint(buf, len, &pos, &v[1])) return false;
+                ev.x = state.x + unzigzag(v[0]);
+                ev.y = state.y + unzigzag(v[1]);
+                break;
+            case EV_BRUSH:
+                if (!get_varint(buf, len, &pos, &v[0]) || pos >= len) return false;
+                ev.radius = v[0];
+                ev.flags = buf[pos++];
+                if (!get_varint(buf, len, &pos, &v[1])) return false;
+                ev.color = v[1];
+                break;
+            case EV_PEN_DOWN:
+            case EV_PEN_UP:
+            case EV_UNDO:
+            case EV_CLEAR:
+                break;
+            default:
+                return false;
+        }
+        state.apply(ev);
+        if (on_event) on_event(ev, state, user);
+    }
+    return true;
+}
+
+}  // namespace stroke_stream
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Stroke stream wire format
+ *
+ * Packets are self-contained so a lost datagram never corrupts the next one:
+ *
+ *   'T' 'S' version  seq  t0_ms  x0  y0  radius  flags  color   (header)
+ *   tag dt_ms [payload] ...                                     (events)
+ *
+ * Every integer after the version byte is a LEB128 varint. The header
+ * carries the full pen/brush state at the start of the packet. Event times
+ * are deltas from the previous event and MOVE positions are zigzag deltas
+ * from the previous position, so a typical move costs 3-4 bytes.
+ */
+namespace stroke_stream {
+
+static constexpr uint8_t MAGIC0  = 'T';
+static constexpr uint8_t MAGIC1  = 'S';
+static constexpr uint8_t VERSION = 1;
+static constexpr size_t  MAX_PACKET = 512;
+
+enum EventType : uint8_t {
+    EV_MOVE = 1,   // payload: zigzag dx, zigzag dy
+    EV_PEN_DOWN,
+    EV_PEN_UP,
+    EV_BRUSH,      // payload: radius, flags, color
+    EV_UNDO,
+    EV_CLEAR,
+};
+
+enum StateFlags : uint8_t {
+    FLAG_PEN_DOWN = 1 << 0,
+    FLAG_ERASER   = 1 << 1,
+    FLAG_LIGHT    = 1 << 2,
+};
+
+struct Event {
+    uint8_t type;
+    uint32_t time_ms;
+    int16_t x, y;       // EV_MOVE
+    uint8_t radius;     // EV_BRUSH
+    uint8_t flags;      // EV_BRUSH, FLAG_PEN_DOWN is ignored
+    uint16_t color;     // EV_BRUSH, RGB565
+};
+
+// Pen and brush state as known by both ends after every event.
+struct State {
+    uint32_t time_ms = 0;
+    int16_t x = 0, y = 0;
+    uint8_t radius = 0;
+    uint8_t flags = 0;
+    uint16_t color = 0;
+
+    void apply(const Event& ev);
+};
+
+class PacketWriter {
+public:
+    // Starts a packet whose header snapshots `state`.
+    void begin(uint16_t seq, const State& state);
+
+    // Appends an event. Returns false, leaving the packet untouched, when it does not fit.
+    bool append(const Event& ev);
+
+    const uint8_t* data(void) const { return _buf; }
+    size_t size(void) const { return _len; }
+    size_t eventCount(void) const { return _events; }
+    const State& state(void) const { return _state; }
+
+private:
+    uint8_t _buf[MAX_PACKET];
+    size_t _len = 0;
+    size_t _events = 0;
+    State _state;
+};
+
+// Decodes one packet. `on_event` sees each event with the state after it.
+// Returns false on a malformed packet; events before the error were delivered.
+bool parse_packet(const uint8_t* buf, size_t len, uint16_t* seq, State* start,
+                  void (*on_event)(const Event& ev, const State& after, void* user), void* user);
+
+}  // namespace stroke_stream
@@ -0,0 +1,190 @@
+#include "stroke_streamer.hpp"
+
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_timer.h"
+#include "mqtt_client.h"
+#include "lwip/sockets.h"
+#include "lwip/netdb.h"
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netdb.h>
+#include <unistd.h>
+#endif
+
+using namespace stroke_stream;
+
+/* UDP transport */
+static_assert(sizeof(sockaddr_in) <= 16, "UdpTransport::_addr too small");
+
+bool UdpTransport::open(const char* host, uint16_t port) {
+    close();
+
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* res = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &res) != 0 || res == nullptr) return false;
+
+    sockaddr_in addr = *(const sockaddr_in*)res->ai_addr;
+    addr.sin_port = htons(port);
+    freeaddrinfo(res);
+    memcpy(_addr, &addr, sizeof(addr));
+
+    _sock = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    return _sock >= 0;
+}
+
+void UdpTransport::close(void) {
+    if (_sock < 0) return;
+    ::close(_sock);
+    _sock = -1;
+}
+
+bool UdpTransport::send(const uint8_t* data, size_t len) {
+    if (_sock < 0) return false;
+    // Never block the stream task on a congested link; the packet is dropped instead
+    return sendto(_sock, data, len, MSG_DONTWAIT, (const sockaddr*)_addr, sizeof(sockaddr_in)) == (ssize_t)len;
+}
+
+#if defined(ESP_PLATFORM)
+/* MQTT transport */
+bool MqttTransport::open(const char* uri, const char* topic) {
+    close();
+    esp_mqtt_client_config_t cfg = {};
+    cfg.broker.address.uri = uri;
+    esp_mqtt_client_handle_t client = esp_mqtt_client_init(&cfg);
+    if (client == nullptr) return false;
+    if (esp_mqtt_client_start(client) != ESP_OK) {
+        esp_mqtt_client_destroy(client);
+        return false;
+    }
+    _client = client;
+    _topic = topic;
+    return true;
+}
+
+void MqttTransport::close(void) {
+    if (_client == nullptr) return;
+    esp_mqtt_client_stop((esp_mqtt_client_handle_t)_client);
+    esp_mqtt_client_destroy((esp_mqtt_client_handle_t)_client);
+    _client = nullptr;
+}
+
+bool MqttTransport::send(const uint8_t* data, size_t len) {
+    if (_client == nullptr) return false;
+    return esp_mqtt_client_publish((esp_mqtt_client_handle_t)_client, _topic, (const char*)data, len, 0, 0) >= 0;
+}
+
+static void stream_task(void* arg) {
+    StrokeStreamer* streamer = (StrokeStreamer*)arg;
+    for (;;) {
+        streamer->process((uint32_t)(esp_timer_get_time() / 1000));
+        vTaskDelay(pdMS_TO_TICKS(5));
+    }
+}
+
+bool StrokeStreamer::startTask(int priority, int core) {
+    return xTaskCreatePinnedToCore(stream_task, "stroke_stream", 4096, this, priority, nullptr, core) == pdPASS;
+}
+#else
+bool StrokeStreamer::startTask(int, int) { return false; }
+#endif
+
+/* Producer */
+bool StrokeStreamer::begin(IStreamTransport* transport, uint32_t interval_ms) {
+    _transport = transport;
+    _interval_ms = interval_ms;
+    return _transport != nullptr;
+}
+
+void StrokeStreamer::post(const Event& ev) {
+    _last_post_ms = ev.time_ms;
+    if (ev.type == EV_MOVE) {
+        bool room = _queue.size() < _queue.capacity() - MOVE_HEADROOM;
+        if (room && _has_pending_move) {
+            // The newer move supersedes the pending one
+            _has_pending_move = false;
+            _coalesced.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (room && _queue.push(ev)) return;
+        if (_has_pending_move) _coalesced.fetch_add(1, std::memory_order_relaxed);
+        _pending_move = ev;
+        _has_pending_move = true;
+        return;
+    }
+
+    // Pen and tool changes apply at the latest position, so it goes out first
+    if (_has_pending_move) {
+        if (!_queue.push(_pending_move)) {
+            _dropped_events.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        _has_pending_move = false;
+    }
+    if (!_queue.push(ev)) _dropped_events.fetch_add(1, std::memory_order_relaxed);
+}
+
+void StrokeStreamer::idle(uint32_t now_ms) {
+    if (!_has_pending_move || now_ms - _last_post_ms < _interval_ms) return;
+    if (_queue.size() >= _queue.capacity() - MOVE_HEADROOM || !_queue.push(_pending_move)) return;
+    _has_pending_move = false;
+}
+
+void StrokeStreamer::move(int x, int y, uint32_t time_ms) {
+    if (x == _last_x && y == _last_y) return;
+    _last_x = x;
+    _last_y = y;
+    post({ EV_MOVE, time_ms, (int16_t)x, (int16_t)y, 0, 0, 0 });
+}
+
+void StrokeStreamer::brush(int radius, uint8_t flags, uint16_t color, uint32_t time_ms) {
+    post({ EV_BRUSH, time_ms, 0, 0, (uint8_t)radius, flags, color });
+}
+
+/* Consumer */
+void StrokeStreamer::sendPacket(void) {
+    if (_transport->send(_packet.data(), _packet.size())) {
+        _packets.fetch_add(1, std::memory_order_relaxed);
+        _bytes.fetch_add(_packet.size(), std::memory_order_relaxed);
+    } else {
+        _dropped_packets.fetch_add(1, std::memory_order_relaxed);
+    }
+    _seq++;
+    _packet_open = false;
+}
+
+void StrokeStreamer::process(uint32_t now_ms) {
+    Event ev;
+    while (_queue.pop(ev)) {
+        if (!_packet_open) {
+            _packet.begin(_seq, _state);
+            _packet_start_ms = now_ms;
+            _packet_open = true;
+        }
+        if (!_packet.append(ev)) {
+            sendPacket();
+            _packet.begin(_seq, _state);
+            _packet_start_ms = now_ms;
+            _packet_open = true;
+            _packet.append(ev);
+        }
+        _state.apply(ev);
+    }
+
+    if (_packet_open && now_ms - _packet_start_ms >= _interval_ms) sendPacket();
+}
+
+StrokeStreamer::Stats StrokeStreamer::stats(void) const {
+    Stats s;
+    s.packets = _packets.load(std::memory_order_relaxed);
+    s.bytes = _bytes.load(std::memory_order_relaxed);
+    s.coalesced = _coalesced.load(std::memory_order_relaxed);
+    s.dropped_events = _dropped_events.load(std::memory_order_relaxed);
+    s.dropped_packets = _dropped_packets.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+#include "spsc_ring.hpp"
+#include "stroke_stream.hpp"
+
+/* Stroke streaming pipeline
+ *
+ * The render loop posts events into a bounded lock-free queue. A streaming
+ * task packs them into delta-encoded packets and sends one packet every
+ * `interval_ms`, or sooner when a packet fills up.
+ *
+ * Backpressure: moves may only fill the queue up to MOVE_HEADROOM slots short
+ * of capacity. Past that they are coalesced into a single pending move that
+ * replaces any older one, and is flushed ahead of the next event, or by idle()
+ * once `interval_ms` passes without one, so a pen at rest is not left a
+ * segment behind. Pen, brush,
+ * undo and clear events are never coalesced and may use the headroom; they are
+ * only dropped, and counted, if even that is exhausted. Packets the transport
+ * refuses are dropped too.
+ */
+
+class IStreamTransport {
+public:
+    virtual ~IStreamTransport(void) = default;
+    virtual bool send(const uint8_t* data, size_t len) = 0;
+};
+
+// Raw UDP datagrams. Uses BSD sockets, so it runs on lwIP and on Linux alike.
+class UdpTransport : public IStreamTransport {
+public:
+    ~UdpTransport(void) override { close(); }
+
+    bool open(const char* host, uint16_t port);
+    void close(void);
+    bool send(const uint8_t* data, size_t len) override;
+
+private:
+    int _sock = -1;
+    uint8_t _addr[16];  // sockaddr_in, kept opaque to avoid socket headers here
+};
+
+#if defined(ESP_PLATFORM)
+// Publishes each packet as one QoS 0 MQTT message.
+class MqttTransport : public IStreamTransport {
+public:
+    ~MqttTransport(void) override { close(); }
+
+    bool open(const char* uri, const char* topic);
+    void close(void);
+    bool send(const uint8_t* data, size_t len) override;
+
+private:
+    void* _client = nullptr;
+    const char* _topic = nullptr;
+};
+#endif
+
+class StrokeStreamer {
+public:
+    struct Stats {
+        uint32_t packets;
+        uint32_t bytes;
+        uint32_t coalesced;      // moves replaced by a newer move under backpressure
+        uint32_t dropped_events;
+        uint32_t dropped_packets;
+    };
+
+    bool begin(IStreamTransport* transport, uint32_t interval_ms = 15);
+
+    // Producer side, render loop only.
+    void move(int x, int y, uint32_t time_ms);
+    void penDown(uint32_t time_ms) { post({ stroke_stream::EV_PEN_DOWN, time_ms, 0, 0, 0, 0, 0 }); }
+    void penUp(uint32_t time_ms)   { post({ stroke_stream::EV_PEN_UP,   time_ms, 0, 0, 0, 0, 0 }); }
+    void brush(int radius, uint8_t flags, uint16_t color, uint32_t time_ms);
+    void undo(uint32_t time_ms)    { post({ stroke_stream::EV_UNDO,     time_ms, 0, 0, 0, 0, 0 }); }
+    void clear(uint32_t time_ms)   { post({ stroke_stream::EV_CLEAR,    time_ms, 0, 0, 0, 0, 0 }); }
+    // Call every frame: queues a coalesced move that has waited `interval_ms`
+    // with nothing posted after it, once the queue has room for a move.
+    void idle(uint32_t now_ms);
+
+    // Consumer side: drains the queue into the open packet and sends it once
+    // `interval_ms` has passed since it was started. Body of the stream task.
+    void process(uint32_t now_ms);
+
+    // Runs process() every few milliseconds on a dedicated FreeRTOS task.
+    bool startTask(int priority, int core);
+
+    Stats stats(void) const;
+
+private:
+    static constexpr size_t QUEUE_SIZE = 128;
+    static constexpr size_t MOVE_HEADROOM = 16;  // slots only non-move events may use
+
+    void post(const stroke_stream::Event& ev);
+    void sendPacket(void);
+
+    IStreamTransport* _transport = nullptr;
+    uint32_t _interval_ms = 15;
+
+    SpscRing<stroke_stream::Event, QUEUE_SIZE> _queue;
+    stroke_stream::Event _pending_move;   // producer-owned
+    bool _has_pending_move = false;
+    uint32_t _last_post_ms = 0;
+    int _last_x = -1;
+    int _last_y = -1;
+
+    stroke_stream::PacketWriter _packet;  // consumer-owned
+    stroke_stream::State _state;
+    uint16_t _seq = 0;
+    uint32_t _packet_start_ms = 0;
+    bool _packet_open = false;
+
+    std::atomic<uint32_t> _packets{0};
+    std::atomic<uint32_t> _bytes{0};
+    std::atomic<uint32_t> _coalesced{0};
+    std::atomic<uint32_t> _dropped_events{0};
+    std::atomic<uint32_t> _dropped_packets{0};
+};
@@ -0,0 +1,148 @@
+#include "undo_history.hpp"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include "esp_heap_caps.h"
+static void* alloc_psram(size_t len) { return heap_caps_malloc(len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT); }
+static void free_psram(void* p) { heap_caps_free(p); }
+#else
+static void* alloc_psram(size_t len) { return malloc(len); }
+static void free_psram(void* p) { free(p); }
+#endif
+
+bool UndoHistory::init(uint16_t* buffer, int width, int height, size_t slot_count, size_t max_steps) {
+    release();
+    _canvas = buffer;
+    _width = width;
+    _height = height;
+    _tiles_x = (width + TILE - 1) / TILE;
+    _tiles_y = (height + TILE - 1) / TILE;
+
+    size_t tiles = (size_t)_tiles_x * _tiles_y;
+    if (buffer == nullptr || slot_count < tiles || max_steps == 0) return false;
+
+    _pixels    = (uint16_t*)alloc_psram(slot_count * TILE * TILE * sizeof(uint16_t));
+    _slot_tile = (uint16_t*)alloc_psram(slot_count * sizeof(uint16_t));
+    _steps     = (Step*)malloc(max_steps * sizeof(Step));
+    _saved     = (uint8_t*)calloc(tiles, 1);
+    if (!_pixels || !_slot_tile || !_steps || !_saved) {
+        release();
+        return false;
+    }
+    _slot_capacity = slot_count;
+    _step_capacity = max_steps;
+    return true;
+}
+
+void UndoHistory::release(void) {
+    if (_pixels)    free_psram(_pixels);
+    if (_slot_tile) free_psram(_slot_tile);
+    free(_steps);
+    free(_saved);
+    _pixels = nullptr;
+    _slot_tile = nullptr;
+    _steps = nullptr;
+    _saved = nullptr;
+    _slot_capacity = 0;
+    _slot_head = _slot_tail = 0;
+    _step_capacity = _step_first = _step_count = 0;
+    _step_open = false;
+}
+
+void UndoHistory::dropOldestStep(void) {
+    if (_step_count == 0) return;
+    const Step& s = _steps[_step_first];
+    _slot_tail = s.first_slot + s.slot_count;
+    _step_first = (_step_first + 1) % _step_capacity;
+    _step_count--;
+}
+
+void UndoHistory::beginStep(void) {
+    if (_steps == nullptr) return;
+    memset(_saved, 0, (size_t)_tiles_x * _tiles_y);
+
+    // An open step that never saved anything is reused rather than stacked.
+    if (_step_open && _step_count && _steps[(_step_first + _step_count - 1) % _step_capacity].slot_count == 0) return;
+
+    if (_step_count == _step_capacity) dropOldestStep();
+    _steps[(_step_first + _step_count) % _step_capacity] = { _slot_head, 0 };
+    _step_count++;
+    _step_open = true;
+}
+
+void UndoHistory::touch(int x, int y, int w, int h) {
+    if (!_step_open) return;
+
+    int x0 = x < 0 ? 0 : x;
+    int y0 = y < 0 ? 0 : y;
+    int x1 = x + w > _width  ? _width  : x + w;
+    int y1 = y + h > _height ? _height : y + h;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    Step* step = &_steps[(_step_first + _step_count - 1) % _step_capacity];
+
+    for (int ty = y0 / TILE; ty <= (y1 - 1) / TILE; ty++) {
+        for (int tx = x0 / TILE; tx <= (x1 - 1) / TILE; tx++) {
+            int tile = ty * _tiles_x + tx;
+            if (_saved[tile]) continue;
+            _saved[tile] = 1;
+
+            // The open step never exceeds one canvas worth of tiles, so an older step is always available to evict.
+            while (_slot_head - _slot_tail >= _slot_capacity && _step_count > 1) dropOldestStep();
+
+            uint32_t seq = _slot_head++;
+            _slot_tile[seq % _slot_capacity] = tile;
+            step->slot_count++;
+
+            uint16_t* dst = slotPixels(seq);
+            int px = tx * TILE;
+            int py = ty * TILE;
+            int cw = (px + TILE > _width  ? _width  : px + TILE) - px;
+            int ch = (py + TILE > _height ? _height : py + TILE) - py;
+            for (int row = 0; row < ch; row++) {
+                memcpy(&dst[row * TILE], &_canvas[(py + row) * _width + px], cw * sizeof(uint16_t));
+            }
+        }
+    }
+}
+
+bool UndoHistory::undo(Rect* dirty) {
+    // Steps that saved nothing would restore nothing; undo the one before them
+    while (_step_count && _steps[(_step_first + _step_count - 1) % _step_capacity].slot_count == 0) {
+        _step_count--;
+        _step_open = false;
+    }
+    if (_step_count == 0) return false;
+
+    const Step& step = _steps[(_step_first + _step_count - 1) % _step_capacity];
+    int x0 = _width, y0 = _height, x1 = 0, y1 = 0;
+
+    for (uint32_t i = 0; i < step.slot_count; i++) {
+        uint32_t seq = step.first_slot + i;
+        int tile = _slot_tile[seq % _slot_capacity];
+        const uint16_t* src = slotPixels(seq);
+        int px = (tile % _tiles_x) * TILE;
+        int py = (tile / _tiles_x) * TILE;
+        int cw = (px + TILE > _width  ? _width  : px + TILE) - px;
+        int ch = (py + TILE > _height ? _height : py + TILE) - py;
+        for (int row = 0; row < ch; row++) {
+            memcpy(&_canvas[(py + row) * _width + px], &src[row * TILE], cw * sizeof(uint16_t));
+        }
+        if (px < x0) x0 = px;
+        if (py < y0) y0 = py;
+        if (px + cw > x1) x1 = px + cw;
+        if (py + ch > y1) y1 = py + ch;
+    }
+
+    _slot_head = step.first_slot;
+    _step_count--;
+    _step_open = false;
+
+    if (dirty) {
+        if (x0 < x1) *dirty = { x0, y0, x1 - x0, y1 - y0 };
+        else         *dirty = { 0, 0, 0, 0 };
+    }
+    return true;
+}
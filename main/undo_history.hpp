@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Tile-delta undo history
+ *
+ * The canvas is split into TILE x TILE blocks. Before a block is modified for
+ * the first time within a step, its pre-image is copied into a ring-buffer
+ * arena. Undo writes the saved blocks of the newest step back.
+ * When the arena or the step list runs out, the oldest steps are dropped.
+ */
+class UndoHistory {
+public:
+    static constexpr int TILE = 16;
+
+    struct Rect {
+        int x, y, w, h;
+    };
+
+    ~UndoHistory(void) { release(); }
+
+    // `buffer` is the 16bpp canvas, `slot_count` the arena size in tiles.
+    // The arena must hold at least one full canvas so a clear stays undoable.
+    bool init(uint16_t* buffer, int width, int height, size_t slot_count, size_t max_steps);
+    void release(void);
+
+    // Opens a new undo step. Tiles touched afterwards belong to it.
+    void beginStep(void);
+
+    // Saves the pre-image of every tile overlapping the rectangle, once per step.
+    // Must be called before the pixels are modified.
+    void touch(int x, int y, int w, int h);
+
+    // Restores the newest step that saved any tiles, dropping the empty ones
+    // after it. Returns false when there is nothing to undo, otherwise `dirty`
+    // receives the bounding box of the restored tiles.
+    bool undo(Rect* dirty);
+
+    size_t depth(void) const { return _step_count; }
+    size_t usedBytes(void) const { return (size_t)(_slot_head - _slot_tail) * TILE * TILE * sizeof(uint16_t); }
+
+private:
+    struct Step {
+        uint32_t first_slot;  // sequence number of the first saved tile
+        uint32_t slot_count;
+    };
+
+    void dropOldestStep(void);
+    uint16_t* slotPixels(uint32_t seq) const { return &_pixels[(size_t)(seq % _slot_capacity) * TILE * TILE]; }
+
+    uint16_t* _canvas = nullptr;
+    int _width = 0;
+    int _height = 0;
+    int _tiles_x = 0;
+    int _tiles_y = 0;
+
+    uint16_t* _pixels = nullptr;     // arena: _slot_capacity tiles of TILE*TILE pixels
+    uint16_t* _slot_tile = nullptr;  // tile index stored in each arena slot
+    uint32_t _slot_capacity = 0;
+    uint32_t _slot_head = 0;         // next sequence number to write
+    uint32_t _slot_tail = 0;         // oldest live sequence number
+
+    Step* _steps = nullptr;          // ring of steps, newest at (_step_first + _step_count - 1)
+    size_t _step_capacity = 0;
+    size_t _step_first = 0;
+    size_t _step_count = 0;
+
+    uint8_t* _saved = nullptr;       // per-tile flag: already saved in the open step
+    bool _step_open = false;         // newest step still accepts tiles
+};
@@ -0,0 +1,57 @@
+#include "wifi_sta.hpp"
+
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_wifi.h"
+#include "nvs_flash.h"
+
+static const EventBits_t CONNECTED_BIT = BIT0;
+static EventGroupHandle_t s_wifi_events = nullptr;
+
+static void on_wifi_event(void*, esp_event_base_t base, int32_t id, void*) {
+    if (base == WIFI_EVENT && id == WIFI_EVENT_STA_START) {
+        esp_wifi_connect();
+    } else if (base == WIFI_EVENT && id == WIFI_EVENT_STA_DISCONNECTED) {
+        xEventGroupClearBits(s_wifi_events, CONNECTED_BIT);
+        esp_wifi_connect();
+    } else if (base == IP_EVENT && id == IP_EVENT_STA_GOT_IP) {
+        xEventGroupSetBits(s_wifi_events, CONNECTED_BIT);
+    }
+}
+
+bool wifi_sta_start(const char* ssid, const char* password) {
+    esp_err_t err = nvs_flash_init();
+    if (err == ESP_ERR_NVS_NO_FREE_PAGES || err == ESP_ERR_NVS_NEW_VERSION_FOUND) {
+        nvs_flash_erase();
+        err = nvs_flash_init();
+    }
+    if (err != ESP_OK) return false;
+
+    s_wifi_events = xEventGroupCreate();
+    if (esp_netif_init() != ESP_OK) return false;
+    if (esp_event_loop_create_default() != ESP_OK) return false;
+    esp_netif_create_default_wifi_sta();
+
+    wifi_init_config_t init_cfg = WIFI_INIT_CONFIG_DEFAULT();
+    if (esp_wifi_init(&init_cfg) != ESP_OK) return false;
+
+    esp_event_handler_instance_register(WIFI_EVENT, ESP_EVENT_ANY_ID, on_wifi_event, nullptr, nullptr);
+    esp_event_handler_instance_register(IP_EVENT, IP_EVENT_STA_GOT_IP, on_wifi_event, nullptr, nullptr);
+
+    wifi_config_t cfg = {};
+    strncpy((char*)cfg.sta.ssid, ssid, sizeof(cfg.sta.ssid));
+    strncpy((char*)cfg.sta.password, password, sizeof(cfg.sta.password));
+
+    esp_wifi_set_mode(WIFI_MODE_STA);
+    esp_wifi_set_config(WIFI_IF_STA, &cfg);
+    // Power save adds up to a DTIM interval of latency to every packet
+    esp_wifi_set_ps(WIFI_PS_NONE);
+    return esp_wifi_start() == ESP_OK;
+}
+
+bool wifi_sta_connected(void) {
+    return s_wifi_events != nullptr && (xEventGroupGetBits(s_wifi_events) & CONNECTED_BIT) != 0;
+}
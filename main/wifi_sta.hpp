@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Wi-Fi station bring-up
+ *
+ * Initialises NVS, netif and the default event loop, then connects to the
+ * given access point and keeps reconnecting whenever the link drops.
+ */
+
+// Starts the station. Returns false if the Wi-Fi driver failed to start.
+bool wifi_sta_start(const char* ssid, const char* password);
+
+// True while the station holds an IP address.
+bool wifi_sta_connected(void);